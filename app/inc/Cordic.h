@@ -0,0 +1,92 @@
+#ifndef CORDIC_H
+#define CORDIC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include <stdbool.h>
+
+enum Cordic_Errors {
+    CORDIC_SUCCESS = 0,
+    CORDIC_WRONG_DATA = -1,
+    CORDIC_HW_ERROR = -2,
+    CORDIC_BUSY = -3, // the service is owned by another task longer than CORDIC_TIMEOUT_MS
+};
+
+/*
+ * The functions, all values are q1.31 (the CORDIC native format):
+ * SIN_COS - angle / pi -> cos, sin (two results per argument);
+ * PHASE - x, y -> atan2(y, x) / pi;
+ * MODULUS - x, y -> sqrt(x^2 + y^2), it must be less than 1;
+ * SQRT - x * 2^-n -> sqrt(x) * 2^-n, n = 0: 0.027 <= x < 0.75, n = 1: 0.75 <= x < 1.75, n = 2: 1.75 <= x < 2.341;
+ * LN - x * 2^-n -> ln(x) * 2^-(n + 1), n = 1: 0.107 <= x < 1, n = 2: 1 <= x < 3, n = 3: 3 <= x < 7, n = 4: 7 <= x < 15.
+ */
+enum Cordic_Functions {
+    CORDIC_SIN_COS = 0,
+    CORDIC_PHASE,
+    CORDIC_MODULUS,
+    CORDIC_SQRT,
+    CORDIC_LN,
+    CORDIC_NUMBER_FUNCTIONS,
+};
+
+enum Cordic_Constants {
+    CORDIC_MAX_SQRT_SCALE = 2,
+    CORDIC_MIN_LN_SCALE = 1,
+    CORDIC_MAX_LN_SCALE = 4,
+    CORDIC_TIMEOUT_MS = 10,
+};
+
+typedef struct {
+    void *handle; // CORDIC_HandleTypeDef, NULL - the software engine (libm)
+
+    // the CORDIC is configured again only when the function or the scale is changed
+    bool isConfigured;
+    uint8_t function;
+    uint8_t scale;
+
+    // statistics: the time of the calculations (see cycles.h)
+    uint32_t operations;
+    uint32_t cycles; // total, the average: cycles / operations
+    uint32_t reconfigurations;
+    uint32_t errors;
+
+    SemaphoreHandle_t mutex; // the service is shared by the tasks
+    StaticSemaphore_t mutexBuffer;
+} CordicDef;
+
+int32_t CordicInit(CordicDef *cordic, void *handle);
+
+int32_t CordicCalculate(CordicDef *cordic, uint8_t function, uint8_t scale, const int32_t *src, int32_t *dst,
+                        size_t count);
+
+int32_t CordicSinCos(CordicDef *cordic, const int32_t *angles, int32_t *results, size_t count);
+
+int32_t CordicPhase(CordicDef *cordic, const int32_t *points, int32_t *phases, size_t count);
+
+int32_t CordicModulus(CordicDef *cordic, const int32_t *points, int32_t *moduli, size_t count);
+
+int32_t CordicSqrt(CordicDef *cordic, const int32_t *values, int32_t *roots, size_t count, uint8_t scale);
+
+int32_t CordicLn(CordicDef *cordic, const int32_t *values, int32_t *logs, size_t count, uint8_t scale);
+
+size_t CordicGetArguments(uint8_t function);
+
+size_t CordicGetResults(uint8_t function);
+
+void CordicSoftware(uint8_t function, uint8_t scale, const int32_t *src, int32_t *dst, size_t count);
+
+int32_t Cordic_configHardware(CordicDef *cordic);
+
+int32_t Cordic_calculateHardware(CordicDef *cordic, const int32_t *src, int32_t *dst, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CORDIC_H
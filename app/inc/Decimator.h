@@ -0,0 +1,72 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+enum Decimator_Errors {
+    DECIMATOR_SUCCESS = 0,
+    DECIMATOR_WRONG_DATA = -1,
+};
+
+enum Decimator_Constants {
+    DECIMATOR_MAX_CHANNELS = 4,
+    DECIMATOR_CIC_ORDER = 3, // the CIC gain is R^3, the register growth - 3 * log2(R) bits
+    DECIMATOR_MAX_CIC_SHIFT = 5, // R = 32
+    DECIMATOR_MAX_HALF_BANDS = 4,
+    DECIMATOR_HALF_BAND_TAPS = 7, // {-1, 0, 9, 16, 9, 0, -1} / 32
+    DECIMATOR_HALF_BAND_SHIFT = 5,
+
+    DECIMATOR_OUTPUT_BITS = 16, // the output full scale - 65535
+    DECIMATOR_GUARD_BITS = 4, // the fraction bits between the stages (rounded off at the output)
+};
+
+/*
+ * The stages of one channel: CIC (R = 1 << cicShift, 0 - bypass), then halfBands half-band FIR stages, each one
+ * decimates by 2. The output rate is the input rate / (1 << (cicShift + halfBands)).
+ */
+typedef struct {
+    uint8_t cicShift;
+    uint8_t halfBands;
+} DecimatorStagesDef;
+
+typedef struct {
+    // CIC: the modulo 2^32 arithmetic, the wrap-around of the integrators is cancelled by the combs
+    uint32_t integrators[DECIMATOR_CIC_ORDER];
+    uint32_t combs[DECIMATOR_CIC_ORDER];
+    uint32_t phase; // the input samples of the current CIC output
+
+    int32_t delays[DECIMATOR_MAX_HALF_BANDS][DECIMATOR_HALF_BAND_TAPS]; // [0] - the newest sample
+    uint8_t halfBandPhases; // bit i - the odd input of the half-band stage i
+
+    uint16_t output; // the last output (DECIMATOR_OUTPUT_BITS)
+    uint32_t outputs; // counter
+} DecimatorChannelDef;
+
+typedef struct {
+    uint8_t channels;
+    uint8_t inputBits; // the sample width: 12 - the ADC conversion, 14 - x4 hardware oversampling without shift
+    DecimatorStagesDef stages[DECIMATOR_MAX_CHANNELS];
+    DecimatorChannelDef state[DECIMATOR_MAX_CHANNELS];
+} DecimatorDef;
+
+int32_t DecimatorInit(DecimatorDef *dec, const DecimatorStagesDef *stages, size_t channels, uint8_t inputBits);
+
+void DecimatorProcess(DecimatorDef *dec, const uint16_t *samples, size_t scans);
+
+bool DecimatorPush(DecimatorDef *dec, size_t channel, uint16_t sample);
+
+uint16_t DecimatorGetOutput(const DecimatorDef *dec, size_t channel);
+
+uint32_t DecimatorGetOutputs(const DecimatorDef *dec, size_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DECIMATOR_H
@@ -0,0 +1,63 @@
+#ifndef DSP_H
+#define DSP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum Dsp_Errors {
+    DSP_SUCCESS = 0,
+    DSP_WRONG_DATA = -1,
+};
+
+enum Dsp_Constants {
+    DSP_MAX_SIZE = 32768, // samples per call, the sum of q1.15 samples fits the 32-bit accumulator (SMLAD)
+    DSP_MAX_SHIFT = 15, // the gain 2^shift of DspScaleOffsetQ15
+};
+
+typedef struct {
+    int16_t min;
+    int16_t max;
+    int16_t mean; // the sum / size, truncated toward zero
+} DspStatsDef;
+
+/*
+ * The block kernels: q1.15 samples, two samples per instruction (SMLAD, SMLALD, QADD16, SSUB16/SEL, PKHBT) on the
+ * Cortex-M4. The packed operations are emulated in C by the host build, so the same kernels run in the simulation.
+ * The xxxReference functions are the portable scalar versions, the results of both paths are identical. The blocks
+ * can be unaligned and odd-sized.
+ */
+int32_t DspDotQ15(const int16_t *a, const int16_t *b, size_t size, int64_t *result);
+
+int32_t DspScaleOffsetQ15(const int16_t *src, int16_t *dst, size_t size, int16_t scale, uint8_t shift,
+                          int16_t offset);
+
+int32_t DspStatsQ15(const int16_t *src, size_t size, DspStatsDef *stats);
+
+int32_t DspRmsQ15(const int16_t *src, size_t size, int16_t *rms);
+
+int32_t DspQ15ToQ31(const int16_t *src, int32_t *dst, size_t size);
+
+int32_t DspQ31ToQ15(const int32_t *src, int16_t *dst, size_t size);
+
+int32_t DspDotQ15Reference(const int16_t *a, const int16_t *b, size_t size, int64_t *result);
+
+int32_t DspScaleOffsetQ15Reference(const int16_t *src, int16_t *dst, size_t size, int16_t scale, uint8_t shift,
+                                   int16_t offset);
+
+int32_t DspStatsQ15Reference(const int16_t *src, size_t size, DspStatsDef *stats);
+
+int32_t DspRmsQ15Reference(const int16_t *src, size_t size, int16_t *rms);
+
+int32_t DspQ15ToQ31Reference(const int16_t *src, int32_t *dst, size_t size);
+
+int32_t DspQ31ToQ15Reference(const int32_t *src, int16_t *dst, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DSP_H
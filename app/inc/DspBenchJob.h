@@ -0,0 +1,61 @@
+#ifndef DSPBENCHJOB_H
+#define DSPBENCHJOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "SerialJob.h"
+#include "Dsp.h"
+
+enum DspBench_Constants {
+    DSP_BENCH_BLOCK = 255, // samples per call, the odd size covers the tail of the packed loops
+    DSP_BENCH_REPEATS = 16, // calls per test and path
+    DSP_BENCH_PERIOD_MS = 5000, // the suite is repeated, so a host can connect at any time
+    DSP_BENCH_LINE_SIZE = 160,
+    DSP_BENCH_MAX_TESTS = 6,
+};
+
+typedef struct {
+    uint32_t simdCycles; // elapsed, the packed kernel
+    uint32_t referenceCycles; // elapsed, the portable kernel
+    uint32_t mismatches; // the calls, where the results of both kernels differ
+} DspBenchResultDef;
+
+// the results of one kernel call
+typedef struct {
+    int64_t dot;
+    DspStatsDef stats;
+    int16_t rms;
+    int16_t samples[DSP_BENCH_BLOCK];
+    int32_t wide[DSP_BENCH_BLOCK];
+} DspBenchOutputDef;
+
+typedef struct {
+    SerialPortDef *port; // output (JSON lines)
+    uint32_t run;
+    uint32_t seed;
+
+    int16_t a[DSP_BENCH_BLOCK];
+    int16_t b[DSP_BENCH_BLOCK];
+    int32_t wide[DSP_BENCH_BLOCK];
+    DspBenchOutputDef outputs[2]; // the packed and the portable kernel
+
+    // all tests are done before the output, so the serial port doesn't disturb the measurements
+    DspBenchResultDef tests[DSP_BENCH_MAX_TESTS];
+    char line[DSP_BENCH_LINE_SIZE];
+
+    StaticTask_t taskTCB;
+    StackType_t taskStack[configMINIMAL_STACK_SIZE * 2];
+} DspBenchDef;
+
+TaskHandle_t DspBenchJobInit(DspBenchDef *bench, SerialPortDef *port, uint8_t priorityLevel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DSPBENCHJOB_H
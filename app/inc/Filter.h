@@ -0,0 +1,117 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include <stdbool.h>
+
+enum Filter_Errors {
+    FILTER_SUCCESS = 0,
+    FILTER_WRONG_DATA = -1,
+    FILTER_HW_ERROR = -2, // the FMAC (HAL) refused the configuration or the block
+    FILTER_TIMEOUT = -3, // the filtered block isn't delivered in time
+};
+
+enum Filter_Constants {
+    FILTER_FIR = 0, // y[n] = sum(b[k] * x[n - k])
+    FILTER_BIQUAD, // y[n] = b0 * x[n] + b1 * x[n - 1] + b2 * x[n - 2] + a1 * y[n - 1] + a2 * y[n - 2]
+
+    FILTER_MAX_TAPS = 64, // FIR, the FMAC local memory: X1 - taps + margin, X2 - taps, Y - margin (256 words)
+    FILTER_BIQUAD_TAPS = 3,
+    FILTER_BIQUAD_FEEDBACK = 2,
+    FILTER_MAX_SHIFT = 7, // the output gain 2^shift (FMAC parameter R)
+    FILTER_MAX_BLOCK = 128, // samples per FilterProcess call (one ADC block)
+    FILTER_MAX_CONSUMERS = 4,
+    FILTER_TIMEOUT_MS = 10,
+
+    // the FMAC datapath (RM0440): q1.15 x q1.15 = q2.30 products, 8 LSBs are discarded, 26-bit q3.22 accumulator,
+    // the output is shifted by R, truncated to q1.15 and clipped
+    FILTER_PRODUCT_SHIFT = 8,
+    FILTER_ACCUMULATOR_BITS = 26,
+    FILTER_OUTPUT_SHIFT = 7,
+};
+
+/*
+ * The filter: q1.15 coefficients, b[0] is applied to the newest sample. The feedback coefficients are added
+ * (the FMAC convention): a1, a2 are the negated coefficients of the usual transfer function denominator.
+ * The coefficient tables are owned by the caller and must stay valid.
+ */
+typedef struct {
+    uint8_t type; // FILTER_FIR or FILTER_BIQUAD
+    uint8_t taps; // FIR: 2 ... FILTER_MAX_TAPS, BIQUAD: FILTER_BIQUAD_TAPS
+    uint8_t shift; // the output gain 2^shift, the coefficients are scaled down by it to fit q1.15
+    const int16_t *b;
+    const int16_t *a; // BIQUAD only: a1, a2
+} FilterConfigDef;
+
+/**
+ * @brief Consume the filtered block (the task context of FilterProcess caller)
+ * @param samples is the filtered block (q1.15)
+ * @param size is the number of samples
+ * @param arg is the consumer argument
+ */
+typedef void (*FilterFun_output)(const int16_t *samples, size_t size, void *arg);
+
+typedef struct {
+    FilterFun_output callback;
+    void *arg;
+} FilterConsumerDef;
+
+typedef struct {
+    FilterConfigDef config;
+    void *handle; // FMAC_HandleTypeDef, NULL - the software engine
+    bool isStarted; // the FMAC holds the filter state between the blocks
+
+    // the software engine state (the FMAC keeps it in its local memory)
+    int16_t inputs[FILTER_MAX_TAPS]; // [0] - the newest sample
+    int16_t outputs[FILTER_BIQUAD_FEEDBACK];
+
+    // the block buffers, the FMAC reads and writes them by DMA
+    int16_t input[FILTER_MAX_BLOCK];
+    int16_t output[FILTER_MAX_BLOCK];
+    uint16_t inputSize;
+    uint16_t outputSize;
+    volatile int32_t status; // Filter_Errors value of the last block
+
+    FilterConsumerDef consumers[FILTER_MAX_CONSUMERS];
+    uint8_t numConsumers;
+
+    // statistics: the CPU time of the block (the copy, the start and the delivery, see cycles.h)
+    uint32_t blocks;
+    uint32_t errors;
+    uint32_t cycles; // total, the average: cycles / blocks
+    uint32_t maxCycles;
+
+    SemaphoreHandle_t done;
+    StaticSemaphore_t doneBuffer;
+} FilterDef;
+
+int32_t FilterInit(FilterDef *filter, const FilterConfigDef *config, void *handle);
+
+int32_t FilterAddConsumer(FilterDef *filter, FilterFun_output callback, void *arg);
+
+int16_t *FilterGetInput(FilterDef *filter);
+
+int32_t FilterProcess(FilterDef *filter, size_t size);
+
+void FilterSoftware(FilterDef *filter, const int16_t *input, int16_t *output, size_t size);
+
+void FilterCompleteFromISR(FilterDef *filter, int32_t status, BaseType_t *priorityTaskWoken);
+
+int32_t Filter_configHardware(FilterDef *filter);
+
+int32_t Filter_startHardware(FilterDef *filter, size_t size);
+
+void Filter_stopHardware(FilterDef *filter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FILTER_H
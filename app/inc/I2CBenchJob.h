@@ -0,0 +1,58 @@
+#ifndef I2CBENCHJOB_H
+#define I2CBENCHJOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "SerialJob.h"
+#include "I2CBusJob.h"
+
+enum I2CBench_Constants {
+    I2C_BENCH_DEVICE_ADDRESS = 0x50, // 24xx512 EEPROM (the simulation has it on every bus)
+    I2C_BENCH_DEVICE_SIZE = 65536, // bytes, read completely by each test
+    I2C_BENCH_CHUNK_SIZE = 32, // the transfer size of the short transactions
+    I2C_BENCH_BLOCK_SIZE = 4096, // the reloaded transfer size (RAM)
+    I2C_BENCH_PERIOD_MS = 5000, // the suite is repeated, so a host can connect at any time
+    I2C_BENCH_TIMEOUT_MS = 1000, // per transaction
+    I2C_BENCH_LINE_SIZE = 192,
+    I2C_BENCH_MAX_TESTS = 4,
+
+    I2C_BENCH_NOTIF_FLAG = 1 << 0,
+};
+
+typedef struct {
+    uint32_t transactions; // completed
+    uint32_t errors;
+    uint32_t reloads; // NBYTES reloads
+    uint32_t cycles; // elapsed
+    uint32_t busBits; // SCL periods: 9 per byte (ACK included) + Start, repeated Start, Stop
+} I2CBenchResultDef;
+
+typedef struct {
+    SerialPortDef *port; // output (JSON lines)
+    I2CBusDef *bus;
+    uint32_t run;
+
+    I2CRequestDef request;
+    uint8_t pointer[2]; // the memory address (big-endian)
+    uint8_t buffer[I2C_BENCH_BLOCK_SIZE];
+
+    // all tests are done before the output, so the serial port doesn't disturb the measurements
+    I2CBenchResultDef results[I2C_BENCH_MAX_TESTS];
+    char line[I2C_BENCH_LINE_SIZE];
+
+    StaticTask_t taskTCB;
+    StackType_t taskStack[configMINIMAL_STACK_SIZE * 2];
+} I2CBenchDef;
+
+TaskHandle_t I2CBenchJobInit(I2CBenchDef *bench, SerialPortDef *port, I2CBusDef *bus, uint8_t priorityLevel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //I2CBENCHJOB_H
@@ -9,59 +9,163 @@ extern "C" {
 #include "task.h"
 #include "semphr.h"
 #include "queue.h"
-#include "event_groups.h"
 
 #include "i2c.h"
 
 enum I2CBus_Constants {
-    I2CBUS_BUFFER_SIZE = 32,
     I2CBUS_QUEUE_SIZE = 8,
     I2CBUS_DELAY_MS = 10,
+    // the task detects the lost transaction after the hardware timeout (TIMEOUTR, SETTING_I2C_TIMEOUT_MS) and this
+    // margin, so the interface reports the stuck SCL first
+    I2CBUS_LOST_MARGIN_MS = 10,
+
+    // the per-device circuit breaker: it opens after the consecutive failures; after the back-off it is half-open:
+    // one request (probe) is let through, the others are rejected until it is completed. The back-off doubles after
+    // each failed probe: BACKOFF_MS, 2 * BACKOFF_MS, ... (1 << MAX_LEVEL) * BACKOFF_MS
+    I2CBUS_MAX_DEVICES = 8,
+    I2CBUS_BREAKER_FAILURES = 3,
+    I2CBUS_BREAKER_BACKOFF_MS = 100,
+    I2CBUS_BREAKER_MAX_LEVEL = 6,
+
+    I2CBUS_MAX_CLIENTS = 8, // the distinct completion targets, which are counted by the wakeup statistics
 
     I2CBUS_NOTIF_TX_FLAG = 1 << 0,
     I2CBUS_NOTIF_RX_FLAG = 1 << 1,
     I2CBUS_NOTIF_ERR_FLAG = 1 << 2,
     I2CBUS_NOTIF_ABORT_FLAG = 1 << 3,
+    I2CBUS_NOTIF_KICK_FLAG = 1 << 4, // a new request is queued
+    I2CBUS_NOTIF_RECOVER_FLAG = 1 << 5, // the bus is stuck, the engine is handed over to the task
+};
+
+// the way the request completion is delivered to its owner (from the I2C interrupt, the failures - from the bus task)
+enum I2CCompletion_Types {
+    I2C_COMPLETION_NONE = 0, // poll I2C_isWriting()/I2C_isReading()
+    I2C_COMPLETION_NOTIFY, // xTaskNotify(task, notification, eSetBits)
+    I2C_COMPLETION_CALLBACK, // callback(request, priorityTaskWoken), it runs in the interrupt context
+    I2C_COMPLETION_SEMAPHORE, // xSemaphoreGive(semaphore)
+};
+
+/*
+ * The transaction: the write phase (if txSize > 0), then the read phase (if rxSize > 0) after the repeated start.
+ * Both phases are served by the interrupts, the next queued transaction is started from the completion interrupt.
+ * A phase can be of any length: one Start, NBYTES is reloaded by the interface (see I2C_startReload).
+ */
+typedef struct {
+    bool isNeedStop; // only for the write transactions, False - the next transaction starts with the repeated start
+    uint16_t address;
+    size_t txSize;
+    size_t rxSize;
+    const uint8_t *txData;
+    uint8_t *rxData;
+} I2CTransactionDef;
+
+typedef struct I2CRequestDef I2CRequestDef;
+
+/**
+ * @brief The request completion callback (the I2C interrupt or, for the failures, the bus task with the interrupts
+ * masked; only FromISR API)
+ * @param request is the completed request
+ * @param priorityTaskWoken is set to pdTRUE, if a task has to run
+ */
+typedef void (*I2CFun_complete)(I2CRequestDef *request, BaseType_t *priorityTaskWoken);
+
+/*
+ * The request and its buffers are owned by the caller and must stay valid until the request is completed,
+ * the bus queue holds only the pointers (no copies).
+ */
+struct I2CRequestDef {
+    I2CTransactionDef trans;
+
+    volatile bool isWriting;
+    volatile bool isReading;
+    volatile int32_t status; // I2C_Errors value of the last completed transaction
+    bool isProbe; // ACK polling: NACK (I2C_NACK) is an expected answer, it isn't counted by the circuit breaker
+
+    uint8_t completion; // I2CCompletion_Types value
+    TaskHandle_t task;
+    uint32_t notification;
+    I2CFun_complete callback;
+    void *arg;
+    SemaphoreHandle_t semaphore;
 };
 
 typedef struct {
-    bool isNeedStop;
     uint16_t address;
-    uint16_t size;
-    uint8_t *data;
-} I2CPackageDef;
+    uint8_t failures; // consecutive, 0 - the entry is free
+    uint8_t level; // back-off exponent
+    TickType_t retryTime; // the breaker is open until this tick, then one request is let through (probe)
+    bool isProbing; // half-open: the probe is submitted, but not completed yet
+} I2CBreakerDef;
 
 typedef struct {
     I2CDef *i2c;
+    TaskHandle_t task;
 
-    bool isWriting;
-    bool isReading;
     uint32_t errors;
-
-    // a temporary buffer to send/read data via I2C  - DMA
-    uint8_t buffer[I2CBUS_BUFFER_SIZE];
+    I2CBreakerDef breakers[I2CBUS_MAX_DEVICES]; // it is changed by the interrupts, the task uses critical sections
+
+    // the transaction engine, the current request is owned by the interrupts while isBusy is set; isBusy without
+    // the active request - the engine is owned by the task (the recovery), the interrupts are ignored
+    volatile bool isBusy;
+    I2CRequestDef *active;
+
+    // bus utilisation: busyCycles / (elapsed cycles), see cycles.h
+    volatile uint32_t transactions;
+    volatile uint32_t busyCycles;
+    uint32_t startTime;
+
+    // the failures: the bus time of the failed transactions and recoveries (lost throughput), the blocked requests
+    volatile uint32_t lostCycles;
+    uint32_t recoveries;
+    uint32_t recoveryCycles; // total, the average recovery time: recoveryCycles / recoveries
+    uint32_t maxRecoveryCycles;
+    uint32_t rejected;
+
+    // the completion is delivered only to the request owner; the former bus-wide event bit woke the bus task and
+    // the clients waiting for it. estimatedWakeups is an upper bound, not a count: it adds the bus task and all
+    // registered clients except the owner per completion, as if each of them were waiting at that moment
+    const void *clients[I2CBUS_MAX_CLIENTS]; // the notified tasks, the callback arguments, the semaphores
+    uint8_t numClients;
+    volatile uint32_t completions;
+    volatile uint32_t estimatedWakeups;
 
     SemaphoreHandle_t mutex;
-    EventGroupHandle_t eventGroup;
     QueueHandle_t queue;
-} I2CBusDef;
 
-extern I2CDef I2C1_intf;
+    // each bus owns its kernel objects and task, the buses are served concurrently
+    StaticSemaphore_t mutexBuffer;
+    StaticQueue_t queueBuffer;
+    uint8_t queueStorage[I2CBUS_QUEUE_SIZE * sizeof(I2CRequestDef *)];
+    StaticTask_t taskTCB;
+    StackType_t taskStack[configMINIMAL_STACK_SIZE];
+} I2CBusDef;
 
 TaskHandle_t I2CJobInit(I2CBusDef *bus, I2CDef *i2c, uint8_t priorityLevel);
 
-bool I2C_isWriting(const I2CBusDef *bus);
+void I2C_setNotification(I2CRequestDef *request, TaskHandle_t task, uint32_t notification);
+
+void I2C_setCallback(I2CRequestDef *request, I2CFun_complete callback, void *arg);
 
-int32_t I2C_writeData(I2CBusDef *bus, uint16_t addr, const void *src, size_t size, bool isNeedStop);
+void I2C_setSemaphore(I2CRequestDef *request, SemaphoreHandle_t semaphore);
 
-bool I2C_isReading(const I2CBusDef *bus);
+bool I2C_isWriting(const I2CRequestDef *request);
 
-int32_t I2C_readData(I2CBusDef *bus, uint16_t addr, size_t size);
+int32_t I2C_writeData(I2CBusDef *bus, I2CRequestDef *request, uint16_t addr, const void *src, size_t size,
+                      bool isNeedStop);
 
-const void *I2C_getReceivedData(const I2CBusDef *bus);
+bool I2C_isReading(const I2CRequestDef *request);
+
+int32_t I2C_readData(I2CBusDef *bus, I2CRequestDef *request, uint16_t addr, void *dst, size_t size);
+
+int32_t I2C_writeReadData(I2CBusDef *bus, I2CRequestDef *request, uint16_t addr, const void *src, size_t txSize,
+                          void *dst, size_t rxSize);
+
+int32_t I2C_getStatus(const I2CRequestDef *request);
 
 bool I2C_isFailed(const I2CBusDef *bus);
 
+void I2C_completeFromISR(I2CBusDef *bus, uint32_t notification, BaseType_t *priorityTaskWoken);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,58 @@
+#ifndef I2CTARGET_H
+#define I2CTARGET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "i2c.h"
+
+enum I2CTarget_Constants {
+    I2C_TARGET_MAP_SIZE = 32, // registers (bytes), power of 2: the register pointer wraps around
+    I2C_TARGET_RX_SIZE = I2C_TARGET_MAP_SIZE + 1, // the register pointer and the written data, the rest is NACKed
+
+    I2C_TARGET_IDLE = 0,
+    I2C_TARGET_RX, // the controller writes
+    I2C_TARGET_TX, // the controller reads (DMA)
+};
+
+/*
+ * The register file of the I2C target: the controller writes the register pointer (the first byte) and the data
+ * of the writable registers, the reads start at the register pointer and wrap around the map. Every read is
+ * served by DMA from the snapshot, which is taken on the address match, so the values are always consistent.
+ * The tasks change the map in the critical sections (the interrupt priority must be masked by them).
+ */
+typedef struct {
+    I2CDef *i2c;
+    const uint8_t *writable; // per register: not 0 - the controller can change it, NULL - read only map
+
+    uint8_t state;
+    uint8_t pointer;
+    uint8_t rxSize;
+    uint8_t rxBuffer[I2C_TARGET_RX_SIZE];
+    uint8_t map[I2C_TARGET_MAP_SIZE];
+    uint8_t snapshot[I2C_TARGET_MAP_SIZE]; // the read DMA source, it starts at the register pointer
+
+    uint32_t reads; // the address matches for read
+    uint32_t writes;
+    uint32_t errors; // bus errors, wrong register pointer
+} I2CTargetDef;
+
+int32_t I2CTargetInit(I2CTargetDef *target, I2CDef *i2c, const uint8_t *writable);
+
+int32_t I2CTargetUpdate(I2CTargetDef *target, uint8_t reg, const void *src, size_t size);
+
+int32_t I2CTargetGetRegisters(I2CTargetDef *target, uint8_t reg, void *dst, size_t size);
+
+void I2CTargetEventFromISR(I2CTargetDef *target);
+
+void I2CTargetErrorFromISR(I2CTargetDef *target);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //I2CTARGET_H
@@ -0,0 +1,85 @@
+#ifndef KERNELBENCHJOB_H
+#define KERNELBENCHJOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "event_groups.h"
+
+#include "SerialJob.h"
+
+enum KernelBench_Constants {
+    KERNEL_BENCH_SAMPLES = 512, // per primitive
+    KERNEL_BENCH_PERCENTILE = 99,
+    KERNEL_BENCH_PERIOD_MS = 5000, // the suite is repeated, so a host can connect at any time
+    KERNEL_BENCH_LINE_SIZE = 160,
+    KERNEL_BENCH_MAX_TESTS = 24,
+
+    KERNEL_BENCH_QUEUE_SIZE = 4,
+    KERNEL_BENCH_STREAM_SIZE = 64,
+    KERNEL_BENCH_STREAM_CHUNK = 16, // bytes per send/receive
+    KERNEL_BENCH_EVENT_BIT = 1 << 0,
+};
+
+typedef struct {
+    uint32_t min;
+    uint32_t mean;
+    uint32_t percentile;
+    uint32_t max;
+} KernelBenchResultDef;
+
+typedef struct KernelBenchDef KernelBenchDef;
+
+/**
+ * @brief Measure one sample of the primitive
+ * @param bench is the KernelBench data structure
+ * @return the duration (cycles)
+ */
+typedef uint32_t (*KernelBenchFun_measure)(KernelBenchDef *bench);
+
+struct KernelBenchDef {
+    SerialPortDef *port; // output (JSON lines)
+    uint32_t run;
+
+    // the helper task receives the signal and saves the wake up time (a new task for each test)
+    TaskHandle_t helper;
+    volatile uint32_t wakeTime;
+
+    uint32_t samples[KERNEL_BENCH_SAMPLES];
+    // all tests are done before the output, so the serial port doesn't disturb the measurements
+    KernelBenchResultDef results[KERNEL_BENCH_MAX_TESTS];
+    char line[KERNEL_BENCH_LINE_SIZE];
+
+    QueueHandle_t queue;
+    StreamBufferHandle_t stream;
+    SemaphoreHandle_t semaphore;
+    SemaphoreHandle_t mutex;
+    EventGroupHandle_t events;
+
+    // the kernel objects storage (static allocation)
+    StaticQueue_t queueBuffer;
+    uint8_t queueStorage[KERNEL_BENCH_QUEUE_SIZE * sizeof(uint32_t)];
+    StaticStreamBuffer_t streamBuffer;
+    uint8_t streamStorage[KERNEL_BENCH_STREAM_SIZE + 1];
+    StaticSemaphore_t semaphoreBuffer;
+    StaticSemaphore_t mutexBuffer;
+    StaticEventGroup_t eventsBuffer;
+    StaticTask_t taskTCB;
+    StackType_t taskStack[configMINIMAL_STACK_SIZE * 2];
+    StaticTask_t helperTCB;
+    StackType_t helperStack[configMINIMAL_STACK_SIZE];
+};
+
+TaskHandle_t KernelBenchJobInit(KernelBenchDef *bench, SerialPortDef *port, uint8_t priorityLevel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //KERNELBENCHJOB_H
@@ -0,0 +1,70 @@
+#ifndef LOGGERJOB_H
+#define LOGGERJOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "SerialJob.h"
+
+enum Logger_Constants {
+    LOGGER_BUFFER_SIZE = 512,
+    LOGGER_MAX_ARGS = 4,
+    LOGGER_DELAY_MS = 20,
+
+    // record: sync byte, format string ID (2 bytes), number of arguments, arguments (4 bytes each)
+    LOGGER_SYNC_BYTE = 0xA5,
+    LOGGER_HEADER_SIZE = 4,
+    LOGGER_RECORD_SIZE = LOGGER_HEADER_SIZE + LOGGER_MAX_ARGS * 4,
+};
+
+typedef struct {
+    SerialPortDef *port;
+
+    volatile uint32_t lost; // records that didn't fit into the buffer
+
+    // the binary records, waiting to be sent via the Serial Port. The indexes are free-running (the buffer position
+    // is index % LOGGER_BUFFER_SIZE): a writer reserves the space by moving reserved (compare-and-swap), copies its
+    // record, and the last active writer (writers drops to 0) publishes reserved as head; the task sends up to head
+    uint8_t buffer[LOGGER_BUFFER_SIZE];
+    volatile uint32_t reserved;
+    volatile uint32_t writers;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} LoggerDef;
+
+extern LoggerDef Logger;
+
+extern const char _slogstr[]; // the start of the ".logstr" section (the linker script)
+
+#define LOG_NARGS(...) LOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, N, ...) N
+
+/**
+ * @brief Log the message, callable from tasks and ISRs.
+ * The arguments are integers up to 32 bits, each is sent as its 32-bit pattern: %d and %i print the signed values
+ * (the decoder converts them back to int32_t), %u, %x, %X, %o and %c - the unsigned ones. 64-bit integers, floating
+ * point values, pointers and strings (%s) aren't supported.
+ * The format string is placed into the ".logstr" section (not loaded to the target), only its offset from the
+ * section start (ID) and the raw arguments are sent, a host decoder restores the text from the ELF file.
+ * The offset doesn't depend on the section address: it is 0 in the firmware, the simulation loads the section
+ * at a host address (sim/logstr.ld).
+ */
+#define LOG(fmt, ...) do { \
+    static const char logFormat[] __attribute__((section(".logstr"), used)) = fmt; \
+    const uint32_t logArgs[LOGGER_MAX_ARGS + 1] = {0, ##__VA_ARGS__}; \
+    LoggerWrite(&Logger, (uint16_t) (logFormat - _slogstr), logArgs + 1, LOG_NARGS(__VA_ARGS__)); \
+} while (0)
+
+TaskHandle_t LoggerJobInit(LoggerDef *logger, SerialPortDef *port, uint8_t priorityLevel);
+
+bool LoggerWrite(LoggerDef *logger, uint16_t id, const uint32_t *args, uint8_t numArgs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //LOGGERJOB_H
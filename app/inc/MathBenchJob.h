@@ -0,0 +1,52 @@
+#ifndef MATHBENCHJOB_H
+#define MATHBENCHJOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "SerialJob.h"
+#include "Cordic.h"
+
+enum MathBench_Constants {
+    MATH_BENCH_BATCH = 64, // operations per call
+    MATH_BENCH_REPEATS = 16, // calls per test
+    MATH_BENCH_PERIOD_MS = 5000, // the suite is repeated, so a host can connect at any time
+    MATH_BENCH_LINE_SIZE = 192,
+    MATH_BENCH_MAX_TESTS = 5,
+};
+
+typedef struct {
+    uint32_t cordicCycles; // elapsed, the math service (CORDIC)
+    uint32_t libmCycles; // elapsed, the software engine (libm)
+    uint32_t maxDifference; // q1.31 LSBs, the CORDIC results against libm
+    uint32_t errors;
+} MathBenchResultDef;
+
+typedef struct {
+    SerialPortDef *port; // output (JSON lines)
+    CordicDef *cordic;
+    uint32_t run;
+
+    int32_t arguments[MATH_BENCH_BATCH * 2];
+    int32_t results[MATH_BENCH_BATCH * 2];
+    int32_t reference[MATH_BENCH_BATCH * 2];
+
+    // all tests are done before the output, so the serial port doesn't disturb the measurements
+    MathBenchResultDef tests[MATH_BENCH_MAX_TESTS];
+    char line[MATH_BENCH_LINE_SIZE];
+
+    StaticTask_t taskTCB;
+    StackType_t taskStack[configMINIMAL_STACK_SIZE * 2];
+} MathBenchDef;
+
+TaskHandle_t MathBenchJobInit(MathBenchDef *bench, SerialPortDef *port, CordicDef *cordic, uint8_t priorityLevel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MATHBENCHJOB_H
@@ -0,0 +1,90 @@
+#ifndef SENSORPOLL_H
+#define SENSORPOLL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "I2CBusJob.h"
+
+enum SensorPoll_Errors {
+    SENSOR_POLL_SUCCESS = 0,
+    SENSOR_POLL_WRONG_DATA = -1,
+};
+
+enum SensorPoll_Constants {
+    SENSOR_POLL_MAX_ENTRIES = 16,
+    SENSOR_POLL_MAX_GROUPS = 8, // burst reads, one task notification bit each
+    SENSOR_POLL_BURST_SIZE = 16, // registers per burst read
+    SENSOR_POLL_MAX_GAP = 2, // unused registers, read to merge two entries (cheaper than a new transaction)
+};
+
+/**
+ * @brief Decode the raw register values of the entry
+ * @param data is the first register of the entry (inside the burst read)
+ * @return the decoded value
+ */
+typedef int32_t (*SensorFun_decode)(const uint8_t *data);
+
+// the polling table entry: the register range of the I2C device, it is read every periodMs
+typedef struct {
+    uint8_t bus; // the index of the I2C bus (see SensorPollInit)
+    uint16_t address;
+    uint8_t reg;
+    uint8_t size; // registers (bytes)
+    uint16_t periodMs;
+    SensorFun_decode decode;
+} SensorPollEntryDef;
+
+typedef struct {
+    int32_t value;
+    TickType_t timestamp; // the tick of the read completion, 0 - no value yet
+} SensorValueDef;
+
+// the adjacent entries of the same device and rate are read by one write-then-read transaction
+typedef struct {
+    I2CBusDef *bus;
+    uint16_t address;
+    uint8_t reg;
+    uint8_t size;
+    TickType_t period;
+    TickType_t nextTime;
+
+    uint8_t first; // the group entries: order[first] ... order[first + count - 1]
+    uint8_t count;
+
+    uint32_t errors;
+    I2CRequestDef request;
+    uint8_t buffer[SENSOR_POLL_BURST_SIZE];
+} SensorPollGroupDef;
+
+typedef struct {
+    TaskHandle_t task;
+
+    const SensorPollEntryDef *table;
+    uint8_t numEntries;
+    uint8_t numGroups;
+    uint8_t order[SENSOR_POLL_MAX_ENTRIES]; // the table indexes, sorted by the bus, device, rate and register
+    uint32_t reads; // the issued transactions
+
+    SensorPollGroupDef groups[SENSOR_POLL_MAX_GROUPS];
+    SensorValueDef values[SENSOR_POLL_MAX_ENTRIES];
+} SensorPollDef;
+
+int32_t SensorPollInit(SensorPollDef *poll, I2CBusDef *buses, size_t numBuses, const SensorPollEntryDef *table,
+                       size_t numEntries, TaskHandle_t task);
+
+TickType_t SensorPollStart(SensorPollDef *poll);
+
+void SensorPollComplete(SensorPollDef *poll, uint32_t completed);
+
+bool SensorPollGetValue(const SensorPollDef *poll, size_t index, SensorValueDef *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //SENSORPOLL_H
@@ -8,47 +8,176 @@ extern "C" {
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
+#include "queue.h"
 #include "stream_buffer.h"
+#include "message_buffer.h"
 
 #include "uart.h"
 
 enum SerialPort_Constants {
     SERIAL_PORT_BUFFER_SIZE = 128,
 
-    SERIAL_PORT_STREAM_SIZE = 1024,
+    SERIAL_PORT_STREAM_SIZE = 1024, // default size of the input stream and the output ring
     SERIAL_PORT_TRIGGER_LEVEL = SERIAL_PORT_BUFFER_SIZE / 2, // stream buffer
 
     SERIAL_PORT_DELAY_MS = 100,
 
+    // the latency histogram: the write call to the DMA start of its first byte, bucket k - less than
+    // BASE_US << k, the last bucket - the rest
+    SERIAL_LATENCY_BUCKETS = 10,
+    SERIAL_LATENCY_BASE_US = 8,
+
+    // asynchronous write requests
+    SERIAL_REQUEST_QUEUE_SIZE = 8, // per priority level
+    SERIAL_PRIORITY_HIGH = 0, // control replies, they overtake the output ring data
+    SERIAL_PRIORITY_LOW, // bulk telemetry, it is sent after the output ring data
+    SERIAL_NUMBER_PRIORITIES,
+
+    SERIAL_REQUEST_DONE = 0,
+    SERIAL_REQUEST_PENDING = 1,
+
+    // runtime baud rate switching
+    SERIAL_BAUD_CONFIRM_MS = 1000, // the peer must confirm the new baud rate, otherwise - fall back
+    SERIAL_BAUD_MAX_ERRORS = 8, // fall back to the base baud rate after this number of UART errors
+
+    // packet mode: COBS frames, separated by zero byte
+    SERIAL_PACKET_SIZE = 64, // max payload size
+    SERIAL_PACKET_CRC_SIZE = 4,
+    SERIAL_FRAME_SIZE = SERIAL_PACKET_SIZE + SERIAL_PACKET_CRC_SIZE + 2, // max encoded size (without delimiter)
+    SERIAL_FRAME_DELIMITER = 0x00,
+    SERIAL_FRAMES_STORAGE_SIZE = 512, // message buffer
+
     SERIAL_NOTIF_TX_FLAG = 1 << 0,
     SERIAL_NOTIF_RX_FLAG = 1 << 1,
     SERIAL_NOTIF_ERR_FLAG = 1 << 2,
     SERIAL_NOTIF_ABORT_FLAG = 1 << 3,
+    SERIAL_NOTIF_DATA_FLAG = 1 << 4, // new data in the output ring, the link is idle
+    SERIAL_NOTIF_BAUD_FLAG = 1 << 5, // the baud rate change has been requested
 };
 
+typedef struct SerialRequestDef SerialRequestDef;
+
+typedef void (*SerialFun_done)(SerialRequestDef *request);
+
+/**
+ * @brief Asynchronous write request, it is owned by the caller and the data are sent without copying,
+ * so both must stay valid until the request is done
+ */
+struct SerialRequestDef {
+    const void *data;
+    uint16_t size;
+    uint8_t priority; // SERIAL_PRIORITY_HIGH or SERIAL_PRIORITY_LOW
+    volatile int32_t status; // SERIAL_REQUEST_PENDING or SERIAL_REQUEST_DONE
+
+    // completion (optional): the callback is called from the Serial Port task, then the task is notified
+    SerialFun_done callback;
+    void *context;
+    TaskHandle_t task;
+    uint32_t notificationBits;
+};
+
+/**
+ * @brief Buffers of the Serial Port instance, they are sized at compile time (see SERIAL_PORT_BUFFERS)
+ */
+typedef struct {
+    uint8_t *rxStream; // input stream storage
+    uint16_t rxStreamSize;
+    uint8_t *txRing; // output ring buffer
+    uint16_t txRingSize;
+    uint8_t *rxFrames; // complete frames storage (packet mode)
+    uint16_t rxFramesSize;
+} SerialBuffersDef;
+
+/**
+ * @brief Define the static buffers of the Serial Port instance (framesSize can be 0, if the packet mode isn't used)
+ */
+#define SERIAL_PORT_BUFFERS(name, rxSize, txSize, framesSize) \
+    static uint8_t name##_rxStream[rxSize]; \
+    static uint8_t name##_txRing[txSize]; \
+    static uint8_t name##_rxFrames[(framesSize) ? (framesSize) : 1]; \
+    static const SerialBuffersDef name = { \
+        name##_rxStream, (rxSize), name##_txRing, (txSize), name##_rxFrames, (framesSize) \
+    }
+
 typedef struct {
     UartDef *uart;
+    TaskHandle_t task;
+    const SerialBuffersDef *buffers;
 
     uint32_t errors;
 
-    // a temporary buffer to send/read data via UART - DMA
+    uint32_t baseBaudRate; // the initial (fallback) baud rate
+    uint32_t baudRate;
+    uint32_t requestedBaudRate; // 0 - there is no request
+    uint16_t baudSwitchIndex; // the data before this output ring index are sent with the previous baud rate
+    uint32_t baudErrors; // UART errors since the last baud rate change
+    TickType_t baudChangeTime;
+    bool isBaudConfirmed;
+
+    uint16_t rxPosition; // read index inside the circular DMA buffer
+
+    // a temporary buffer to read data via UART - DMA (circular mode)
     uint8_t rxBuffer[SERIAL_PORT_BUFFER_SIZE];
-    uint8_t txBuffer[SERIAL_PORT_BUFFER_SIZE];
+
+    // the output ring buffer, DMA sends data directly from it
+    uint8_t *txRing;
+    uint16_t txRingSize;
+    volatile uint16_t txHead; // write index (SerialWriteData)
+    volatile uint16_t txTail; // read index (Serial Port task)
+    volatile uint16_t txLength; // size of the region that is being sent via DMA (0 - the link is idle)
+
+    // the output latency (see SERIAL_LATENCY_BUCKETS): the time of the oldest write, that isn't being sent yet
+    uint32_t txWriteTime;
+    bool isTxWriteTimed;
+    uint32_t txLatency[SERIAL_LATENCY_BUCKETS];
+    uint32_t txMaxLatency; // cycles, see cycles.h
+
+    // the asynchronous request that is being sent (NULL - the output ring data)
+    SerialRequestDef *txRequest;
+    QueueHandle_t txQueues[SERIAL_NUMBER_PRIORITIES];
+
+    // packet mode: the frame that is being received (RX path) and the complete frames
+    uint8_t rxFrame[SERIAL_FRAME_SIZE];
+    uint16_t rxFrameLength;
+    bool isFrameBroken; // the frame is too long, skip it up to the next delimiter
+    MessageBufferHandle_t rxFrames; // NULL - byte stream mode
+    void *crc; // CRC module handle (HAL)
 
     SemaphoreHandle_t rxMutex;
     StreamBufferHandle_t rxStream;
     SemaphoreHandle_t txMutex;
-    StreamBufferHandle_t txStream;
+    SemaphoreHandle_t txSpace; // the sent region of the output ring has been released
+
+    // the kernel objects of the instance (static allocation)
+    StaticSemaphore_t rxMutexBuffer;
+    StaticStreamBuffer_t rxStreamBuffer;
+    StaticSemaphore_t txMutexBuffer;
+    StaticSemaphore_t txSpaceBuffer;
+    StaticQueue_t txQueuesBuffer[SERIAL_NUMBER_PRIORITIES];
+    uint8_t txQueuesStorage[SERIAL_NUMBER_PRIORITIES][SERIAL_REQUEST_QUEUE_SIZE * sizeof(SerialRequestDef *)];
+    StaticMessageBuffer_t rxFramesBuffer;
+    StaticTask_t taskTCB;
+    StackType_t taskStack[configMINIMAL_STACK_SIZE];
 } SerialPortDef;
 
-extern UartDef UART1_intf;
-
-TaskHandle_t SerialJobInit(SerialPortDef *port, UartDef *uart, uint8_t priorityLevel);
+TaskHandle_t SerialJobInit(SerialPortDef *port, UartDef *uart, const SerialBuffersDef *buffers, uint8_t priorityLevel);
 
 int32_t SerialWriteData(SerialPortDef *port, const void *src, size_t size);
 
+int32_t SerialTryWriteData(SerialPortDef *port, const void *src, size_t size);
+
+int32_t SerialSubmitData(SerialPortDef *port, SerialRequestDef *request);
+
 int32_t SerialReadData(SerialPortDef *port, void *dst, size_t size);
 
+int32_t SerialSetBaudRate(SerialPortDef *port, uint32_t baudRate);
+
+void SerialConfirmBaudRate(SerialPortDef *port);
+
+void SerialEnableFraming(SerialPortDef *port, void *crc);
+
+size_t SerialReceiveFromISR(SerialPortDef *port, uint16_t position, BaseType_t *priorityTaskWoken);
+
 #ifdef __cplusplus
 }
 #endif
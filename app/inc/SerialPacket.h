@@ -0,0 +1,33 @@
+#ifndef SERIALPACKET_H
+#define SERIALPACKET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "SerialJob.h"
+
+enum SerialPacket_Errors {
+    SERIAL_PACKET_SUCCESS = 0,
+    SERIAL_PACKET_WRONG_DATA = -1,
+    SERIAL_PACKET_BROKEN = -2, // wrong COBS encoding or CRC
+    SERIAL_PACKET_BUSY = -3, // the CRC module is owned by another port longer than SERIAL_PORT_DELAY_MS
+};
+
+size_t cobsEncode(const uint8_t *src, size_t size, uint8_t *dst);
+
+int32_t cobsDecode(const uint8_t *src, size_t size, uint8_t *dst, size_t dstSize);
+
+void SerialPacketInit(SerialPortDef *port, void *crc);
+
+int32_t SerialWritePacket(SerialPortDef *port, const void *src, size_t size);
+
+int32_t SerialReadPacket(SerialPortDef *port, void *dst, size_t size);
+
+bool SerialIsPacketReceived(const SerialPortDef *port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //SERIALPACKET_H
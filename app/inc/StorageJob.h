@@ -0,0 +1,118 @@
+#ifndef STORAGEJOB_H
+#define STORAGEJOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "I2CBusJob.h"
+#include "settings.h"
+
+enum Storage_Errors {
+    STORAGE_SUCCESS = 0,
+    STORAGE_WRONG_DATA = -1,
+    STORAGE_BUS_ERROR = -2, // the I2C transaction is failed (see I2C_Errors) or isn't completed in time
+    STORAGE_TIMEOUT = -3, // the write cycle isn't finished in time (the device doesn't acknowledge)
+    STORAGE_QUEUE_FULL = -4,
+};
+
+enum Storage_Constants {
+    STORAGE_QUEUE_SIZE = 8,
+    STORAGE_DELAY_MS = 10,
+    STORAGE_MAX_ADDRESS_SIZE = 2, // the memory address bytes
+    STORAGE_MAX_BURST = 128, // bytes per write transaction: the EEPROM page (the largest one) or the FRAM burst
+    STORAGE_MAX_READ = 256, // bytes per read transaction, so the sensor requests aren't delayed for long
+    STORAGE_MAX_BATCH = 8, // the queued writes merged into one burst
+
+    // the transaction wait limit: the bus task fails the lost transaction after its timeout, so the longest wait is
+    // the bus queue (the requests before this one) and this transaction, each one takes the timeout and the longest
+    // storage transfer at most
+    STORAGE_TRANSACTION_MS = SETTING_I2C_TIMEOUT_MS + I2CBUS_LOST_MARGIN_MS +
+                             (STORAGE_MAX_ADDRESS_SIZE + STORAGE_MAX_READ) * 9 * 1000 / I2C_STANDARD_MODE_HZ,
+    STORAGE_BUS_WAIT_MS = (I2CBUS_QUEUE_SIZE + 1) * STORAGE_TRANSACTION_MS,
+
+    STORAGE_EEPROM = 0, // 24xx: the page write, then the write cycle (NACK until it is finished)
+    STORAGE_FRAM, // FM24xx, MB85RC: no pages, no write cycle
+
+    STORAGE_READ = 0,
+    STORAGE_WRITE,
+
+    STORAGE_NOTIF_I2C_FLAG = 1 << 0,
+};
+
+// the memory device, e.g. 24xx512 - {STORAGE_EEPROM, 0x50, 65536, 128, 2, 5},
+// FM24CL64 - {STORAGE_FRAM, 0x50, 8192, 0, 2, 0}
+typedef struct {
+    uint8_t type; // STORAGE_EEPROM or STORAGE_FRAM
+    uint16_t address; // the I2C address, the parts with 1-byte memory address take the high bits from it (24C16)
+    uint32_t size; // bytes
+    uint16_t pageSize; // the write page (bytes, power of 2, up to STORAGE_MAX_BURST), 0 - no pages
+    uint8_t addressSize; // the memory address bytes: 1 or 2
+    uint16_t writeTimeMs; // the maximum write cycle (datasheet), the ACK polling gives up after it
+} StorageDeviceDef;
+
+/*
+ * The read or write operation: the request and its buffer are owned by the caller and must stay valid until the
+ * request is completed (the storage queue holds only the pointers). A write is completed, when the data is in the
+ * memory (the write cycle is finished). A failed read is completed, when the bus doesn't write its buffer any more.
+ */
+typedef struct {
+    uint8_t operation; // STORAGE_READ or STORAGE_WRITE
+    uint32_t memAddress;
+    uint8_t *data;
+    size_t size;
+
+    volatile bool isPending;
+    volatile int32_t status; // Storage_Errors value of the last completed request
+
+    TaskHandle_t task; // the completion notification, NULL - poll StorageIsPending()
+    uint32_t notification;
+} StorageRequestDef;
+
+typedef struct {
+    const StorageDeviceDef *device;
+    I2CBusDef *bus;
+    TaskHandle_t task;
+
+    I2CRequestDef request;
+    StorageRequestDef *abandoned; // the failed read, whose buffer is still owned by the given up I2C request
+    uint8_t buffer[STORAGE_MAX_ADDRESS_SIZE + STORAGE_MAX_BURST]; // the memory address and the burst data
+
+    // statistics: the write cycle time is measured from the burst end to the first acknowledge (see cycles.h)
+    uint32_t bursts; // the acknowledged ones
+    uint32_t batched; // the writes, which are merged into the bursts of the previous ones
+    uint32_t polls; // the NACKed address probes
+    uint32_t writeCycles; // total, the average write cycle: writeCycles / bursts
+    uint32_t maxWriteCycles;
+    uint32_t errors;
+
+    QueueHandle_t queue;
+    StaticQueue_t queueBuffer;
+    uint8_t queueStorage[STORAGE_QUEUE_SIZE * sizeof(StorageRequestDef *)];
+    StaticTask_t taskTCB;
+    StackType_t taskStack[configMINIMAL_STACK_SIZE];
+} StorageDef;
+
+TaskHandle_t StorageJobInit(StorageDef *storage, const StorageDeviceDef *device, I2CBusDef *bus,
+                            uint8_t priorityLevel);
+
+void StorageSetNotification(StorageRequestDef *request, TaskHandle_t task, uint32_t notification);
+
+int32_t StorageRead(StorageDef *storage, StorageRequestDef *request, uint32_t memAddress, void *dst, size_t size);
+
+int32_t StorageWrite(StorageDef *storage, StorageRequestDef *request, uint32_t memAddress, const void *src,
+                     size_t size);
+
+bool StorageIsPending(const StorageRequestDef *request);
+
+int32_t StorageGetStatus(const StorageRequestDef *request);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //STORAGEJOB_H
@@ -0,0 +1,20 @@
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+void initCycleCounter(void);
+
+uint32_t getCycleCounter(void);
+
+uint32_t getCycleFrequency(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CYCLES_H
@@ -14,10 +14,48 @@ enum I2C_Errors {
     I2C_NOT_INIT = -1,
     I2C_WRONG_DATA = -2,
     I2C_HW_ERROR = -3,
+    I2C_DEVICE_BLOCKED = -4, // the device circuit breaker is open, the request isn't sent
+    I2C_NACK = -5, // the target doesn't acknowledge: it is absent or busy (e.g. the EEPROM write cycle)
 
-    I2C_NUMBER_ERRORS = 3
+    I2C_NUMBER_ERRORS = 5
 };
 
+enum I2C_Constants {
+    I2C1_INDEX = 0,
+    I2C2_INDEX,
+    I2C3_INDEX,
+    I2C_NUMBER_INTERFACES,
+
+    I2C_MAX_NBYTES = 255, // CR2.NBYTES: the longer transfers are continued by the reload (TCR interrupt)
+    I2C_MAX_DMA_SIZE = 65535, // CNDTR: the longer transfers are split into the DMA segments (the same Start)
+
+    I2C_RECOVERY_CLOCKS = 9, // SCL pulses to release SDA held by a target in the middle of a byte
+    I2C_RECOVERY_HALF_PERIOD_US = 5, // 100 kHz
+
+    I2C_STANDARD_MODE_HZ = 100000,
+    I2C_FAST_MODE_HZ = 400000,
+    I2C_FAST_MODE_PLUS_HZ = 1000000,
+};
+
+// the bus parameters of the TIMINGR calculation
+typedef struct {
+    uint32_t speedHz; // up to I2C_FAST_MODE_PLUS_HZ
+    uint16_t riseTimeNs; // SCL/SDA rise time (pull-up and bus capacitance)
+    uint16_t fallTimeNs;
+    bool isAnalogFilter;
+    uint8_t digitalFilter; // 0 - off, 1 ... 15 I2CCLK periods
+} I2CTimingDef;
+
+// the transfer longer than I2C_MAX_NBYTES: one Start, one DMA stream, NBYTES is reloaded from the TCR interrupt
+typedef struct {
+    uint8_t *data; // the next DMA segment
+    size_t left; // the bytes, which aren't covered by NBYTES yet
+    size_t dmaLeft; // the bytes, which aren't given to DMA yet
+    bool isRead;
+    bool isNeedStop;
+    uint32_t reloads; // TCR interrupts, total
+} I2CReloadDef;
+
 typedef struct I2CDef I2CDef;
 
 typedef int32_t (*I2CFun_update)(I2CDef *i2c);
@@ -30,6 +68,7 @@ typedef int32_t (*I2CFun_state)(const I2CDef *i2c);
 
 struct I2CDef {
     void *const handle;
+    void *owner; // the upper layer (I2CBusDef), it is used by the interrupt callbacks
 
     bool isInit;
     bool abort;
@@ -43,8 +82,23 @@ struct I2CDef {
     const I2CFun_state getErrorType;
     const I2CFun_state getNumOfErrors;
     const I2CFun_state isFailed;
+    const I2CFun_state isBusStuck;
+    const I2CFun_state isNack;
+    const I2CFun_update recover;
+
+    I2CReloadDef reload;
 };
 
+extern I2CDef I2C1_intf;
+extern I2CDef I2C2_intf;
+extern I2CDef I2C3_intf;
+
+I2CDef *I2C_getInterface(const void *handle);
+
+int32_t I2C_computeTiming(uint32_t clockHz, const I2CTimingDef *config, uint32_t *timing);
+
+int32_t I2C_startReload(I2CDef *i2c, uint16_t addr, void *data, size_t size, bool isRead, bool isNeedStop);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,11 +7,25 @@ extern "C" {
 
 #include "variables.h"
 #include "SerialJob.h"
+#include "LoggerJob.h"
 #include "I2CBusJob.h"
+#include "KernelBenchJob.h"
+#include "I2CBenchJob.h"
+#include "MathBenchJob.h"
+#include "DspBenchJob.h"
+#include "SensorPoll.h"
+#include "I2CTarget.h"
+#include "StorageJob.h"
+#include "Decimator.h"
+#include "Filter.h"
+#include "Cordic.h"
+#include "Dsp.h"
 
 enum Job_Notifications {
     JOB_NOTIF_SENSOR_FLAG = 1 << 0,
     JOB_NOTIF_SENSOR_ERR_FLAG = 1 << 1,
+    JOB_NOTIF_STORAGE_FLAG = 1 << 2,
+    JOB_NOTIF_SENSOR_HALF_FLAG = 1 << 3, // the first half of the ADC block buffer is filled
 };
 
 enum Job_Constants {
@@ -19,17 +33,48 @@ enum Job_Constants {
     SENSORS_JOB,
     COMMUNICATION_JOB,
     SERIAL_PORT_JOB,
-    I2CBUS_JOB,
+    I2C1_BUS_JOB, // fast sensors
+    I2C2_BUS_JOB, // slow sensors, the storage
     SERVICE_JOB,
+    LOGGER_JOB,
+    CONSOLE_JOB,
+    STORAGE_JOB,
+    KERNEL_BENCH_JOB,
+    I2C_BENCH_JOB,
+    MATH_BENCH_JOB,
+    DSP_BENCH_JOB,
     NUMBER_JOBS,
 
     ROUTINE_DELAY_MS = 20,
-    SENSORS_DELAY_MS = 20,
     SENSORS_NOTIF_DELAY_MS = 50,
+    SENSORS_BLOCK_SCANS = ADC_MAX_BLOCK_SCANS, // 5.12 ms per block at 25 kHz trigger
     COMMUNICATION_DELAY_MS = 100,
-    SERVICE_DELAY_MS = 100,
+    STORAGE_WAIT_MS = STORAGE_BUS_WAIT_MS + STORAGE_DELAY_MS, // the storage task gives up the bus wait before it
+};
+
+// the Serial Port packet commands (the first payload byte), other packets are echoed
+enum Command_Constants {
+    COMMAND_SET_BAUD = 0xF1, // [baud rate, 4 bytes], the peer must send any packet with the new baud rate
+    COMMAND_BENCHMARK = 0xF2, // [mode, 1 byte], the counters are reset
+    // reply: received bytes, sent bytes, elapsed time (ms), Serial Port errors, then per sensor bus: recoveries,
+    // recovery cycles (total, max), lost cycles
+    COMMAND_STATISTICS = 0xF3,
+
+    COMMAND_SUCCESS = 0,
+    COMMAND_ERROR = 1,
+
+    BENCHMARK_ECHO = 0, // send back each received packet
+    BENCHMARK_SOURCE, // send the full-size packets continuously
+    BENCHMARK_SINK, // only count the received packets
 };
 
+typedef struct {
+    uint8_t mode;
+    uint32_t rxBytes;
+    uint32_t txBytes;
+    TickType_t startTime;
+} BenchmarkDef;
+
 typedef struct {
     uint32_t errors; // something expired, if xTicksToWait != portMAX_DELAY
 
@@ -38,15 +83,68 @@ typedef struct {
     McuDef hardware;
 } JobsDef;
 
+// the polling table indexes (sensorTable in jobs.c)
+enum Sensor_Values {
+    SENSOR_TEMPERATURE = 0, // LM75, 0.1 C
+    SENSOR_ACCEL_X, // ADXL345, 3.9 mg/LSB
+    SENSOR_ACCEL_Y,
+    SENSOR_ACCEL_Z,
+    NUMBER_SENSOR_VALUES,
+};
+
+// the I2C controller buses of the sensors, each one has its own task, queue and DMA channels
+enum Sensor_Buses {
+    SENSOR_BUS_FAST = 0, // I2C1
+    SENSOR_BUS_SLOW, // I2C2
+    NUMBER_SENSOR_BUSES,
+};
+
 typedef struct {
-    I2CBusDef interface;
+    I2CBusDef buses[NUMBER_SENSOR_BUSES];
+    SensorPollDef poll;
 } SensorsDef;
 
+// the I2C target register map (little-endian), the controller can write TARGET_REG_PWM_CONTROL only
+enum Target_Registers {
+    TARGET_REG_ID = 0x00, // 1 byte, TARGET_DEVICE_ID
+    TARGET_REG_STATUS = 0x01, // 1 byte, Target_Status bits
+    TARGET_REG_ANALOG_IN_1 = 0x02, // 2 bytes, mV
+    TARGET_REG_ANALOG_IN_2 = 0x04, // 2 bytes, mV
+    TARGET_REG_TEMPERATURE = 0x06, // 2 bytes, signed, C
+    TARGET_REG_PWM_DUTY = 0x08, // 1 byte, %
+    TARGET_REG_UPDATES = 0x09, // 4 bytes, the update counter (the values are new, if it is changed)
+    TARGET_REG_PWM_CONTROL = 0x0D, // 1 byte, 0 ... 100 - the fixed duty cycle (%), other - analog input 2
+    NUMBER_TARGET_REGISTERS,
+
+    TARGET_DEVICE_ID = 0x47,
+    TARGET_PWM_AUTO = 0xFF,
+};
+
+// the persistent data (the EEPROM on I2C2, see storageDevice in jobs.c), the erased memory is 0xFF
+enum Storage_Layout {
+    STORAGE_ADDR_BUTTON_COUNTER = 0x0000, // 4 bytes, little-endian
+};
+
+enum Target_Status {
+    TARGET_STATUS_READY = 1 << 0, // the values are measured
+    TARGET_STATUS_ADC_ERROR = 1 << 1, // any ADC error was detected
+    TARGET_STATUS_PWM_FIXED = 1 << 2, // the duty cycle is set by TARGET_REG_PWM_CONTROL
+};
+
 extern JobsDef Application;
-extern SerialPortDef Serial;
+extern SerialPortDef Serial; // the data link (USART1)
+extern SerialPortDef Console; // the debug console (LPUART1)
 extern SensorsDef Sensors;
+extern I2CTargetDef Target; // the register map for the external controller (I2C3)
+extern StorageDef Storage; // the persistent data (the EEPROM on I2C2)
+extern FilterDef AdcFilter; // the analog input 1 stream (the FMAC)
+extern CordicDef Cordic; // the math service (the CORDIC)
 
 int createJobs(JobsDef *jobs);
+int createBenchmarkJobs(JobsDef *jobs);
+int createI2CBenchmarkJobs(JobsDef *jobs);
+int createMathBenchmarkJobs(JobsDef *jobs);
+int createDspBenchmarkJobs(JobsDef *jobs);
 
 #ifdef __cplusplus
 }
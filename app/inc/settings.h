@@ -6,14 +6,25 @@ extern "C" {
 #endif
 
 #include "variables.h"
+#include "i2c.h"
 
 enum Settings_Constants {
     SETTING_SUCCESS = 0,
     SETTING_ERROR = -1,
+
+    SETTING_I2C_TIMEOUT_MS = 25, // SMBus tTIMEOUT
+    SETTING_I2C_SPEED_HZ = I2C_FAST_MODE_HZ, // I2C_FAST_MODE_PLUS_HZ - Fm+ (SYSCLK is the I2C kernel clock)
+    SETTING_I2C_TARGET_ADDRESS = 0x17, // I2C3, 7 bits
 };
 
 int initialization(McuDef *mcu);
 
+int settingI2C(I2CDef *i2c);
+
+int settingI2CTiming(I2CDef *i2c);
+
+int settingI2CTarget(I2CDef *i2c);
+
 #ifdef __cplusplus
 }
 #endif
@@ -49,6 +49,12 @@ void DMA1_Channel5_IRQHandler(void);
 
 void USART1_IRQHandler(void);
 
+void DMA2_Channel1_IRQHandler(void);
+
+void DMA2_Channel2_IRQHandler(void);
+
+void LPUART1_IRQHandler(void);
+
 void DMA1_Channel2_IRQHandler(void);
 
 void DMA1_Channel3_IRQHandler(void);
@@ -57,6 +63,24 @@ void I2C1_EV_IRQHandler(void);
 
 void I2C1_ER_IRQHandler(void);
 
+void DMA1_Channel6_IRQHandler(void);
+
+void DMA2_Channel4_IRQHandler(void);
+
+void I2C2_EV_IRQHandler(void);
+
+void I2C2_ER_IRQHandler(void);
+
+void I2C3_EV_IRQHandler(void);
+
+void I2C3_ER_IRQHandler(void);
+
+void DMA2_Channel5_IRQHandler(void);
+
+void DMA2_Channel6_IRQHandler(void);
+
+void FMAC_IRQHandler(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,12 @@ enum UART_Errors {
     UART_NUMBER_ERRORS = 3
 };
 
+enum UART_Interfaces {
+    UART1_INDEX = 0,
+    LPUART1_INDEX,
+    UART_NUMBER_INTERFACES,
+};
+
 typedef struct UartDef UartDef;
 
 typedef int32_t (*UartFun_update)(UartDef *uart);
@@ -28,8 +34,11 @@ typedef int32_t (*UartFun_rx)(UartDef *uart, void *data, size_t size);
 
 typedef int32_t (*UartFun_state)(const UartDef *uart);
 
+typedef int32_t (*UartFun_config)(UartDef *uart, uint32_t value);
+
 struct UartDef {
     void *const handle;
+    void *owner; // the upper layer (SerialPortDef), it is used by the interrupt callbacks
 
     bool isInit;
     int32_t errType;
@@ -41,8 +50,15 @@ struct UartDef {
     const UartFun_update saveError;
     const UartFun_state getErrorType;
     const UartFun_state getNumOfErrors;
+    const UartFun_config setBaudRate;
+    const UartFun_state getBaudRate;
 };
 
+extern UartDef UART1_intf;
+extern UartDef LPUART1_intf;
+
+UartDef *UART_getInterface(const void *handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,6 +17,10 @@ void checkPinState(PortDef *port);
 
 void setPWMDutyCycle(TimerDef *tim, uint16_t channel, uint8_t value);
 
+bool startADCBlocks(AdcDef *adc, uint16_t scans);
+
+void processADCBlock(AdcDef *adc);
+
 const void *getUniqueID(void);
 
 uint32_t getCRC(void *handle, const void *data, uint16_t size);
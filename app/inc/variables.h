@@ -14,6 +14,10 @@ enum Constants {
     ANALOG_IN_2,
     ANALOG_TEMP_VREF,
     NUMBER_ADC_CHANNELS,
+
+    // the scans (NUMBER_ADC_CHANNELS samples each) per half of the DMA buffer: 128 scans - 5.12 ms at 25 kHz
+    ADC_MAX_BLOCK_SCANS = 128,
+    ADC_SAMPLE_BITS = 14, // 12-bit conversions, x4 hardware oversampling without shift
 };
 
 typedef struct {
@@ -37,13 +41,34 @@ typedef struct {
     void *handle;
 } TimerDef;
 
+/**
+ * @brief Process the block of the ADC samples (the task context, the DMA fills the other half meanwhile)
+ * @param samples is the block: scans of NUMBER_ADC_CHANNELS samples (ranks order)
+ * @param scans is the number of scans
+ * @param arg is the callback argument
+ */
+typedef void (*AdcFun_block)(const uint16_t *samples, size_t scans, void *arg);
+
 typedef struct {
     uint32_t errType;
     uint32_t errors;
 
-    uint32_t rawValues[NUMBER_ADC_CHANNELS]; // relative values
+    uint32_t rawValues[NUMBER_ADC_CHANNELS]; // relative values (the block average, ADC_SAMPLE_BITS)
     uint16_t values[NUMBER_ADC_CHANNELS]; // mV
 
+    // the block acquisition: circular DMA of the half-word samples, the interrupts at the half and the end only
+    uint16_t buffer[2 * ADC_MAX_BLOCK_SCANS * NUMBER_ADC_CHANNELS];
+    uint16_t blockScans; // the block length (scans per half of the buffer)
+    volatile uint8_t readyHalf; // the last filled half: 0 - the first one, 1 - the second one
+    uint32_t blocks; // processed
+    uint32_t overruns; // both halves were filled before the task took them, one block is lost
+    AdcFun_block process; // NULL - only the averages (rawValues)
+    void *arg;
+
+    // the DMA interrupt load: isrCycles / (elapsed cycles), see cycles.h (not measured on the board yet)
+    volatile uint32_t interrupts;
+    volatile uint32_t isrCycles;
+
     void *handle;
     TimerDef timer;
 } AdcDef;
@@ -51,6 +76,8 @@ typedef struct {
 typedef struct {
     void *crc;
     void *wdt;
+    void *fmac;
+    void *cordic;
 } HandlesDef;
 
 typedef struct {
@@ -0,0 +1,221 @@
+#include <math.h>
+
+#include "Cordic.h"
+#include "cycles.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// the arguments and the results per operation (32-bit words)
+static const uint8_t numArguments[CORDIC_NUMBER_FUNCTIONS] = {1, 2, 2, 1, 1};
+static const uint8_t numResults[CORDIC_NUMBER_FUNCTIONS] = {2, 1, 1, 1, 1};
+
+/**
+ * @brief Convert q1.31 to float
+ * @param value is the q1.31 value
+ * @return the value in [-1, 1)
+ */
+static float fromQ31(int32_t value) {
+    return (float) value * (1.0f / 2147483648.0f);
+}
+
+/**
+ * @brief Convert float to q1.31 (rounded, saturated)
+ * @param value is the target value
+ * @return q1.31 value
+ */
+static int32_t toQ31(float value) {
+    if (value >= 1.0f)
+        return INT32_MAX;
+    if (value <= -1.0f)
+        return INT32_MIN;
+    return (int32_t) lrintf(value * 2147483648.0f);
+}
+
+/**
+ * @brief Get the number of the arguments per operation
+ * @param function is Cordic_Functions value
+ * @return 32-bit words
+ */
+size_t CordicGetArguments(uint8_t function) {
+    return (function < CORDIC_NUMBER_FUNCTIONS) ? numArguments[function] : 0;
+}
+
+/**
+ * @brief Get the number of the results per operation
+ * @param function is Cordic_Functions value
+ * @return 32-bit words
+ */
+size_t CordicGetResults(uint8_t function) {
+    return (function < CORDIC_NUMBER_FUNCTIONS) ? numResults[function] : 0;
+}
+
+/**
+ * @brief Calculate the function by libm (FPU, single precision): the same arguments, results and scaling as the
+ * CORDIC, the difference is within the CORDIC precision (20 bits, 6 cycles)
+ * @param function is Cordic_Functions value
+ * @param scale is the scale of SQRT and LN
+ * @param src is the arguments (q1.31)
+ * @param dst is the results (q1.31)
+ * @param count is the number of operations
+ */
+void CordicSoftware(uint8_t function, uint8_t scale, const int32_t *src, int32_t *dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        switch (function) {
+            case CORDIC_SIN_COS: {
+                float angle = fromQ31(src[i]) * (float) M_PI;
+                dst[2 * i] = toQ31(cosf(angle));
+                dst[2 * i + 1] = toQ31(sinf(angle));
+                break;
+            }
+            case CORDIC_PHASE:
+                dst[i] = toQ31(atan2f(fromQ31(src[2 * i + 1]), fromQ31(src[2 * i])) / (float) M_PI);
+                break;
+            case CORDIC_MODULUS:
+                dst[i] = toQ31(hypotf(fromQ31(src[2 * i]), fromQ31(src[2 * i + 1])));
+                break;
+            case CORDIC_SQRT:
+                dst[i] = toQ31(ldexpf(sqrtf(ldexpf(fromQ31(src[i]), scale)), -scale));
+                break;
+            case CORDIC_LN:
+                dst[i] = toQ31(ldexpf(logf(ldexpf(fromQ31(src[i]), scale)), -(scale + 1)));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Initialize the math service
+ * @param cordic is the CordicDef data structure
+ * @param handle is the CORDIC handle (HAL), NULL - the software engine
+ * @return Cordic_Errors value
+ */
+int32_t CordicInit(CordicDef *cordic, void *handle) {
+    if (cordic == NULL)
+        return CORDIC_WRONG_DATA;
+
+    cordic->handle = handle;
+    cordic->isConfigured = false;
+    cordic->operations = cordic->cycles = cordic->reconfigurations = cordic->errors = 0;
+    cordic->mutex = xSemaphoreCreateMutexStatic(&cordic->mutexBuffer);
+    return CORDIC_SUCCESS;
+}
+
+/**
+ * @brief Calculate the batch of operations of one function: the CORDIC zero-overhead mode (the results are read
+ * as soon as they are ready, no polling of the flags) or the software engine
+ * @param cordic is the CordicDef data structure
+ * @param function is Cordic_Functions value
+ * @param scale is the scale of SQRT and LN (0 for other functions)
+ * @param src is the arguments (q1.31, CordicGetArguments per operation)
+ * @param dst is the results (q1.31, CordicGetResults per operation)
+ * @param count is the number of operations
+ * @return Cordic_Errors value
+ */
+int32_t CordicCalculate(CordicDef *cordic, uint8_t function, uint8_t scale, const int32_t *src, int32_t *dst,
+                        size_t count) {
+    if (function >= CORDIC_NUMBER_FUNCTIONS || src == NULL || dst == NULL || count == 0)
+        return CORDIC_WRONG_DATA;
+    if (function == CORDIC_SQRT && scale > CORDIC_MAX_SQRT_SCALE)
+        return CORDIC_WRONG_DATA;
+    if (function == CORDIC_LN && (scale < CORDIC_MIN_LN_SCALE || scale > CORDIC_MAX_LN_SCALE))
+        return CORDIC_WRONG_DATA;
+    if (function != CORDIC_SQRT && function != CORDIC_LN)
+        scale = 0;
+
+    if (xSemaphoreTake(cordic->mutex, pdMS_TO_TICKS(CORDIC_TIMEOUT_MS)) != pdTRUE)
+        return CORDIC_BUSY;
+
+    int32_t status = CORDIC_SUCCESS;
+    uint32_t start = getCycleCounter();
+
+    if (cordic->handle == NULL) {
+        CordicSoftware(function, scale, src, dst, count);
+    } else {
+        if (!cordic->isConfigured || cordic->function != function || cordic->scale != scale) {
+            cordic->function = function;
+            cordic->scale = scale;
+            cordic->reconfigurations++;
+            status = Cordic_configHardware(cordic);
+            cordic->isConfigured = (status == CORDIC_SUCCESS);
+        }
+        if (status == CORDIC_SUCCESS)
+            status = Cordic_calculateHardware(cordic, src, dst, count);
+    }
+
+    if (status == CORDIC_SUCCESS) {
+        cordic->cycles += getCycleCounter() - start;
+        cordic->operations += (uint32_t) count;
+    } else {
+        cordic->isConfigured = false;
+        cordic->errors++;
+    }
+
+    xSemaphoreGive(cordic->mutex);
+    return status;
+}
+
+/**
+ * @brief Calculate cos and sin of the angles
+ * @param cordic is the CordicDef data structure
+ * @param angles is the angles / pi (q1.31)
+ * @param results is the pairs: cos, sin (q1.31)
+ * @param count is the number of angles
+ * @return Cordic_Errors value
+ */
+int32_t CordicSinCos(CordicDef *cordic, const int32_t *angles, int32_t *results, size_t count) {
+    return CordicCalculate(cordic, CORDIC_SIN_COS, 0, angles, results, count);
+}
+
+/**
+ * @brief Calculate the phase of the points: atan2(y, x)
+ * @param cordic is the CordicDef data structure
+ * @param points is the pairs: x, y (q1.31)
+ * @param phases is the phases / pi (q1.31)
+ * @param count is the number of points
+ * @return Cordic_Errors value
+ */
+int32_t CordicPhase(CordicDef *cordic, const int32_t *points, int32_t *phases, size_t count) {
+    return CordicCalculate(cordic, CORDIC_PHASE, 0, points, phases, count);
+}
+
+/**
+ * @brief Calculate the magnitude of the points: sqrt(x^2 + y^2)
+ * @param cordic is the CordicDef data structure
+ * @param points is the pairs: x, y (q1.31), the magnitude must be less than 1
+ * @param moduli is the magnitudes (q1.31)
+ * @param count is the number of points
+ * @return Cordic_Errors value
+ */
+int32_t CordicModulus(CordicDef *cordic, const int32_t *points, int32_t *moduli, size_t count) {
+    return CordicCalculate(cordic, CORDIC_MODULUS, 0, points, moduli, count);
+}
+
+/**
+ * @brief Calculate the square roots
+ * @param cordic is the CordicDef data structure
+ * @param values is x * 2^-scale (q1.31)
+ * @param roots is sqrt(x) * 2^-scale (q1.31)
+ * @param count is the number of values
+ * @param scale is 0 ... CORDIC_MAX_SQRT_SCALE (see Cordic_Functions for the ranges)
+ * @return Cordic_Errors value
+ */
+int32_t CordicSqrt(CordicDef *cordic, const int32_t *values, int32_t *roots, size_t count, uint8_t scale) {
+    return CordicCalculate(cordic, CORDIC_SQRT, scale, values, roots, count);
+}
+
+/**
+ * @brief Calculate the natural logarithms
+ * @param cordic is the CordicDef data structure
+ * @param values is x * 2^-scale (q1.31)
+ * @param logs is ln(x) * 2^-(scale + 1) (q1.31)
+ * @param count is the number of values
+ * @param scale is CORDIC_MIN_LN_SCALE ... CORDIC_MAX_LN_SCALE (see Cordic_Functions for the ranges)
+ * @return Cordic_Errors value
+ */
+int32_t CordicLn(CordicDef *cordic, const int32_t *values, int32_t *logs, size_t count, uint8_t scale) {
+    return CordicCalculate(cordic, CORDIC_LN, scale, values, logs, count);
+}
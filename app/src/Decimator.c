@@ -0,0 +1,147 @@
+#include <string.h>
+
+#include "Decimator.h"
+
+// the internal full scale of the half-band stages (bits)
+#define DECIMATOR_INTERNAL_BITS (DECIMATOR_OUTPUT_BITS + DECIMATOR_GUARD_BITS)
+
+/**
+ * @brief Round and shift the value to the right (a negative shift - to the left)
+ * @param value is the target value
+ * @param shift is the number of bits
+ * @return the shifted value
+ */
+static int32_t roundShift(int32_t value, int shift) {
+    if (shift <= 0)
+        return (int32_t) ((uint32_t) value << -shift);
+    return (value + (1 << (shift - 1))) >> shift;
+}
+
+/**
+ * @brief Initialize the decimation chains, the state of the channels is cleared
+ * @param dec is the DecimatorDef data structure
+ * @param stages is the stages of each channel
+ * @param channels is the number of channels (the samples per scan)
+ * @param inputBits is the sample width (bits)
+ * @return Decimator_Errors value
+ */
+int32_t DecimatorInit(DecimatorDef *dec, const DecimatorStagesDef *stages, size_t channels, uint8_t inputBits) {
+    if (channels == 0 || channels > DECIMATOR_MAX_CHANNELS || inputBits == 0 || inputBits > DECIMATOR_OUTPUT_BITS)
+        return DECIMATOR_WRONG_DATA;
+
+    for (size_t i = 0; i < channels; ++i) {
+        // the CIC output must fit 31 bits (it is converted to the signed internal scale)
+        if (stages[i].cicShift > DECIMATOR_MAX_CIC_SHIFT || stages[i].halfBands > DECIMATOR_MAX_HALF_BANDS ||
+            inputBits + DECIMATOR_CIC_ORDER * stages[i].cicShift > 31)
+            return DECIMATOR_WRONG_DATA;
+    }
+
+    memset(dec, 0, sizeof(DecimatorDef));
+    memcpy(dec->stages, stages, channels * sizeof(DecimatorStagesDef));
+    dec->channels = (uint8_t) channels;
+    dec->inputBits = inputBits;
+    return DECIMATOR_SUCCESS;
+}
+
+/**
+ * @brief Pass the sample to the half-band stage: {-1, 0, 9, 16, 9, 0, -1} / 32, the output is taken on each second
+ * input sample
+ * @param delays is the delay line of the stage
+ * @param isOdd is True - the odd input sample (the output is computed)
+ * @param value is the input sample (the internal scale), the output on success
+ * @return True - the output is produced, otherwise - False
+ */
+static bool halfBandPush(int32_t *delays, bool isOdd, int32_t *value) {
+    for (size_t i = DECIMATOR_HALF_BAND_TAPS - 1; i > 0; --i)
+        delays[i] = delays[i - 1];
+    delays[0] = *value;
+
+    if (!isOdd)
+        return false;
+
+    int32_t sum = 16 * delays[3] + 9 * (delays[2] + delays[4]) - (delays[0] + delays[6]);
+    *value = roundShift(sum, DECIMATOR_HALF_BAND_SHIFT);
+    return true;
+}
+
+/**
+ * @brief Pass the sample of the channel through its decimation chain
+ * @param dec is the DecimatorDef data structure
+ * @param channel is the channel index
+ * @param sample is the input sample (inputBits)
+ * @return True - the new output is produced, otherwise - False
+ */
+bool DecimatorPush(DecimatorDef *dec, size_t channel, uint16_t sample) {
+    const DecimatorStagesDef *stages = &dec->stages[channel];
+    DecimatorChannelDef *state = &dec->state[channel];
+
+    // CIC: the integrators at the input rate, the combs at the output rate
+    uint32_t cic = sample;
+    for (size_t i = 0; i < DECIMATOR_CIC_ORDER; ++i) {
+        state->integrators[i] += cic;
+        cic = state->integrators[i];
+    }
+    if (++state->phase < (1U << stages->cicShift))
+        return false;
+    state->phase = 0;
+
+    for (size_t i = 0; i < DECIMATOR_CIC_ORDER; ++i) {
+        uint32_t diff = cic - state->combs[i];
+        state->combs[i] = cic;
+        cic = diff;
+    }
+
+    // the CIC gain (R^3) is removed by the shift, the scale is aligned to the internal full scale
+    int gainBits = dec->inputBits + DECIMATOR_CIC_ORDER * stages->cicShift;
+    int32_t value = roundShift((int32_t) cic, gainBits - DECIMATOR_INTERNAL_BITS);
+
+    for (size_t i = 0; i < stages->halfBands; ++i) {
+        bool isOdd = (state->halfBandPhases >> i) & 1U;
+        state->halfBandPhases ^= (uint8_t) (1U << i);
+        if (!halfBandPush(state->delays[i], isOdd, &value))
+            return false;
+    }
+
+    value = roundShift(value, DECIMATOR_GUARD_BITS);
+    if (value < 0)
+        value = 0;
+    else if (value > UINT16_MAX)
+        value = UINT16_MAX;
+
+    state->output = (uint16_t) value;
+    state->outputs++;
+    return true;
+}
+
+/**
+ * @brief Pass the block of the scans through the decimation chains
+ * @param dec is the DecimatorDef data structure
+ * @param samples is the block: scans of the channels samples (the channel order)
+ * @param scans is the number of scans
+ */
+void DecimatorProcess(DecimatorDef *dec, const uint16_t *samples, size_t scans) {
+    for (size_t i = 0; i < scans; ++i) {
+        for (size_t j = 0; j < dec->channels; ++j)
+            DecimatorPush(dec, j, *samples++);
+    }
+}
+
+/**
+ * @brief Get the last output of the channel
+ * @param dec is the DecimatorDef data structure
+ * @param channel is the channel index
+ * @return the output value (DECIMATOR_OUTPUT_BITS: 65535 - the input full scale)
+ */
+uint16_t DecimatorGetOutput(const DecimatorDef *dec, size_t channel) {
+    return dec->state[channel].output;
+}
+
+/**
+ * @brief Get the number of the produced outputs of the channel
+ * @param dec is the DecimatorDef data structure
+ * @param channel is the channel index
+ * @return the output counter, 0 - no output yet
+ */
+uint32_t DecimatorGetOutputs(const DecimatorDef *dec, size_t channel) {
+    return dec->state[channel].outputs;
+}
@@ -0,0 +1,472 @@
+#include <string.h>
+#include <stdbool.h>
+
+#include "Dsp.h"
+
+/**
+ * @brief Clip the value to the range
+ * @param value is the target value
+ * @param min is the lower limit
+ * @param max is the upper limit
+ * @return the clipped value
+ */
+static inline int32_t clip(int64_t value, int32_t min, int32_t max) {
+    return (value < min) ? min : (value > max) ? max : (int32_t) value;
+}
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+
+// the packed operations: two q1.15 samples per 32-bit word, [15:0] - the first one
+
+static inline uint32_t smlad(uint32_t x, uint32_t y, uint32_t acc) {
+    return __SMLAD(x, y, acc);
+}
+
+static inline int64_t smlald(uint32_t x, uint32_t y, int64_t acc) {
+    return (int64_t) __SMLALD(x, y, (uint64_t) acc);
+}
+
+static inline uint32_t qadd16(uint32_t x, uint32_t y) {
+    return __QADD16(x, y);
+}
+
+static inline int32_t qadd(int32_t x, int32_t y) {
+    return __QADD(x, y);
+}
+
+static inline int32_t ssat16(int32_t x) {
+    return __SSAT(x, 16);
+}
+
+// SSUB16 sets the GE flags of the lanes, where x >= y, SEL picks the lanes by them
+static inline uint32_t max16x2(uint32_t x, uint32_t y) {
+    (void) __SSUB16(x, y);
+    return __SEL(x, y);
+}
+
+static inline uint32_t min16x2(uint32_t x, uint32_t y) {
+    (void) __SSUB16(x, y);
+    return __SEL(y, x);
+}
+
+#else
+
+// the host build: the same packed operations in C (the wrap-around and the saturation of the instructions)
+
+static inline uint32_t smlad(uint32_t x, uint32_t y, uint32_t acc) {
+    int64_t sum = (int32_t) acc + (int32_t) (int16_t) x * (int16_t) y;
+    sum += (int32_t) (int16_t) (x >> 16) * (int16_t) (y >> 16);
+    return (uint32_t) sum;
+}
+
+static inline int64_t smlald(uint32_t x, uint32_t y, int64_t acc) {
+    return acc + (int32_t) (int16_t) x * (int16_t) y + (int32_t) (int16_t) (x >> 16) * (int16_t) (y >> 16);
+}
+
+static inline uint32_t qadd16(uint32_t x, uint32_t y) {
+    uint32_t low = (uint16_t) clip((int16_t) x + (int16_t) y, INT16_MIN, INT16_MAX);
+    uint32_t high = (uint16_t) clip((int16_t) (x >> 16) + (int16_t) (y >> 16), INT16_MIN, INT16_MAX);
+    return low | (high << 16);
+}
+
+static inline int32_t qadd(int32_t x, int32_t y) {
+    return clip((int64_t) x + y, INT32_MIN, INT32_MAX);
+}
+
+static inline int32_t ssat16(int32_t x) {
+    return clip(x, INT16_MIN, INT16_MAX);
+}
+
+static inline uint32_t max16x2(uint32_t x, uint32_t y) {
+    uint32_t low = ((int16_t) x >= (int16_t) y) ? x : y;
+    uint32_t high = ((int16_t) (x >> 16) >= (int16_t) (y >> 16)) ? x : y;
+    return (low & 0xFFFFU) | (high & 0xFFFF0000U);
+}
+
+static inline uint32_t min16x2(uint32_t x, uint32_t y) {
+    uint32_t low = ((int16_t) x >= (int16_t) y) ? y : x;
+    uint32_t high = ((int16_t) (x >> 16) >= (int16_t) (y >> 16)) ? y : x;
+    return (low & 0xFFFFU) | (high & 0xFFFF0000U);
+}
+
+#endif
+
+/**
+ * @brief Load two samples (the address can be unaligned, the Cortex-M4 reads them by one LDR)
+ * @param src is the first sample
+ * @return the packed samples
+ */
+static inline uint32_t load2(const int16_t *src) {
+    uint32_t value = 0;
+    memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Store two samples
+ * @param dst is the first sample
+ * @param value is the packed samples
+ */
+static inline void store2(int16_t *dst, uint32_t value) {
+    memcpy(dst, &value, sizeof(value));
+}
+
+// pack two samples to one word (PKHBT) and unpack them
+
+static inline uint32_t pack2(int32_t low, int32_t high) {
+    return (uint16_t) low | ((uint32_t) (uint16_t) high << 16);
+}
+
+static inline int16_t first(uint32_t value) {
+    return (int16_t) value;
+}
+
+static inline int16_t second(uint32_t value) {
+    return (int16_t) (value >> 16);
+}
+
+/**
+ * @brief Check the block
+ * @param src is the block
+ * @param size is the number of samples
+ * @return true - the block can be processed
+ */
+static bool isValid(const void *src, size_t size) {
+    return src != NULL && size != 0 && size <= DSP_MAX_SIZE;
+}
+
+/**
+ * @brief Calculate the integer square root
+ * @param value is the target value
+ * @return floor(sqrt(value))
+ */
+static uint32_t squareRoot(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * @brief Get RMS of the block by the sum of squares
+ * @param squares is the sum of squares (q2.30)
+ * @param size is the number of samples
+ * @return RMS (q1.15), 1.0 is clipped
+ */
+static int16_t toRms(int64_t squares, size_t size) {
+    uint32_t root = squareRoot((uint32_t) ((uint64_t) squares / size));
+    return (root > INT16_MAX) ? INT16_MAX : (int16_t) root;
+}
+
+/**
+ * @brief Scale and offset one sample: the product is shifted to q1.15, saturated, then the offset is added with
+ * the saturation
+ * @param value is the input sample (q1.15)
+ * @param scale is the gain (q1.15)
+ * @param shift is the extra gain 2^shift
+ * @param offset is added after the scaling (q1.15)
+ * @return the output sample (q1.15)
+ */
+static int16_t scaleSample(int16_t value, int16_t scale, uint8_t shift, int16_t offset) {
+    int32_t product = clip(((int32_t) value * scale) >> (DSP_MAX_SHIFT - shift), INT16_MIN, INT16_MAX);
+    return (int16_t) clip(product + offset, INT16_MIN, INT16_MAX);
+}
+
+/**
+ * @brief Round q1.31 to q1.15, the values near 1.0 are saturated
+ * @param value is the input sample (q1.31)
+ * @return the output sample (q1.15)
+ */
+static int16_t roundSample(int32_t value) {
+    return (int16_t) (clip((int64_t) value + (1 << 15), INT32_MIN, INT32_MAX) >> 16);
+}
+
+/**
+ * @brief Calculate the dot product of two blocks (SMLALD, two products per instruction)
+ * @param a is the first block (q1.15)
+ * @param b is the second block (q1.15)
+ * @param size is the number of samples
+ * @param result is the sum of products (q34.30)
+ * @return Dsp_Errors value
+ */
+int32_t DspDotQ15(const int16_t *a, const int16_t *b, size_t size, int64_t *result) {
+    if (!isValid(a, size) || b == NULL || result == NULL)
+        return DSP_WRONG_DATA;
+
+    int64_t acc = 0;
+    size_t i = 0;
+    for (; i + 1 < size; i += 2)
+        acc = smlald(load2(&a[i]), load2(&b[i]), acc);
+    if (i < size)
+        acc += (int32_t) a[i] * b[i];
+
+    *result = acc;
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Scale and offset the block: dst = sat(sat((src * scale) >> (15 - shift)) + offset), the offset is added
+ * to both samples by QADD16
+ * @param src is the input block (q1.15)
+ * @param dst is the output block (q1.15), it can be the input one
+ * @param size is the number of samples
+ * @param scale is the gain (q1.15)
+ * @param shift is the extra gain 2^shift (0 ... DSP_MAX_SHIFT)
+ * @param offset is added after the scaling (q1.15)
+ * @return Dsp_Errors value
+ */
+int32_t DspScaleOffsetQ15(const int16_t *src, int16_t *dst, size_t size, int16_t scale, uint8_t shift,
+                          int16_t offset) {
+    if (!isValid(src, size) || dst == NULL || shift > DSP_MAX_SHIFT)
+        return DSP_WRONG_DATA;
+
+    const uint32_t offsets = pack2(offset, offset);
+    const int rightShift = DSP_MAX_SHIFT - shift;
+    size_t i = 0;
+    for (; i + 1 < size; i += 2) {
+        uint32_t samples = load2(&src[i]);
+        int32_t low = ssat16(((int32_t) first(samples) * scale) >> rightShift);
+        int32_t high = ssat16(((int32_t) second(samples) * scale) >> rightShift);
+        store2(&dst[i], qadd16(pack2(low, high), offsets));
+    }
+    if (i < size)
+        dst[i] = scaleSample(src[i], scale, shift, offset);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Get the minimum, the maximum and the mean of the block: both lanes are tracked by SSUB16/SEL, the sum is
+ * accumulated by SMLAD (the samples are multiplied by 1)
+ * @param src is the block (q1.15)
+ * @param size is the number of samples
+ * @param stats is the result
+ * @return Dsp_Errors value
+ */
+int32_t DspStatsQ15(const int16_t *src, size_t size, DspStatsDef *stats) {
+    if (!isValid(src, size) || stats == NULL)
+        return DSP_WRONG_DATA;
+
+    const uint32_t ones = pack2(1, 1);
+    uint32_t mins = pack2(INT16_MAX, INT16_MAX);
+    uint32_t maxs = pack2(INT16_MIN, INT16_MIN);
+    uint32_t sum = 0;
+    size_t i = 0;
+    for (; i + 1 < size; i += 2) {
+        uint32_t samples = load2(&src[i]);
+        sum = smlad(samples, ones, sum);
+        mins = min16x2(samples, mins);
+        maxs = max16x2(samples, maxs);
+    }
+
+    int16_t min = (first(mins) < second(mins)) ? first(mins) : second(mins);
+    int16_t max = (first(maxs) > second(maxs)) ? first(maxs) : second(maxs);
+    if (i < size) {
+        sum += (uint32_t) (int32_t) src[i];
+        if (src[i] < min)
+            min = src[i];
+        if (src[i] > max)
+            max = src[i];
+    }
+
+    stats->min = min;
+    stats->max = max;
+    stats->mean = (int16_t) ((int32_t) sum / (int32_t) size);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Get RMS of the block: the squares are accumulated by SMLALD
+ * @param src is the block (q1.15)
+ * @param size is the number of samples
+ * @param rms is the result (q1.15), 1.0 is clipped
+ * @return Dsp_Errors value
+ */
+int32_t DspRmsQ15(const int16_t *src, size_t size, int16_t *rms) {
+    if (!isValid(src, size) || rms == NULL)
+        return DSP_WRONG_DATA;
+
+    int64_t acc = 0;
+    size_t i = 0;
+    for (; i + 1 < size; i += 2) {
+        uint32_t samples = load2(&src[i]);
+        acc = smlald(samples, samples, acc);
+    }
+    if (i < size)
+        acc += (int32_t) src[i] * src[i];
+
+    *rms = toRms(acc, size);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Convert q1.15 to q1.31 (two samples per load)
+ * @param src is the input block (q1.15)
+ * @param dst is the output block (q1.31)
+ * @param size is the number of samples
+ * @return Dsp_Errors value
+ */
+int32_t DspQ15ToQ31(const int16_t *src, int32_t *dst, size_t size) {
+    if (!isValid(src, size) || dst == NULL)
+        return DSP_WRONG_DATA;
+
+    size_t i = 0;
+    for (; i + 1 < size; i += 2) {
+        uint32_t samples = load2(&src[i]);
+        dst[i] = (int32_t) (samples << 16);
+        dst[i + 1] = (int32_t) (samples & 0xFFFF0000U);
+    }
+    if (i < size)
+        dst[i] = src[i] * (1 << 16);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Convert q1.31 to q1.15: rounded by QADD (saturated near 1.0), two samples are packed by PKHTB
+ * @param src is the input block (q1.31)
+ * @param dst is the output block (q1.15)
+ * @param size is the number of samples
+ * @return Dsp_Errors value
+ */
+int32_t DspQ31ToQ15(const int32_t *src, int16_t *dst, size_t size) {
+    if (!isValid(src, size) || dst == NULL)
+        return DSP_WRONG_DATA;
+
+    size_t i = 0;
+    for (; i + 1 < size; i += 2) {
+        uint32_t low = (uint32_t) qadd(src[i], 1 << 15);
+        uint32_t high = (uint32_t) qadd(src[i + 1], 1 << 15);
+        store2(&dst[i], (high & 0xFFFF0000U) | (low >> 16));
+    }
+    if (i < size)
+        dst[i] = roundSample(src[i]);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Calculate the dot product of two blocks (the portable version of DspDotQ15)
+ * @param a is the first block (q1.15)
+ * @param b is the second block (q1.15)
+ * @param size is the number of samples
+ * @param result is the sum of products (q34.30)
+ * @return Dsp_Errors value
+ */
+int32_t DspDotQ15Reference(const int16_t *a, const int16_t *b, size_t size, int64_t *result) {
+    if (!isValid(a, size) || b == NULL || result == NULL)
+        return DSP_WRONG_DATA;
+
+    int64_t acc = 0;
+    for (size_t i = 0; i < size; ++i)
+        acc += (int32_t) a[i] * b[i];
+
+    *result = acc;
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Scale and offset the block (the portable version of DspScaleOffsetQ15)
+ * @param src is the input block (q1.15)
+ * @param dst is the output block (q1.15), it can be the input one
+ * @param size is the number of samples
+ * @param scale is the gain (q1.15)
+ * @param shift is the extra gain 2^shift (0 ... DSP_MAX_SHIFT)
+ * @param offset is added after the scaling (q1.15)
+ * @return Dsp_Errors value
+ */
+int32_t DspScaleOffsetQ15Reference(const int16_t *src, int16_t *dst, size_t size, int16_t scale, uint8_t shift,
+                                   int16_t offset) {
+    if (!isValid(src, size) || dst == NULL || shift > DSP_MAX_SHIFT)
+        return DSP_WRONG_DATA;
+
+    for (size_t i = 0; i < size; ++i)
+        dst[i] = scaleSample(src[i], scale, shift, offset);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Get the minimum, the maximum and the mean of the block (the portable version of DspStatsQ15)
+ * @param src is the block (q1.15)
+ * @param size is the number of samples
+ * @param stats is the result
+ * @return Dsp_Errors value
+ */
+int32_t DspStatsQ15Reference(const int16_t *src, size_t size, DspStatsDef *stats) {
+    if (!isValid(src, size) || stats == NULL)
+        return DSP_WRONG_DATA;
+
+    int32_t sum = 0;
+    stats->min = INT16_MAX;
+    stats->max = INT16_MIN;
+    for (size_t i = 0; i < size; ++i) {
+        sum += src[i];
+        if (src[i] < stats->min)
+            stats->min = src[i];
+        if (src[i] > stats->max)
+            stats->max = src[i];
+    }
+
+    stats->mean = (int16_t) (sum / (int32_t) size);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Get RMS of the block (the portable version of DspRmsQ15)
+ * @param src is the block (q1.15)
+ * @param size is the number of samples
+ * @param rms is the result (q1.15), 1.0 is clipped
+ * @return Dsp_Errors value
+ */
+int32_t DspRmsQ15Reference(const int16_t *src, size_t size, int16_t *rms) {
+    if (!isValid(src, size) || rms == NULL)
+        return DSP_WRONG_DATA;
+
+    int64_t acc = 0;
+    for (size_t i = 0; i < size; ++i)
+        acc += (int32_t) src[i] * src[i];
+
+    *rms = toRms(acc, size);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Convert q1.15 to q1.31 (the portable version of DspQ15ToQ31)
+ * @param src is the input block (q1.15)
+ * @param dst is the output block (q1.31)
+ * @param size is the number of samples
+ * @return Dsp_Errors value
+ */
+int32_t DspQ15ToQ31Reference(const int16_t *src, int32_t *dst, size_t size) {
+    if (!isValid(src, size) || dst == NULL)
+        return DSP_WRONG_DATA;
+
+    for (size_t i = 0; i < size; ++i)
+        dst[i] = src[i] * (1 << 16);
+    return DSP_SUCCESS;
+}
+
+/**
+ * @brief Convert q1.31 to q1.15 (the portable version of DspQ31ToQ15)
+ * @param src is the input block (q1.31)
+ * @param dst is the output block (q1.15)
+ * @param size is the number of samples
+ * @return Dsp_Errors value
+ */
+int32_t DspQ31ToQ15Reference(const int32_t *src, int16_t *dst, size_t size) {
+    if (!isValid(src, size) || dst == NULL)
+        return DSP_WRONG_DATA;
+
+    for (size_t i = 0; i < size; ++i)
+        dst[i] = roundSample(src[i]);
+    return DSP_SUCCESS;
+}
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "DspBenchJob.h"
+#include "cycles.h"
+
+enum DspBench_Tests {
+    DSP_TEST_DOT = 0,
+    DSP_TEST_SCALE_OFFSET,
+    DSP_TEST_STATS,
+    DSP_TEST_RMS,
+    DSP_TEST_Q15_TO_Q31,
+    DSP_TEST_Q31_TO_Q15,
+    DSP_NUMBER_TESTS,
+};
+
+static const char *const names[DSP_NUMBER_TESTS] = {"dot", "scale_offset", "stats", "rms", "q15_to_q31",
+                                                    "q31_to_q15"};
+
+// the scaling drives a part of the samples into the saturation: x * 0.75 * 4 - 0.25
+static const int16_t scale = 0x6000;
+static const uint8_t shift = 2;
+static const int16_t offset = -0x2000;
+
+_Static_assert((int) DSP_NUMBER_TESTS <= (int) DSP_BENCH_MAX_TESTS, "DSP_BENCH_MAX_TESTS is too small");
+
+/**
+ * @brief Get the next pseudo-random value (LCG)
+ * @param bench is the DspBench data structure
+ * @return the value
+ */
+static uint32_t getRandom(DspBenchDef *bench) {
+    bench->seed = bench->seed * 1664525U + 1013904223U;
+    return bench->seed;
+}
+
+/**
+ * @brief Fill the inputs: pseudo-random samples, every 16th one is the full scale (the saturation paths)
+ * @param bench is the DspBench data structure
+ */
+static void fillInputs(DspBenchDef *bench) {
+    for (size_t i = 0; i < DSP_BENCH_BLOCK; ++i) {
+        bench->a[i] = (int16_t) (getRandom(bench) >> 16);
+        bench->b[i] = (int16_t) (getRandom(bench) >> 16);
+        bench->wide[i] = (int32_t) getRandom(bench);
+        if (i % 16 == 0) {
+            bench->a[i] = (i % 32) ? INT16_MAX : INT16_MIN;
+            bench->wide[i] = (i % 32) ? INT32_MAX : INT32_MIN;
+        }
+    }
+}
+
+/**
+ * @brief Call the kernel of the test
+ * @param bench is the DspBench data structure
+ * @param test is DspBench_Tests value
+ * @param isReference is True - the portable kernel, False - the packed one
+ * @param output is the results
+ * @return the elapsed cycles (the call only)
+ */
+static uint32_t callKernel(DspBenchDef *bench, size_t test, bool isReference, DspBenchOutputDef *output) {
+    uint32_t start = getCycleCounter();
+
+    switch (test) {
+        case DSP_TEST_DOT:
+            if (isReference) {
+                DspDotQ15Reference(bench->a, bench->b, DSP_BENCH_BLOCK, &output->dot);
+            } else {
+                DspDotQ15(bench->a, bench->b, DSP_BENCH_BLOCK, &output->dot);
+            }
+            break;
+        case DSP_TEST_SCALE_OFFSET:
+            if (isReference) {
+                DspScaleOffsetQ15Reference(bench->a, output->samples, DSP_BENCH_BLOCK, scale, shift, offset);
+            } else {
+                DspScaleOffsetQ15(bench->a, output->samples, DSP_BENCH_BLOCK, scale, shift, offset);
+            }
+            break;
+        case DSP_TEST_STATS:
+            if (isReference) {
+                DspStatsQ15Reference(bench->a, DSP_BENCH_BLOCK, &output->stats);
+            } else {
+                DspStatsQ15(bench->a, DSP_BENCH_BLOCK, &output->stats);
+            }
+            break;
+        case DSP_TEST_RMS:
+            if (isReference) {
+                DspRmsQ15Reference(bench->a, DSP_BENCH_BLOCK, &output->rms);
+            } else {
+                DspRmsQ15(bench->a, DSP_BENCH_BLOCK, &output->rms);
+            }
+            break;
+        case DSP_TEST_Q15_TO_Q31:
+            if (isReference) {
+                DspQ15ToQ31Reference(bench->a, output->wide, DSP_BENCH_BLOCK);
+            } else {
+                DspQ15ToQ31(bench->a, output->wide, DSP_BENCH_BLOCK);
+            }
+            break;
+        case DSP_TEST_Q31_TO_Q15:
+            if (isReference) {
+                DspQ31ToQ15Reference(bench->wide, output->samples, DSP_BENCH_BLOCK);
+            } else {
+                DspQ31ToQ15(bench->wide, output->samples, DSP_BENCH_BLOCK);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return getCycleCounter() - start;
+}
+
+/**
+ * @brief Run both kernels of the test on the same inputs, compare the results
+ * @param bench is the DspBench data structure
+ * @param test is DspBench_Tests value
+ * @param result is the test statistics
+ */
+static void runTest(DspBenchDef *bench, size_t test, DspBenchResultDef *result) {
+    memset(result, 0, sizeof(DspBenchResultDef));
+
+    for (size_t i = 0; i < DSP_BENCH_REPEATS; ++i) {
+        // the unused fields are equal, so the outputs are compared completely
+        memset(bench->outputs, 0, sizeof(bench->outputs));
+        result->simdCycles += callKernel(bench, test, false, &bench->outputs[0]);
+        result->referenceCycles += callKernel(bench, test, true, &bench->outputs[1]);
+
+        if (memcmp(&bench->outputs[0], &bench->outputs[1], sizeof(DspBenchOutputDef)) != 0)
+            result->mismatches++;
+    }
+}
+
+/**
+ * @brief Send one line of the report via the serial port
+ * @param bench is the DspBench data structure
+ * @param size is the line size (snprintf result)
+ */
+static void sendLine(DspBenchDef *bench, int size) {
+    if (size <= 0)
+        return;
+
+    if (size >= DSP_BENCH_LINE_SIZE)
+        size = DSP_BENCH_LINE_SIZE - 1;
+    SerialWriteData(bench->port, bench->line, (size_t) size);
+}
+
+/**
+ * @brief Send the report: JSON lines, the suite description and one line per test
+ * @param bench is the DspBench data structure
+ */
+static void sendReport(DspBenchDef *bench) {
+    int size = snprintf(bench->line, DSP_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"suite\":\"dsp\",\"clock_hz\":%" PRIu32
+                        ",\"block\":%d,\"repeats\":%d}\n",
+                        bench->run, getCycleFrequency(), DSP_BENCH_BLOCK, DSP_BENCH_REPEATS);
+    sendLine(bench, size);
+
+    for (size_t i = 0; i < DSP_NUMBER_TESTS; ++i) {
+        const DspBenchResultDef *result = &bench->tests[i];
+
+        size = snprintf(bench->line, DSP_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"test\":\"%s\",\"simd_per_block\":%" PRIu32
+                        ",\"reference_per_block\":%" PRIu32 ",\"mismatches\":%" PRIu32 "}\n",
+                        bench->run, names[i], result->simdCycles / DSP_BENCH_REPEATS,
+                        result->referenceCycles / DSP_BENCH_REPEATS, result->mismatches);
+        sendLine(bench, size);
+    }
+}
+
+/**
+ * @brief DSP benchmark task, it runs the packed and the portable kernels on the same blocks and reports the time
+ * @param arg is the function argument to which the scheduler will send the specified parameter
+ * (while creating the task - DspBench data structure)
+ */
+static void DspBenchJob(void *arg) {
+    DspBenchDef *bench = (DspBenchDef *) arg;
+
+    const TickType_t delay = pdMS_TO_TICKS(DSP_BENCH_PERIOD_MS);
+    initCycleCounter();
+
+    while (1) {
+        vTaskDelay(delay);
+
+        bench->run++;
+        fillInputs(bench);
+        for (size_t i = 0; i < DSP_NUMBER_TESTS; ++i)
+            runTest(bench, i, &bench->tests[i]);
+
+        sendReport(bench);
+    }
+}
+
+/**
+ * @brief Create the DSP benchmark task
+ * @param bench is the DspBench data structure
+ * @param port is the SerialPort data structure (output)
+ * @param priorityLevel is the priority of the benchmark task
+ * @return pointer to the benchmark task handle
+ */
+TaskHandle_t DspBenchJobInit(DspBenchDef *bench, SerialPortDef *port, uint8_t priorityLevel) {
+    if (bench == NULL || port == NULL)
+        return NULL;
+
+    bench->port = port;
+    bench->run = 0;
+    bench->seed = 1;
+    memset(bench->tests, 0, sizeof(bench->tests));
+
+    TaskHandle_t task = xTaskCreateStatic(DspBenchJob, "dspBench", configMINIMAL_STACK_SIZE * 2, bench,
+                                          priorityLevel, bench->taskStack, &bench->taskTCB);
+    return task;
+}
@@ -0,0 +1,170 @@
+#include <string.h>
+
+#include "Filter.h"
+#include "cycles.h"
+
+/**
+ * @brief Convert the accumulator to the output sample as the FMAC does it: the 26-bit accumulator wraps around,
+ * the output gain is applied, the result is truncated to q1.15 and clipped
+ * @param acc is the accumulator (q3.22)
+ * @param shift is the output gain 2^shift
+ * @return the output sample (q1.15)
+ */
+static int16_t toOutput(int32_t acc, uint8_t shift) {
+    const int wrap = 32 - FILTER_ACCUMULATOR_BITS;
+    acc = (int32_t) ((uint32_t) acc << wrap) >> wrap;
+
+    int64_t value = ((int64_t) acc * (1 << shift)) >> FILTER_OUTPUT_SHIFT;
+    if (value > INT16_MAX)
+        return INT16_MAX;
+    if (value < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t) value;
+}
+
+/**
+ * @brief Filter the block by the software engine: the reference model of the FMAC datapath, the results are
+ * identical to the FMAC ones. The state is kept between the blocks
+ * @param filter is the FilterDef data structure
+ * @param input is the input block (q1.15)
+ * @param output is the output block (q1.15), it can be the input one
+ * @param size is the number of samples
+ */
+void FilterSoftware(FilterDef *filter, const int16_t *input, int16_t *output, size_t size) {
+    const FilterConfigDef *config = &filter->config;
+
+    for (size_t i = 0; i < size; ++i) {
+        memmove(&filter->inputs[1], &filter->inputs[0], (config->taps - 1U) * sizeof(int16_t));
+        filter->inputs[0] = input[i];
+
+        int32_t acc = 0;
+        for (size_t k = 0; k < config->taps; ++k)
+            acc += ((int32_t) config->b[k] * filter->inputs[k]) >> FILTER_PRODUCT_SHIFT;
+        if (config->type == FILTER_BIQUAD) {
+            for (size_t k = 0; k < FILTER_BIQUAD_FEEDBACK; ++k)
+                acc += ((int32_t) config->a[k] * filter->outputs[k]) >> FILTER_PRODUCT_SHIFT;
+        }
+
+        int16_t value = toOutput(acc, config->shift);
+        filter->outputs[1] = filter->outputs[0];
+        filter->outputs[0] = value;
+        output[i] = value;
+    }
+}
+
+/**
+ * @brief Initialize the filter, the FMAC is configured if it is given
+ * @param filter is the FilterDef data structure
+ * @param config is the filter settings
+ * @param handle is the FMAC handle (HAL), NULL - the software engine
+ * @return Filter_Errors value, the software engine is kept on FILTER_HW_ERROR
+ */
+int32_t FilterInit(FilterDef *filter, const FilterConfigDef *config, void *handle) {
+    if (config->b == NULL || config->shift > FILTER_MAX_SHIFT)
+        return FILTER_WRONG_DATA;
+    if (config->type == FILTER_FIR && (config->taps < 2 || config->taps > FILTER_MAX_TAPS))
+        return FILTER_WRONG_DATA;
+    if (config->type == FILTER_BIQUAD && (config->taps != FILTER_BIQUAD_TAPS || config->a == NULL))
+        return FILTER_WRONG_DATA;
+    if (config->type > FILTER_BIQUAD)
+        return FILTER_WRONG_DATA;
+
+    memset(filter, 0, sizeof(FilterDef));
+    filter->config = *config;
+    filter->done = xSemaphoreCreateBinaryStatic(&filter->doneBuffer);
+
+    if (handle == NULL)
+        return FILTER_SUCCESS;
+
+    filter->handle = handle;
+    if (Filter_configHardware(filter) != FILTER_SUCCESS) {
+        filter->handle = NULL;
+        return FILTER_HW_ERROR;
+    }
+    return FILTER_SUCCESS;
+}
+
+/**
+ * @brief Add the consumer of the filtered blocks
+ * @param filter is the FilterDef data structure
+ * @param callback is the consumer function
+ * @param arg is the consumer argument
+ * @return Filter_Errors value
+ */
+int32_t FilterAddConsumer(FilterDef *filter, FilterFun_output callback, void *arg) {
+    if (callback == NULL || filter->numConsumers >= FILTER_MAX_CONSUMERS)
+        return FILTER_WRONG_DATA;
+
+    filter->consumers[filter->numConsumers].callback = callback;
+    filter->consumers[filter->numConsumers].arg = arg;
+    filter->numConsumers++;
+    return FILTER_SUCCESS;
+}
+
+/**
+ * @brief Get the input block buffer, the caller fills it before FilterProcess (no extra copy)
+ * @param filter is the FilterDef data structure
+ * @return the input buffer (FILTER_MAX_BLOCK samples, q1.15)
+ */
+int16_t *FilterGetInput(FilterDef *filter) {
+    return filter->input;
+}
+
+/**
+ * @brief Filter the input block and deliver the result to the consumers. The FMAC streams the block by DMA, the
+ * caller sleeps until the output is ready
+ * @param filter is the FilterDef data structure
+ * @param size is the number of the input samples (FilterGetInput)
+ * @return Filter_Errors value
+ */
+int32_t FilterProcess(FilterDef *filter, size_t size) {
+    if (size == 0 || size > FILTER_MAX_BLOCK)
+        return FILTER_WRONG_DATA;
+
+    uint32_t start = getCycleCounter();
+    int32_t status = FILTER_SUCCESS;
+
+    if (filter->handle == NULL) {
+        FilterSoftware(filter, filter->input, filter->output, size);
+    } else {
+        xSemaphoreTake(filter->done, 0);
+        status = Filter_startHardware(filter, size);
+    }
+    uint32_t cycles = getCycleCounter() - start;
+
+    if (status == FILTER_SUCCESS && filter->handle != NULL) {
+        if (xSemaphoreTake(filter->done, pdMS_TO_TICKS(FILTER_TIMEOUT_MS)) == pdTRUE) {
+            status = filter->status;
+        } else {
+            status = FILTER_TIMEOUT;
+        }
+    }
+
+    if (status != FILTER_SUCCESS) {
+        // the FMAC state is lost, the next block starts from the zero history
+        if (filter->handle != NULL)
+            Filter_stopHardware(filter);
+        filter->errors++;
+        return status;
+    }
+
+    filter->blocks++;
+    filter->cycles += cycles;
+    if (cycles > filter->maxCycles)
+        filter->maxCycles = cycles;
+
+    for (size_t i = 0; i < filter->numConsumers; ++i)
+        filter->consumers[i].callback(filter->output, size, filter->consumers[i].arg);
+    return FILTER_SUCCESS;
+}
+
+/**
+ * @brief Complete the FMAC block (the output DMA interrupt)
+ * @param filter is the FilterDef data structure
+ * @param status is Filter_Errors value
+ * @param priorityTaskWoken is set to pdTRUE, if the waiting task has to run
+ */
+void FilterCompleteFromISR(FilterDef *filter, int32_t status, BaseType_t *priorityTaskWoken) {
+    filter->status = status;
+    xSemaphoreGiveFromISR(filter->done, priorityTaskWoken);
+}
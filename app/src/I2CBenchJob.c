@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <inttypes.h>
+
+#include "I2CBenchJob.h"
+#include "settings.h"
+#include "cycles.h"
+
+typedef struct {
+    const char *name;
+    uint32_t size; // bytes per transaction
+} I2CBenchTestDef;
+
+// the EEPROM is read completely: many short transactions or a few reloaded ones (one Start per block)
+static const I2CBenchTestDef tests[] = {
+    {"chunked", I2C_BENCH_CHUNK_SIZE},
+    {"reload", I2C_BENCH_BLOCK_SIZE},
+};
+
+#define I2C_BENCH_NUMBER_TESTS (sizeof(tests) / sizeof(tests[0]))
+
+_Static_assert(I2C_BENCH_NUMBER_TESTS <= I2C_BENCH_MAX_TESTS, "I2C_BENCH_MAX_TESTS is too small");
+_Static_assert(I2C_BENCH_DEVICE_SIZE % I2C_BENCH_BLOCK_SIZE == 0, "the blocks must cover the device");
+
+/**
+ * @brief Get the SCL periods of the memory read: Start, address + 2 pointer bytes, repeated Start, address + data, Stop
+ * @param size is the read data size (bytes)
+ * @return SCL periods
+ */
+static uint32_t getBusBits(uint32_t size) {
+    return 3 + 9 * (4 + size);
+}
+
+/**
+ * @brief Read the whole memory by the transactions of the test size
+ * @param bench is the I2CBench data structure
+ * @param test is the test description
+ * @param result is the test statistics
+ */
+static void runTest(I2CBenchDef *bench, const I2CBenchTestDef *test, I2CBenchResultDef *result) {
+    const TickType_t timeout = pdMS_TO_TICKS(I2C_BENCH_TIMEOUT_MS);
+    uint32_t notificationValue = 0;
+    uint32_t reloads = bench->bus->i2c->reload.reloads;
+
+    memset(result, 0, sizeof(I2CBenchResultDef));
+    uint32_t start = getCycleCounter();
+
+    for (uint32_t offset = 0; offset < I2C_BENCH_DEVICE_SIZE; offset += test->size) {
+        bench->pointer[0] = (uint8_t) (offset >> 8);
+        bench->pointer[1] = (uint8_t) offset;
+        if (I2C_writeReadData(bench->bus, &bench->request, I2C_BENCH_DEVICE_ADDRESS, bench->pointer,
+                              sizeof(bench->pointer), bench->buffer, test->size) != I2C_SUCCESS) {
+            result->errors++;
+            continue;
+        }
+
+        if (xTaskNotifyWait(0, ULONG_MAX, &notificationValue, timeout) != pdTRUE) {
+            // the request is still owned by the bus
+            result->errors++;
+            break;
+        }
+
+        if (I2C_getStatus(&bench->request) != I2C_SUCCESS) {
+            result->errors++;
+            continue;
+        }
+
+        result->transactions++;
+        result->busBits += getBusBits(test->size);
+    }
+
+    result->cycles = getCycleCounter() - start;
+    result->reloads = bench->bus->i2c->reload.reloads - reloads;
+}
+
+/**
+ * @brief Send one line of the report via the serial port
+ * @param bench is the I2CBench data structure
+ * @param size is the line size (snprintf result)
+ */
+static void sendLine(I2CBenchDef *bench, int size) {
+    if (size <= 0)
+        return;
+
+    if (size >= I2C_BENCH_LINE_SIZE)
+        size = I2C_BENCH_LINE_SIZE - 1;
+    SerialWriteData(bench->port, bench->line, (size_t) size);
+}
+
+/**
+ * @brief Send the report: JSON lines, the suite description and one line per test
+ * @param bench is the I2CBench data structure
+ */
+static void sendReport(I2CBenchDef *bench) {
+    uint32_t clock = getCycleFrequency();
+    int size = snprintf(bench->line, I2C_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"suite\":\"i2c\",\"clock_hz\":%" PRIu32 ",\"bus_hz\":%" PRIu32
+                        ",\"device_bytes\":%d}\n",
+                        bench->run, clock, (uint32_t) SETTING_I2C_SPEED_HZ, I2C_BENCH_DEVICE_SIZE);
+    sendLine(bench, size);
+
+    for (size_t i = 0; i < I2C_BENCH_NUMBER_TESTS; ++i) {
+        const I2CBenchResultDef *result = &bench->results[i];
+        uint64_t bytes = (uint64_t) result->transactions * tests[i].size;
+        uint32_t rate = (result->cycles) ? (uint32_t) (bytes * clock / result->cycles) : 0;
+
+        size = snprintf(bench->line, I2C_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"test\":\"%s\",\"size\":%" PRIu32 ",\"transactions\":%" PRIu32
+                        ",\"errors\":%" PRIu32 ",\"reloads\":%" PRIu32 ",\"cycles\":%" PRIu32
+                        ",\"bus_bits\":%" PRIu32 ",\"bytes_per_s\":%" PRIu32 "}\n",
+                        bench->run, tests[i].name, tests[i].size, result->transactions, result->errors,
+                        result->reloads, result->cycles, result->busBits, rate);
+        sendLine(bench, size);
+    }
+}
+
+/**
+ * @brief I2C benchmark task, it reads the EEPROM by the short and the reloaded transactions and reports the time
+ * @param arg is the function argument to which the scheduler will send the specified parameter
+ * (while creating the task - I2CBench data structure)
+ */
+static void I2CBenchJob(void *arg) {
+    I2CBenchDef *bench = (I2CBenchDef *) arg;
+
+    const TickType_t delay = pdMS_TO_TICKS(I2C_BENCH_PERIOD_MS);
+    initCycleCounter();
+    I2C_setNotification(&bench->request, xTaskGetCurrentTaskHandle(), I2C_BENCH_NOTIF_FLAG);
+
+    while (1) {
+        vTaskDelay(delay);
+
+        bench->run++;
+        for (size_t i = 0; i < I2C_BENCH_NUMBER_TESTS; ++i)
+            runTest(bench, &tests[i], &bench->results[i]);
+
+        sendReport(bench);
+    }
+}
+
+/**
+ * @brief Create the I2C benchmark task
+ * @param bench is the I2CBench data structure
+ * @param port is the SerialPort data structure (output)
+ * @param bus is the I2C bus of the EEPROM (its task must have a higher priority)
+ * @param priorityLevel is the priority of the benchmark task
+ * @return pointer to the benchmark task handle
+ */
+TaskHandle_t I2CBenchJobInit(I2CBenchDef *bench, SerialPortDef *port, I2CBusDef *bus, uint8_t priorityLevel) {
+    if (bench == NULL || port == NULL || bus == NULL)
+        return NULL;
+
+    bench->port = port;
+    bench->bus = bus;
+    bench->run = 0;
+    memset(&bench->request, 0, sizeof(I2CRequestDef));
+    memset(bench->results, 0, sizeof(bench->results));
+
+    TaskHandle_t task = xTaskCreateStatic(I2CBenchJob, "i2cBench", configMINIMAL_STACK_SIZE * 2, bench,
+                                          priorityLevel, bench->taskStack, &bench->taskTCB);
+    return task;
+}
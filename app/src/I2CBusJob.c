@@ -2,56 +2,395 @@
 #include <limits.h>
 
 #include "I2CBusJob.h"
+#include "cycles.h"
+#include "settings.h"
 
-static StaticSemaphore_t mutexCB;
-static StaticEventGroup_t eventGroupCB;
-static StaticQueue_t queueCB;
-static uint8_t queueStorage[I2CBUS_QUEUE_SIZE * sizeof(I2CPackageDef)];
-static StaticTask_t taskCB;
-static StackType_t taskStack[configMINIMAL_STACK_SIZE];
+/**
+ * @brief Start the first phase of the current request
+ * @param bus is the I2CBusDef data structure
+ * @return I2C_Errors value
+ */
+static int32_t I2C_startTransaction(I2CBusDef *bus) {
+    const I2CTransactionDef *trans = &bus->active->trans;
+
+    bus->startTime = getCycleCounter();
+    if (trans->txSize == 0)
+        return bus->i2c->readData(bus->i2c, trans->address, trans->rxData, trans->rxSize);
+
+    // the write phase of the write-then-read transaction ends without Stop (repeated start)
+    return bus->i2c->sendData(bus->i2c, trans->address, trans->txData, trans->txSize,
+                              trans->rxSize == 0 && trans->isNeedStop);
+}
+
+/**
+ * @brief Get the completion target of the request (the one, that is woken up)
+ * @param request is the I2CRequestDef data structure
+ * @return the task, the callback argument (or the request), the semaphore; NULL - the owner polls the request
+ */
+static const void *I2C_getClient(const I2CRequestDef *request) {
+    switch (request->completion) {
+        case I2C_COMPLETION_NOTIFY:
+            return request->task;
+        case I2C_COMPLETION_CALLBACK:
+            return (request->arg) ? request->arg : request;
+        case I2C_COMPLETION_SEMAPHORE:
+            return request->semaphore;
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Remember the completion target of the request (the wakeup statistics)
+ * @param bus is the I2CBusDef data structure
+ * @param request is the submitted request
+ */
+static void I2C_addClient(I2CBusDef *bus, const I2CRequestDef *request) {
+    const void *client = I2C_getClient(request);
+    if (client == NULL)
+        return;
+
+    taskENTER_CRITICAL();
+    size_t i = 0;
+    while (i < bus->numClients && bus->clients[i] != client)
+        ++i;
+    if (i == bus->numClients && i < I2CBUS_MAX_CLIENTS)
+        bus->clients[bus->numClients++] = client;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Save the request result and deliver the completion to its owner only (call it by the engine owner:
+ * the interrupt or the task while isBusy is set)
+ * @param bus is the I2CBusDef data structure
+ * @param request is the completed request
+ * @param status is I2C_Errors value
+ * @param priorityTaskWoken is set to pdTRUE, if a task has to run (the interrupt context); NULL - the task context:
+ * the task API is used, the callback runs with the interrupts masked (its FromISR calls are valid there)
+ */
+static void I2C_finishRequest(I2CBusDef *bus, I2CRequestDef *request, int32_t status,
+                              BaseType_t *priorityTaskWoken) {
+    request->status = status;
+    request->isWriting = request->isReading = false;
+
+    // the bus task and the other clients aren't woken up (the estimate: all registered clients are assumed waiting)
+    uint32_t others = bus->numClients;
+    if (others && I2C_getClient(request))
+        others--;
+    bus->completions++;
+    bus->estimatedWakeups += others + 1;
+
+    if (priorityTaskWoken == NULL) {
+        BaseType_t callbackTaskWoken = pdFALSE;
+        switch (request->completion) {
+            case I2C_COMPLETION_NOTIFY:
+                xTaskNotify(request->task, request->notification, eSetBits);
+                break;
+            case I2C_COMPLETION_CALLBACK:
+                taskENTER_CRITICAL();
+                request->callback(request, &callbackTaskWoken);
+                taskEXIT_CRITICAL();
+                if (callbackTaskWoken)
+                    taskYIELD();
+                break;
+            case I2C_COMPLETION_SEMAPHORE:
+                xSemaphoreGive(request->semaphore);
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+
+    switch (request->completion) {
+        case I2C_COMPLETION_NOTIFY:
+            xTaskNotifyFromISR(request->task, request->notification, eSetBits, priorityTaskWoken);
+            break;
+        case I2C_COMPLETION_CALLBACK:
+            request->callback(request, priorityTaskWoken);
+            break;
+        case I2C_COMPLETION_SEMAPHORE:
+            xSemaphoreGiveFromISR(request->semaphore, priorityTaskWoken);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Find the circuit breaker of the device
+ * @param bus is the I2CBusDef data structure
+ * @param address is the device address
+ * @param isNew flag, True - take a free entry, if the device has no breaker yet
+ * @return the breaker or NULL
+ */
+static I2CBreakerDef *I2C_getBreaker(I2CBusDef *bus, uint16_t address, bool isNew) {
+    I2CBreakerDef *freeBreaker = NULL;
+
+    for (size_t i = 0; i < I2CBUS_MAX_DEVICES; ++i) {
+        I2CBreakerDef *breaker = &bus->breakers[i];
+        if (breaker->failures && breaker->address == address)
+            return breaker;
+        if (breaker->failures == 0 && freeBreaker == NULL)
+            freeBreaker = breaker;
+    }
+
+    if (!isNew || freeBreaker == NULL)
+        return NULL;
+
+    freeBreaker->address = address;
+    freeBreaker->level = 0;
+    freeBreaker->isProbing = false;
+    return freeBreaker;
+}
+
+/**
+ * @brief Check, that the requests to the device are blocked by its circuit breaker; the first request after the
+ * back-off is let through as the probe (half-open state), call it in the critical section
+ * @param bus is the I2CBusDef data structure
+ * @param address is the device address
+ * @return True - the breaker is open or its probe is pending, otherwise - False
+ */
+static bool I2C_isBlocked(I2CBusDef *bus, uint16_t address) {
+    I2CBreakerDef *breaker = I2C_getBreaker(bus, address, false);
+    if (breaker == NULL || breaker->failures < I2CBUS_BREAKER_FAILURES)
+        return false;
+
+    // the retry time isn't reached yet (the tick counter wraps around)
+    if ((TickType_t) (xTaskGetTickCount() - breaker->retryTime) >= portMAX_DELAY / 2 || breaker->isProbing)
+        return true;
+
+    breaker->isProbing = true;
+    return false;
+}
+
+/**
+ * @brief Release the probe of the half-open breaker without the result (the request isn't sent or its NACK is
+ * expected), the next request is the probe
+ * @param bus is the I2CBusDef data structure
+ * @param address is the device address
+ */
+static void I2C_releaseProbe(I2CBusDef *bus, uint16_t address) {
+    I2CBreakerDef *breaker = I2C_getBreaker(bus, address, false);
+    if (breaker)
+        breaker->isProbing = false;
+}
+
+/**
+ * @brief Update the circuit breaker of the device after the transaction (the interrupt or the critical section)
+ * @param bus is the I2CBusDef data structure
+ * @param address is the device address
+ * @param isSuccess flag, True - the transaction is completed, otherwise - False
+ * @param now is the current tick
+ */
+static void I2C_updateBreaker(I2CBusDef *bus, uint16_t address, bool isSuccess, TickType_t now) {
+    I2CBreakerDef *breaker = I2C_getBreaker(bus, address, !isSuccess);
+    if (breaker == NULL)
+        return;
+
+    breaker->isProbing = false;
+    if (isSuccess) {
+        breaker->failures = 0;
+        breaker->level = 0;
+        return;
+    }
+
+    if (breaker->failures < UINT8_MAX)
+        breaker->failures++;
+    if (breaker->failures >= I2CBUS_BREAKER_FAILURES) {
+        breaker->retryTime = now + pdMS_TO_TICKS((uint32_t) I2CBUS_BREAKER_BACKOFF_MS << breaker->level);
+        if (breaker->level < I2CBUS_BREAKER_MAX_LEVEL)
+            breaker->level++;
+    }
+}
+
+/**
+ * @brief Recover the stuck bus and initialize the interface again (the engine is owned by the task)
+ * @param bus is the I2CBusDef data structure
+ */
+static void I2C_recoverBus(I2CBusDef *bus) {
+    uint32_t start = getCycleCounter();
+
+    if (bus->i2c->recover(bus->i2c) != I2C_SUCCESS)
+        bus->errors++;
+    if (settingI2C(bus->i2c) != SETTING_SUCCESS)
+        bus->errors++;
+
+    uint32_t cycles = getCycleCounter() - start;
+    bus->recoveries++;
+    bus->recoveryCycles += cycles;
+    if (cycles > bus->maxRecoveryCycles)
+        bus->maxRecoveryCycles = cycles;
+
+    taskENTER_CRITICAL();
+    bus->lostCycles += cycles;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Start the next queued request from the task, if the bus is idle
+ * @param bus is the I2CBusDef data structure
+ */
+static void I2C_startNext(I2CBusDef *bus) {
+    // the interrupts clear isBusy only when the queue is empty, so the flag is the engine ownership
+    taskENTER_CRITICAL();
+    bool isIdle = !bus->isBusy;
+    bus->isBusy = true;
+    taskEXIT_CRITICAL();
+
+    if (!isIdle)
+        return;
+
+    bool isStarted = false;
+    while (!isStarted && xQueueReceive(bus->queue, &bus->active, 0) == pdPASS) {
+        isStarted = (I2C_startTransaction(bus) == I2C_SUCCESS);
+        if (!isStarted) {
+            bus->i2c->abort = true;
+            taskENTER_CRITICAL();
+            I2C_releaseProbe(bus, bus->active->trans.address);
+            taskEXIT_CRITICAL();
+            I2C_finishRequest(bus, bus->active, I2C_HW_ERROR, NULL);
+        }
+    }
+
+    // a request queued after the check above also kicks the task, so it won't be lost
+    if (!isStarted) {
+        bus->active = NULL;
+        bus->isBusy = false;
+    }
+}
+
+/**
+ * @brief Get the time, after which the active transaction is lost: the hardware timeout (SETTING_I2C_TIMEOUT_MS),
+ * I2CBUS_LOST_MARGIN_MS and its transfer time at the standard mode speed (the long transfers are reloaded,
+ * see I2C_startReload)
+ * @param bus is the I2CBusDef data structure
+ * @return the timeout (ticks)
+ */
+static TickType_t I2C_getTimeout(const I2CBusDef *bus) {
+    const I2CRequestDef *active = bus->active;
+    uint32_t timeMs = SETTING_I2C_TIMEOUT_MS + I2CBUS_LOST_MARGIN_MS;
+
+    if (active)
+        timeMs += (uint32_t) ((active->trans.txSize + active->trans.rxSize) * 9 * 1000 / I2C_STANDARD_MODE_HZ);
+    return pdMS_TO_TICKS(timeMs);
+}
 
 /**
- * @brief I2C interface (bus) task
+ * @brief I2C interface (bus) task, it starts the transactions on the idle bus, handles the aborted and lost
+ * transactions and recovers the stuck bus (the completions are delivered by the interrupts to the request owners)
  * @param arg is the function argument to which the scheduler will send the specified parameter
  * (while creating the task - I2CBusDef data structure)
  */
 static void I2CBusJob(void *arg) {
     I2CBusDef *bus = (I2CBusDef *) arg;
 
-    const TickType_t delay = pdMS_TO_TICKS(I2CBUS_DELAY_MS);
     BaseType_t result = pdFALSE;
     uint32_t notificationValue = 0;
-    I2CPackageDef pkg = {0};
+    uint32_t transactions = 0;
 
     while (1) {
-        result = xQueueReceive(bus->queue, &pkg, portMAX_DELAY);
-        if (result == pdPASS) {
-            if (pkg.data)
-                bus->i2c->sendData(bus->i2c, pkg.address, pkg.data, pkg.size, pkg.isNeedStop);
-            else
-                bus->i2c->readData(bus->i2c, pkg.address, bus->buffer, pkg.size);
-
-            result = xTaskNotifyWait(0, ULONG_MAX, &notificationValue, delay);
-            if (result == pdTRUE) {
-                if (notificationValue & I2CBUS_NOTIF_TX_FLAG) {
-                    bus->isWriting = false;
-                }
-                if (notificationValue & I2CBUS_NOTIF_RX_FLAG) {
-                    bus->isReading = false;
-                }
-                if (notificationValue & I2CBUS_NOTIF_ERR_FLAG) {
-                    bus->i2c->saveError(bus->i2c);
-                }
-                if (notificationValue & I2CBUS_NOTIF_ABORT_FLAG) {
-                    bus->i2c->abort = true;
-                }
-
-                xEventGroupSetBits(bus->eventGroup, 1);
-            } else {
+        transactions = bus->transactions;
+        result = xTaskNotifyWait(0, ULONG_MAX, &notificationValue, (bus->isBusy) ? I2C_getTimeout(bus) : portMAX_DELAY);
+        if (result == pdTRUE) {
+            if (notificationValue & I2CBUS_NOTIF_ABORT_FLAG) {
+                bus->i2c->abort = true;
+            }
+
+            if (notificationValue & I2CBUS_NOTIF_RECOVER_FLAG) {
+                I2C_recoverBus(bus);
+                bus->isBusy = false;
+            }
+        } else {
+            // the transaction is lost (SDA is held low, the Start isn't generated): the task takes the engine over
+            // atomically (the late interrupts find no active request), then fails the request and recovers the bus
+            I2CRequestDef *lost = NULL;
+            taskENTER_CRITICAL();
+            if (bus->isBusy && bus->active && bus->transactions == transactions) {
+                lost = bus->active;
+                bus->active = NULL;
+                bus->i2c->abort = true;
+                I2C_updateBreaker(bus, lost->trans.address, false, xTaskGetTickCount());
+                bus->lostCycles += getCycleCounter() - bus->startTime;
+            }
+            taskEXIT_CRITICAL();
+
+            if (lost) {
                 bus->errors++;
+                I2C_recoverBus(bus);
+                I2C_finishRequest(bus, lost, I2C_HW_ERROR, NULL);
+                bus->isBusy = false;
             }
         }
+
+        I2C_startNext(bus);
+    }
+}
+
+/**
+ * @brief Complete the current transaction phase and start the next one (call it from the I2C interrupts)
+ * @param bus is the I2CBusDef data structure
+ * @param notification is the I2CBUS_NOTIF_xxx flag of the event
+ * @param priorityTaskWoken is set to pdTRUE, if the I2C interface task has to run
+ */
+void I2C_completeFromISR(I2CBusDef *bus, uint32_t notification, BaseType_t *priorityTaskWoken) {
+    // no active request: the engine is owned by the task (the lost transaction, the recovery)
+    if (bus == NULL || !bus->isBusy || bus->active == NULL)
+        return;
+
+    const I2CTransactionDef *trans = &bus->active->trans;
+    if (notification == I2CBUS_NOTIF_TX_FLAG && trans->rxSize) {
+        // the write phase is done, the bus is held (SCL stretching) until the repeated start
+        if (bus->i2c->readData(bus->i2c, trans->address, trans->rxData, trans->rxSize) == I2C_SUCCESS)
+            return;
+        notification = I2CBUS_NOTIF_ABORT_FLAG;
+    }
+
+    // the error code is reset by the next transaction start, so it is saved here
+    int32_t status = I2C_SUCCESS;
+    if (notification & I2CBUS_NOTIF_ERR_FLAG)
+        status = (bus->i2c->isNack(bus->i2c)) ? I2C_NACK : I2C_HW_ERROR;
+    else if (notification & I2CBUS_NOTIF_ABORT_FLAG)
+        status = I2C_HW_ERROR;
+
+    // the busy device of the ACK polling isn't an interface error
+    bool isExpected = (status == I2C_NACK && bus->active->isProbe);
+    if (status != I2C_SUCCESS && !isExpected)
+        bus->i2c->saveError(bus->i2c);
+
+    uint32_t cycles = getCycleCounter() - bus->startTime;
+    bus->busyCycles += cycles;
+    if (status != I2C_SUCCESS && !isExpected)
+        bus->lostCycles += cycles;
+    bus->transactions++;
+    if (isExpected)
+        I2C_releaseProbe(bus, trans->address);
+    else
+        I2C_updateBreaker(bus, trans->address, status == I2C_SUCCESS, xTaskGetTickCountFromISR());
+
+    I2CRequestDef *request = bus->active;
+    bus->active = NULL;
+    I2C_finishRequest(bus, request, status, priorityTaskWoken);
+
+    // the bus task is woken up only to handle the failure, the lost transactions are detected by its timeout
+    if (status == I2C_HW_ERROR && bus->i2c->isBusStuck(bus->i2c)) {
+        // isBusy stays set: the queued requests wait for the recovery
+        xTaskNotifyFromISR(bus->task, notification | I2CBUS_NOTIF_RECOVER_FLAG, eSetBits, priorityTaskWoken);
+        return;
     }
+    if (notification & I2CBUS_NOTIF_ABORT_FLAG)
+        xTaskNotifyFromISR(bus->task, I2CBUS_NOTIF_ABORT_FLAG, eSetBits, priorityTaskWoken);
+
+    while (xQueueReceiveFromISR(bus->queue, &bus->active, priorityTaskWoken) == pdPASS) {
+        if (I2C_startTransaction(bus) == I2C_SUCCESS)
+            return;
+
+        I2C_releaseProbe(bus, bus->active->trans.address);
+        I2C_finishRequest(bus, bus->active, I2C_HW_ERROR, priorityTaskWoken);
+        xTaskNotifyFromISR(bus->task, I2CBUS_NOTIF_ABORT_FLAG, eSetBits, priorityTaskWoken);
+    }
+    bus->active = NULL;
+    bus->isBusy = false;
 }
 
 /**
@@ -63,93 +402,197 @@ static void I2CBusJob(void *arg) {
  */
 TaskHandle_t I2CJobInit(I2CBusDef *bus, I2CDef *i2c, uint8_t priorityLevel) {
     bus->i2c = i2c;
+    bus->i2c->owner = bus;
     bus->i2c->init(bus->i2c);
 
-    bus->isWriting = bus->isReading = false;
     bus->errors = 0;
-    memset((void *) bus->buffer, 0, I2CBUS_BUFFER_SIZE);
+    bus->isBusy = false;
+    bus->active = NULL;
+    bus->transactions = bus->busyCycles = 0;
+    bus->lostCycles = bus->recoveryCycles = bus->maxRecoveryCycles = 0;
+    bus->recoveries = bus->rejected = 0;
+    memset(bus->breakers, 0, sizeof(bus->breakers));
+    bus->numClients = 0;
+    bus->completions = bus->estimatedWakeups = 0;
+    initCycleCounter();
 
-    bus->mutex = xSemaphoreCreateMutexStatic(&mutexCB);
-    bus->eventGroup = xEventGroupCreateStatic(&eventGroupCB);
-    bus->queue = xQueueCreateStatic(I2CBUS_QUEUE_SIZE, sizeof(I2CPackageDef), queueStorage, &queueCB);
-    TaskHandle_t task = xTaskCreateStatic(I2CBusJob, "i2cBus", configMINIMAL_STACK_SIZE, bus, priorityLevel,
-                                          taskStack, &taskCB);
-    return task;
+    bus->mutex = xSemaphoreCreateMutexStatic(&bus->mutexBuffer);
+    bus->queue = xQueueCreateStatic(I2CBUS_QUEUE_SIZE, sizeof(I2CRequestDef *), bus->queueStorage,
+                                    &bus->queueBuffer);
+    bus->task = xTaskCreateStatic(I2CBusJob, "i2cBus", configMINIMAL_STACK_SIZE, bus, priorityLevel,
+                                  bus->taskStack, &bus->taskTCB);
+    return bus->task;
 }
 
 /**
- * @brief Check, that I2C interface is sending data
+ * @brief Queue the request and kick the I2C interface task (it starts the request, if the bus is idle)
  * @param bus is the I2CBusDef data structure
+ * @param request is the prepared request
+ * @return I2C_Errors value (I2C_DEVICE_BLOCKED - the request is rejected at once, no completion is delivered)
+ */
+static int32_t I2C_submit(I2CBusDef *bus, I2CRequestDef *request) {
+    // the breakers are updated by the interrupts
+    taskENTER_CRITICAL();
+    bool isBlocked = I2C_isBlocked(bus, request->trans.address);
+    if (isBlocked)
+        bus->rejected++;
+    taskEXIT_CRITICAL();
+
+    if (isBlocked) {
+        request->isWriting = request->isReading = false;
+        request->status = I2C_DEVICE_BLOCKED;
+        return I2C_DEVICE_BLOCKED;
+    }
+
+    I2C_addClient(bus, request);
+    BaseType_t result = xQueueSend(bus->queue, (const void *) &request, pdMS_TO_TICKS(I2CBUS_DELAY_MS));
+    if (result == errQUEUE_FULL) {
+        taskENTER_CRITICAL();
+        I2C_releaseProbe(bus, request->trans.address);
+        taskEXIT_CRITICAL();
+        request->isWriting = request->isReading = false;
+        request->status = I2C_HW_ERROR;
+        return I2C_HW_ERROR;
+    }
+
+    xTaskNotify(bus->task, I2CBUS_NOTIF_KICK_FLAG, eSetBits);
+    return I2C_SUCCESS;
+}
+
+/**
+ * @brief Deliver the request completion via the task notification
+ * @param request is the I2CRequestDef data structure
+ * @param task is the task to notify
+ * @param notification is the bits to set in the task notification value
+ */
+void I2C_setNotification(I2CRequestDef *request, TaskHandle_t task, uint32_t notification) {
+    request->completion = I2C_COMPLETION_NOTIFY;
+    request->task = task;
+    request->notification = notification;
+}
+
+/**
+ * @brief Deliver the request completion via the callback (it is called from the I2C interrupt)
+ * @param request is the I2CRequestDef data structure
+ * @param callback is the completion callback
+ * @param arg is the callback argument (request->arg)
+ */
+void I2C_setCallback(I2CRequestDef *request, I2CFun_complete callback, void *arg) {
+    request->completion = (callback) ? I2C_COMPLETION_CALLBACK : I2C_COMPLETION_NONE;
+    request->callback = callback;
+    request->arg = arg;
+}
+
+/**
+ * @brief Deliver the request completion via the semaphore
+ * @param request is the I2CRequestDef data structure
+ * @param semaphore is the binary or counting semaphore to give
+ */
+void I2C_setSemaphore(I2CRequestDef *request, SemaphoreHandle_t semaphore) {
+    request->completion = (semaphore) ? I2C_COMPLETION_SEMAPHORE : I2C_COMPLETION_NONE;
+    request->semaphore = semaphore;
+}
+
+/**
+ * @brief Check, that the request is sending data
+ * @param request is the I2CRequestDef data structure
  * @return True - is writing, otherwise - False
  */
-bool I2C_isWriting(const I2CBusDef *bus) {
-    if (bus == NULL)
+bool I2C_isWriting(const I2CRequestDef *request) {
+    if (request == NULL)
         return true;
 
-    return bus->isWriting;
+    return request->isWriting;
 }
 
 /**
  * @brief Send data
  * @param bus is the I2CBusDef data structure
+ * @param request is the I2CRequestDef data structure (caller-owned, it must not be pending)
  * @param addr is the target device address
- * @param src is the target data
+ * @param src is the target data, it must stay valid until the request is completed
  * @param size is the target data size (bytes)
  * @param isNeedStop flag, True - if you need to generate the Stop signal after the data transaction, otherwise - False
  * @return I2C_Errors value
  */
-int32_t I2C_writeData(I2CBusDef *bus, uint16_t addr, const void *src, size_t size, bool isNeedStop) {
-    if (bus == NULL || src == NULL || size == 0)
+int32_t I2C_writeData(I2CBusDef *bus, I2CRequestDef *request, uint16_t addr, const void *src, size_t size,
+                      bool isNeedStop) {
+    if (bus == NULL || request == NULL || src == NULL || size == 0 || request->isWriting || request->isReading)
         return I2C_WRONG_DATA;
 
-    bus->isWriting = true;
-    BaseType_t result = pdFALSE;
-    memcpy((void *) bus->buffer, src, size);
-    I2CPackageDef pkg = {isNeedStop, addr, (uint16_t) size, bus->buffer};
-    result = xQueueSend(bus->queue, (const void *) &pkg, pdMS_TO_TICKS(I2CBUS_DELAY_MS));
+    I2CTransactionDef trans = {isNeedStop, addr, size, 0, (const uint8_t *) src, NULL};
+    request->trans = trans;
+    request->isWriting = true;
 
-    return (result != errQUEUE_FULL) ? I2C_SUCCESS : I2C_HW_ERROR;
+    return I2C_submit(bus, request);
 }
 
 /**
- * @brief Check, that I2C interface is reading a new data
- * @param bus is the I2CBusDef data structure
+ * @brief Check, that the request is reading a new data
+ * @param request is the I2CRequestDef data structure
  * @return True - is reading, otherwise - False
  */
-bool I2C_isReading(const I2CBusDef *bus) {
-    if (bus == NULL)
+bool I2C_isReading(const I2CRequestDef *request) {
+    if (request == NULL)
         return true;
 
-    return bus->isReading;
+    return request->isReading;
 }
 
 /**
  * @brief Read data
  * @param bus is the I2CBusDef data structure
+ * @param request is the I2CRequestDef data structure (caller-owned, it must not be pending)
  * @param addr is the target device address
+ * @param dst is the destination buffer, it must stay valid until the request is completed
  * @param size is the size of the required data
  * @return I2C_Errors value
  */
-int32_t I2C_readData(I2CBusDef *bus, uint16_t addr, size_t size) {
-    if (bus == NULL || size == 0)
+int32_t I2C_readData(I2CBusDef *bus, I2CRequestDef *request, uint16_t addr, void *dst, size_t size) {
+    if (bus == NULL || request == NULL || dst == NULL || size == 0 || request->isWriting || request->isReading)
         return I2C_WRONG_DATA;
 
-    bus->isReading = true;
-    BaseType_t result = pdFALSE;
+    I2CTransactionDef trans = {true, addr, 0, size, NULL, (uint8_t *) dst};
+    request->trans = trans;
+    request->isReading = true;
 
-    I2CPackageDef pkg = {false, addr, (uint16_t) size, NULL};
-    result = xQueueSend(bus->queue, (void *) &pkg, pdMS_TO_TICKS(I2CBUS_DELAY_MS));
-
-    return (result != errQUEUE_FULL) ? I2C_SUCCESS : I2C_HW_ERROR;
+    return I2C_submit(bus, request);
 }
 
 /**
- * @brief Get a pointer to the received data
+ * @brief Write data and read the reply after the repeated start in one transaction (e.g. a register read)
  * @param bus is the I2CBusDef data structure
- * @return a pointer to I2C interface buffer
+ * @param request is the I2CRequestDef data structure (caller-owned, it must not be pending)
+ * @param addr is the target device address
+ * @param src is the data to send (e.g. the register address)
+ * @param txSize is the size of data to send (bytes)
+ * @param dst is the destination buffer
+ * @param rxSize is the size of the required data
+ * @return I2C_Errors value
+ */
+int32_t I2C_writeReadData(I2CBusDef *bus, I2CRequestDef *request, uint16_t addr, const void *src, size_t txSize,
+                          void *dst, size_t rxSize) {
+    if (bus == NULL || request == NULL || src == NULL || dst == NULL || txSize == 0 || rxSize == 0 ||
+        request->isWriting || request->isReading)
+        return I2C_WRONG_DATA;
+
+    I2CTransactionDef trans = {false, addr, txSize, rxSize, (const uint8_t *) src, (uint8_t *) dst};
+    request->trans = trans;
+    request->isReading = true;
+
+    return I2C_submit(bus, request);
+}
+
+/**
+ * @brief Get the result of the last completed request
+ * @param request is the I2CRequestDef data structure
+ * @return I2C_Errors value
  */
-const void *I2C_getReceivedData(const I2CBusDef *bus) {
-    return (const void *) bus->buffer;
+int32_t I2C_getStatus(const I2CRequestDef *request) {
+    if (request == NULL)
+        return I2C_WRONG_DATA;
+
+    return request->status;
 }
 
 /**
@@ -0,0 +1,200 @@
+#include <string.h>
+
+#include "stm32g4xx_hal.h"
+
+#include "I2CTarget.h"
+
+/**
+ * @brief Get the registers of the I2C target interface
+ * @param target is the I2CTargetDef data structure
+ * @return the I2C peripheral
+ */
+static I2C_TypeDef *getInstance(const I2CTargetDef *target) {
+    return ((I2C_HandleTypeDef *) target->i2c->handle)->Instance;
+}
+
+/**
+ * @brief Apply the received data: the first byte is the register pointer, the next ones are written to the
+ * writable registers (the others are skipped)
+ * @param target is the I2CTargetDef data structure
+ */
+static void applyWrite(I2CTargetDef *target) {
+    if (target->rxSize == 0)
+        return;
+
+    if (target->rxBuffer[0] >= I2C_TARGET_MAP_SIZE) {
+        target->errors++;
+        return;
+    }
+
+    target->pointer = target->rxBuffer[0];
+    if (target->rxSize == 1)
+        return;
+
+    for (uint8_t i = 1; i < target->rxSize; ++i) {
+        uint8_t reg = (uint8_t) ((target->pointer + i - 1) & (I2C_TARGET_MAP_SIZE - 1));
+        if (target->writable && target->writable[reg])
+            target->map[reg] = target->rxBuffer[i];
+    }
+    target->writes++;
+}
+
+/**
+ * @brief Finish the current transfer (Stop or repeated Start)
+ * @param target is the I2CTargetDef data structure
+ */
+static void finishTransfer(I2CTargetDef *target) {
+    I2C_HandleTypeDef *handle = (I2C_HandleTypeDef *) target->i2c->handle;
+
+    if (target->state == I2C_TARGET_TX) {
+        handle->Instance->CR1 &= ~I2C_CR1_TXDMAEN;
+        HAL_DMA_Abort(handle->hdmatx);
+    } else if (target->state == I2C_TARGET_RX) {
+        applyWrite(target);
+    }
+
+    // the byte prefetched by DMA isn't sent
+    handle->Instance->ISR = I2C_ISR_TXE;
+    target->state = I2C_TARGET_IDLE;
+    target->rxSize = 0;
+}
+
+/**
+ * @brief Start the read: take the snapshot of the map (from the register pointer) and send it by circular DMA,
+ * the controller can read any number of bytes
+ * @param target is the I2CTargetDef data structure
+ */
+static void startRead(I2CTargetDef *target) {
+    I2C_HandleTypeDef *handle = (I2C_HandleTypeDef *) target->i2c->handle;
+    size_t head = I2C_TARGET_MAP_SIZE - target->pointer;
+
+    memcpy(target->snapshot, &target->map[target->pointer], head);
+    memcpy(&target->snapshot[head], target->map, target->pointer);
+
+    if (HAL_DMA_Start(handle->hdmatx, (uint32_t) (uintptr_t) target->snapshot,
+                      (uint32_t) (uintptr_t) &handle->Instance->TXDR,
+                      I2C_TARGET_MAP_SIZE) == HAL_OK) {
+        handle->Instance->CR1 |= I2C_CR1_TXDMAEN;
+        target->state = I2C_TARGET_TX;
+        target->reads++;
+    } else {
+        target->errors++;
+    }
+}
+
+/**
+ * @brief Start serving the register map: address match, Stop, NACK, receive and error interrupts
+ * @param target is the I2CTargetDef data structure
+ * @param i2c is the I2C interface (initialized with the own address, the TX DMA channel is circular)
+ * @param writable is the writable register flags (I2C_TARGET_MAP_SIZE), NULL - read only map
+ * @return I2C_Error value
+ */
+int32_t I2CTargetInit(I2CTargetDef *target, I2CDef *i2c, const uint8_t *writable) {
+    if (target == NULL || i2c == NULL)
+        return I2C_WRONG_DATA;
+
+    memset(target, 0, sizeof(I2CTargetDef));
+    target->i2c = i2c;
+    target->writable = writable;
+
+    I2C_HandleTypeDef *handle = (I2C_HandleTypeDef *) i2c->handle;
+    if (!i2c->isInit || handle->hdmatx == NULL)
+        return I2C_NOT_INIT;
+
+    // HAL_I2C_Init leaves NACK set (the master mode default)
+    handle->Instance->CR2 &= ~I2C_CR2_NACK;
+    handle->Instance->CR1 |= I2C_CR1_ADDRIE | I2C_CR1_RXIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | I2C_CR1_ERRIE;
+    return I2C_SUCCESS;
+}
+
+/**
+ * @brief Change the registers (the next read sees all of them or none)
+ * @param target is the I2CTargetDef data structure
+ * @param reg is the first register
+ * @param src is the new values
+ * @param size is the number of registers
+ * @return I2C_Error value
+ */
+int32_t I2CTargetUpdate(I2CTargetDef *target, uint8_t reg, const void *src, size_t size) {
+    if (target == NULL || src == NULL || reg + size > I2C_TARGET_MAP_SIZE)
+        return I2C_WRONG_DATA;
+
+    taskENTER_CRITICAL();
+    memcpy(&target->map[reg], src, size);
+    taskEXIT_CRITICAL();
+
+    return I2C_SUCCESS;
+}
+
+/**
+ * @brief Get the current register values (the ones written by the controller)
+ * @param target is the I2CTargetDef data structure
+ * @param reg is the first register
+ * @param dst is the destination buffer
+ * @param size is the number of registers
+ * @return I2C_Error value
+ */
+int32_t I2CTargetGetRegisters(I2CTargetDef *target, uint8_t reg, void *dst, size_t size) {
+    if (target == NULL || dst == NULL || reg + size > I2C_TARGET_MAP_SIZE)
+        return I2C_WRONG_DATA;
+
+    taskENTER_CRITICAL();
+    memcpy(dst, &target->map[reg], size);
+    taskEXIT_CRITICAL();
+
+    return I2C_SUCCESS;
+}
+
+/**
+ * @brief Serve the event interrupt of the I2C target (instead of HAL_I2C_EV_IRQHandler): no task is woken up,
+ * SCL is stretched only during the address match handling
+ * @param target is the I2CTargetDef data structure
+ */
+void I2CTargetEventFromISR(I2CTargetDef *target) {
+    I2C_TypeDef *instance = getInstance(target);
+    uint32_t flags = instance->ISR;
+
+    if (flags & I2C_ISR_RXNE) {
+        uint8_t data = (uint8_t) instance->RXDR;
+        if (target->rxSize < I2C_TARGET_RX_SIZE)
+            target->rxBuffer[target->rxSize++] = data;
+        if (target->rxSize == I2C_TARGET_RX_SIZE)
+            instance->CR2 |= I2C_CR2_NACK;
+    }
+
+    // Stop is served first: the address match stretches SCL, so Stop can't follow it in the same interrupt
+    if (flags & I2C_ISR_STOPF) {
+        finishTransfer(target);
+        instance->ICR = I2C_ICR_STOPCF;
+    }
+
+    // the controller ends the read
+    if (flags & I2C_ISR_NACKF)
+        instance->ICR = I2C_ICR_NACKCF;
+
+    if (flags & I2C_ISR_ADDR) {
+        // repeated Start: the register pointer is written, then the registers are read
+        finishTransfer(target);
+        if (flags & I2C_ISR_DIR)
+            startRead(target);
+        else
+            target->state = I2C_TARGET_RX;
+        instance->ICR = I2C_ICR_ADDRCF;
+    }
+}
+
+/**
+ * @brief Serve the error interrupt of the I2C target: the transfer is dropped
+ * @param target is the I2CTargetDef data structure
+ */
+void I2CTargetErrorFromISR(I2CTargetDef *target) {
+    I2C_TypeDef *instance = getInstance(target);
+    uint32_t flags = instance->ISR & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR);
+
+    if (flags) {
+        instance->ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+        target->rxSize = 0; // the received data is dropped
+        finishTransfer(target);
+        target->errors++;
+    }
+}
@@ -0,0 +1,353 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "KernelBenchJob.h"
+#include "cycles.h"
+
+typedef struct {
+    const char *name;
+    KernelBenchFun_measure measure;
+    TaskFunction_t helper; // NULL - the test doesn't need the helper task
+    UBaseType_t helperPriority; // relative to the benchmark task: 0 - the same, 1 - higher (preempts it)
+} KernelBenchTestDef;
+
+/**
+ * @brief Helper task: switch back to the benchmark task immediately (same priority)
+ * @param arg is the KernelBench data structure
+ */
+static void yieldHelper(void *arg) {
+    KernelBenchDef *bench = (KernelBenchDef *) arg;
+
+    while (1) {
+        bench->wakeTime = getCycleCounter();
+        taskYIELD();
+    }
+}
+
+/**
+ * @brief Helper task: wait for the direct task notification (higher priority)
+ * @param arg is the KernelBench data structure
+ */
+static void notifyHelper(void *arg) {
+    KernelBenchDef *bench = (KernelBenchDef *) arg;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bench->wakeTime = getCycleCounter();
+    }
+}
+
+/**
+ * @brief Helper task: wait for the queue item (higher priority)
+ * @param arg is the KernelBench data structure
+ */
+static void queueHelper(void *arg) {
+    KernelBenchDef *bench = (KernelBenchDef *) arg;
+    uint32_t value = 0;
+
+    while (1) {
+        xQueueReceive(bench->queue, &value, portMAX_DELAY);
+        bench->wakeTime = getCycleCounter();
+    }
+}
+
+/**
+ * @brief Helper task: wait for the semaphore (higher priority)
+ * @param arg is the KernelBench data structure
+ */
+static void semaphoreHelper(void *arg) {
+    KernelBenchDef *bench = (KernelBenchDef *) arg;
+
+    while (1) {
+        xSemaphoreTake(bench->semaphore, portMAX_DELAY);
+        bench->wakeTime = getCycleCounter();
+    }
+}
+
+/**
+ * @brief Helper task: wait for the event group bit (higher priority)
+ * @param arg is the KernelBench data structure
+ */
+static void eventHelper(void *arg) {
+    KernelBenchDef *bench = (KernelBenchDef *) arg;
+
+    while (1) {
+        xEventGroupWaitBits(bench->events, KERNEL_BENCH_EVENT_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+        bench->wakeTime = getCycleCounter();
+    }
+}
+
+static uint32_t measureEmpty(KernelBenchDef *bench) {
+    (void) bench;
+    uint32_t start = getCycleCounter();
+    return getCycleCounter() - start;
+}
+
+static uint32_t measureYield(KernelBenchDef *bench) {
+    uint32_t start = getCycleCounter();
+    taskYIELD();
+    return bench->wakeTime - start;
+}
+
+static uint32_t measureNotify(KernelBenchDef *bench) {
+    (void) bench;
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    uint32_t start = getCycleCounter();
+    xTaskNotify(task, KERNEL_BENCH_EVENT_BIT, eSetBits);
+    uint32_t time = getCycleCounter() - start;
+    ulTaskNotifyTake(pdTRUE, 0);
+    return time;
+}
+
+static uint32_t measureNotifyWake(KernelBenchDef *bench) {
+    uint32_t start = getCycleCounter();
+    xTaskNotifyGive(bench->helper);
+    return bench->wakeTime - start;
+}
+
+static uint32_t measureQueueSend(KernelBenchDef *bench) {
+    uint32_t value = bench->run;
+    uint32_t start = getCycleCounter();
+    xQueueSend(bench->queue, &value, 0);
+    uint32_t time = getCycleCounter() - start;
+    xQueueReceive(bench->queue, &value, 0);
+    return time;
+}
+
+static uint32_t measureQueueReceive(KernelBenchDef *bench) {
+    uint32_t value = bench->run;
+    xQueueSend(bench->queue, &value, 0);
+    uint32_t start = getCycleCounter();
+    xQueueReceive(bench->queue, &value, 0);
+    return getCycleCounter() - start;
+}
+
+static uint32_t measureQueueWake(KernelBenchDef *bench) {
+    uint32_t value = bench->run;
+    uint32_t start = getCycleCounter();
+    xQueueSend(bench->queue, &value, 0);
+    return bench->wakeTime - start;
+}
+
+static uint32_t measureStreamSend(KernelBenchDef *bench) {
+    uint8_t data[KERNEL_BENCH_STREAM_CHUNK] = {0};
+    uint32_t start = getCycleCounter();
+    xStreamBufferSend(bench->stream, data, sizeof(data), 0);
+    uint32_t time = getCycleCounter() - start;
+    xStreamBufferReceive(bench->stream, data, sizeof(data), 0);
+    return time;
+}
+
+static uint32_t measureStreamReceive(KernelBenchDef *bench) {
+    uint8_t data[KERNEL_BENCH_STREAM_CHUNK] = {0};
+    xStreamBufferSend(bench->stream, data, sizeof(data), 0);
+    uint32_t start = getCycleCounter();
+    xStreamBufferReceive(bench->stream, data, sizeof(data), 0);
+    return getCycleCounter() - start;
+}
+
+static uint32_t measureSemaphoreGive(KernelBenchDef *bench) {
+    uint32_t start = getCycleCounter();
+    xSemaphoreGive(bench->semaphore);
+    uint32_t time = getCycleCounter() - start;
+    xSemaphoreTake(bench->semaphore, 0);
+    return time;
+}
+
+static uint32_t measureSemaphoreTake(KernelBenchDef *bench) {
+    xSemaphoreGive(bench->semaphore);
+    uint32_t start = getCycleCounter();
+    xSemaphoreTake(bench->semaphore, 0);
+    return getCycleCounter() - start;
+}
+
+static uint32_t measureSemaphoreWake(KernelBenchDef *bench) {
+    uint32_t start = getCycleCounter();
+    xSemaphoreGive(bench->semaphore);
+    return bench->wakeTime - start;
+}
+
+static uint32_t measureMutexTake(KernelBenchDef *bench) {
+    uint32_t start = getCycleCounter();
+    xSemaphoreTake(bench->mutex, 0);
+    uint32_t time = getCycleCounter() - start;
+    xSemaphoreGive(bench->mutex);
+    return time;
+}
+
+static uint32_t measureMutexGive(KernelBenchDef *bench) {
+    xSemaphoreTake(bench->mutex, 0);
+    uint32_t start = getCycleCounter();
+    xSemaphoreGive(bench->mutex);
+    return getCycleCounter() - start;
+}
+
+static uint32_t measureEventSet(KernelBenchDef *bench) {
+    uint32_t start = getCycleCounter();
+    xEventGroupSetBits(bench->events, KERNEL_BENCH_EVENT_BIT);
+    uint32_t time = getCycleCounter() - start;
+    xEventGroupClearBits(bench->events, KERNEL_BENCH_EVENT_BIT);
+    return time;
+}
+
+static uint32_t measureEventWake(KernelBenchDef *bench) {
+    uint32_t start = getCycleCounter();
+    xEventGroupSetBits(bench->events, KERNEL_BENCH_EVENT_BIT);
+    return bench->wakeTime - start;
+}
+
+// "_wake" tests: from the call to the moment the unblocked higher priority task runs (including the context switch)
+static const KernelBenchTestDef tests[] = {
+    {"empty", measureEmpty, NULL, 0}, // the measurement overhead
+    {"yield", measureYield, yieldHelper, 0}, // the context switch
+    {"notify", measureNotify, NULL, 0},
+    {"notify_wake", measureNotifyWake, notifyHelper, 1},
+    {"queue_send", measureQueueSend, NULL, 0},
+    {"queue_receive", measureQueueReceive, NULL, 0},
+    {"queue_wake", measureQueueWake, queueHelper, 1},
+    {"stream_send", measureStreamSend, NULL, 0},
+    {"stream_receive", measureStreamReceive, NULL, 0},
+    {"semaphore_give", measureSemaphoreGive, NULL, 0},
+    {"semaphore_take", measureSemaphoreTake, NULL, 0},
+    {"semaphore_wake", measureSemaphoreWake, semaphoreHelper, 1},
+    {"mutex_take", measureMutexTake, NULL, 0},
+    {"mutex_give", measureMutexGive, NULL, 0},
+    {"event_set", measureEventSet, NULL, 0},
+    {"event_wake", measureEventWake, eventHelper, 1},
+};
+
+#define KERNEL_BENCH_NUMBER_TESTS (sizeof(tests) / sizeof(tests[0]))
+
+_Static_assert(KERNEL_BENCH_NUMBER_TESTS <= KERNEL_BENCH_MAX_TESTS, "KERNEL_BENCH_MAX_TESTS is too small");
+
+static int compareSamples(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Collect the samples of the test and calculate the statistics
+ * @param bench is the KernelBench data structure
+ * @param test is the test description
+ * @param result is the test statistics (cycles)
+ */
+static void runTest(KernelBenchDef *bench, const KernelBenchTestDef *test, KernelBenchResultDef *result) {
+    if (test->helper) {
+        // a higher priority helper runs at once and blocks on the primitive
+        bench->helper = xTaskCreateStatic(test->helper, "benchHelper", configMINIMAL_STACK_SIZE, bench,
+                                          uxTaskPriorityGet(NULL) + test->helperPriority,
+                                          bench->helperStack, &bench->helperTCB);
+    }
+
+    for (size_t i = 0; i < KERNEL_BENCH_SAMPLES; ++i)
+        bench->samples[i] = test->measure(bench);
+
+    if (bench->helper) {
+        vTaskDelete(bench->helper);
+        bench->helper = NULL;
+    }
+
+    uint64_t sum = 0;
+    qsort(bench->samples, KERNEL_BENCH_SAMPLES, sizeof(uint32_t), compareSamples);
+    for (size_t i = 0; i < KERNEL_BENCH_SAMPLES; ++i)
+        sum += bench->samples[i];
+
+    // nearest-rank percentile
+    size_t rank = (KERNEL_BENCH_SAMPLES * KERNEL_BENCH_PERCENTILE + 99) / 100;
+    result->min = bench->samples[0];
+    result->mean = (uint32_t) (sum / KERNEL_BENCH_SAMPLES);
+    result->percentile = bench->samples[rank - 1];
+    result->max = bench->samples[KERNEL_BENCH_SAMPLES - 1];
+}
+
+/**
+ * @brief Send one line of the report via the serial port
+ * @param bench is the KernelBench data structure
+ * @param size is the line size (snprintf result)
+ */
+static void sendLine(KernelBenchDef *bench, int size) {
+    if (size <= 0)
+        return;
+
+    if (size >= KERNEL_BENCH_LINE_SIZE)
+        size = KERNEL_BENCH_LINE_SIZE - 1;
+    SerialWriteData(bench->port, bench->line, (size_t) size);
+}
+
+/**
+ * @brief Send the report: JSON lines, the suite description and one line per test
+ * @param bench is the KernelBench data structure
+ */
+static void sendReport(KernelBenchDef *bench) {
+    int size = snprintf(bench->line, KERNEL_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"suite\":\"kernel\",\"clock_hz\":%" PRIu32 ",\"tick_hz\":%" PRIu32
+                        ",\"samples\":%d,\"percentile\":%d}\n",
+                        bench->run, getCycleFrequency(), (uint32_t) configTICK_RATE_HZ,
+                        KERNEL_BENCH_SAMPLES, KERNEL_BENCH_PERCENTILE);
+    sendLine(bench, size);
+
+    for (size_t i = 0; i < KERNEL_BENCH_NUMBER_TESTS; ++i) {
+        const KernelBenchResultDef *result = &bench->results[i];
+        size = snprintf(bench->line, KERNEL_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"test\":\"%s\",\"min\":%" PRIu32 ",\"mean\":%" PRIu32
+                        ",\"p%d\":%" PRIu32 ",\"max\":%" PRIu32 "}\n",
+                        bench->run, tests[i].name, result->min, result->mean,
+                        KERNEL_BENCH_PERCENTILE, result->percentile, result->max);
+        sendLine(bench, size);
+    }
+}
+
+/**
+ * @brief Kernel benchmark task, it measures the kernel primitives (cycles) and reports the statistics
+ * @param arg is the function argument to which the scheduler will send the specified parameter
+ * (while creating the task - KernelBench data structure)
+ */
+static void KernelBenchJob(void *arg) {
+    KernelBenchDef *bench = (KernelBenchDef *) arg;
+
+    const TickType_t delay = pdMS_TO_TICKS(KERNEL_BENCH_PERIOD_MS);
+    initCycleCounter();
+
+    while (1) {
+        vTaskDelay(delay);
+
+        bench->run++;
+        for (size_t i = 0; i < KERNEL_BENCH_NUMBER_TESTS; ++i)
+            runTest(bench, &tests[i], &bench->results[i]);
+
+        sendReport(bench);
+    }
+}
+
+/**
+ * @brief Create the Kernel benchmark task and all required structure
+ * @param bench is the KernelBench data structure
+ * @param port is the SerialPort data structure (output)
+ * @param priorityLevel is the priority of the benchmark task (the helper task uses priorityLevel + 1)
+ * @return pointer to the benchmark task handle
+ */
+TaskHandle_t KernelBenchJobInit(KernelBenchDef *bench, SerialPortDef *port, uint8_t priorityLevel) {
+    if (bench == NULL || port == NULL || priorityLevel + 1 >= configMAX_PRIORITIES)
+        return NULL;
+
+    bench->port = port;
+    bench->run = 0;
+    bench->helper = NULL;
+    bench->wakeTime = 0;
+    memset(bench->results, 0, sizeof(bench->results));
+
+    bench->queue = xQueueCreateStatic(KERNEL_BENCH_QUEUE_SIZE, sizeof(uint32_t), bench->queueStorage,
+                                      &bench->queueBuffer);
+    bench->stream = xStreamBufferCreateStatic(KERNEL_BENCH_STREAM_SIZE, 1, bench->streamStorage,
+                                              &bench->streamBuffer);
+    bench->semaphore = xSemaphoreCreateBinaryStatic(&bench->semaphoreBuffer);
+    bench->mutex = xSemaphoreCreateMutexStatic(&bench->mutexBuffer);
+    bench->events = xEventGroupCreateStatic(&bench->eventsBuffer);
+
+    TaskHandle_t task = xTaskCreateStatic(KernelBenchJob, "kernelBench", configMINIMAL_STACK_SIZE * 2, bench,
+                                          priorityLevel, bench->taskStack, &bench->taskTCB);
+    return task;
+}
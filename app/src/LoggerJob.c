@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include "LoggerJob.h"
+
+_Static_assert((LOGGER_BUFFER_SIZE & (LOGGER_BUFFER_SIZE - 1)) == 0, "the free-running indexes need 2^N buffer size");
+
+static StaticTask_t taskTCB;
+static StackType_t taskStack[configMINIMAL_STACK_SIZE];
+
+/**
+ * @brief Logger task, it sends the collected binary records via the Serial Port
+ * @param arg is the function argument to which the scheduler will send the specified parameter
+ * (while creating the task - Logger data structure)
+ */
+static void LoggerJob(void *arg) {
+    LoggerDef *logger = (LoggerDef *) arg;
+
+    const TickType_t delay = pdMS_TO_TICKS(LOGGER_DELAY_MS);
+    int32_t numBytes = 0;
+
+    while (1) {
+        vTaskDelay(delay);
+
+        uint32_t head = 0;
+        while ((head = __atomic_load_n(&logger->head, __ATOMIC_ACQUIRE)) != logger->tail) {
+            uint32_t tail = logger->tail;
+            uint32_t position = tail % LOGGER_BUFFER_SIZE;
+
+            // the contiguous region ends at the published index or at the end of the buffer
+            uint32_t size = head - tail;
+            if (size > LOGGER_BUFFER_SIZE - position)
+                size = LOGGER_BUFFER_SIZE - position;
+            numBytes = SerialWriteData(logger->port, logger->buffer + position, size);
+            if (numBytes <= 0)
+                break;
+
+            // the space is released after the data have been copied to the Serial Port
+            __atomic_store_n(&logger->tail, tail + (uint32_t) numBytes, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+/**
+ * @brief Create the Logger task and all required structure
+ * @param logger is the Logger data structure
+ * @param port is the SerialPort data structure (output)
+ * @param priorityLevel is the priority of the Logger task
+ * @return pointer to the Logger task handle
+ */
+TaskHandle_t LoggerJobInit(LoggerDef *logger, SerialPortDef *port, uint8_t priorityLevel) {
+    logger->port = port;
+    logger->lost = 0;
+    logger->reserved = logger->writers = logger->head = logger->tail = 0;
+    memset(logger->buffer, 0, LOGGER_BUFFER_SIZE);
+
+    TaskHandle_t task = xTaskCreateStatic(LoggerJob, "logger", configMINIMAL_STACK_SIZE, logger, priorityLevel,
+                                          taskStack, &taskTCB);
+    return task;
+}
+
+/**
+ * @brief Publish the reserved records, if no writer is copying its record (call it after the copy)
+ * @param logger is the Logger data structure
+ */
+static void LoggerPublish(LoggerDef *logger) {
+    if (__atomic_sub_fetch(&logger->writers, 1, __ATOMIC_ACQ_REL) != 0)
+        return; // the last active writer publishes
+
+    // a writer, which starts now, has reserved its space after the read of reserved (or it publishes itself)
+    uint32_t head = __atomic_load_n(&logger->head, __ATOMIC_ACQUIRE);
+    while (1) {
+        uint32_t reserved = __atomic_load_n(&logger->reserved, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&logger->writers, __ATOMIC_ACQUIRE) != 0 || (int32_t) (reserved - head) <= 0)
+            return;
+        if (__atomic_compare_exchange_n(&logger->head, &head, reserved, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return;
+    }
+}
+
+/**
+ * @brief Put the binary record to the Logger buffer (use LOG macro), it is safe to call from tasks and ISRs.
+ * It doesn't mask the interrupts: the space is reserved by compare-and-swap (LDREX/STREX), the record is copied
+ * outside of any lock, a preempted writer only delays the publication until it finishes its copy.
+ * @param logger is the Logger data structure
+ * @param id is the format string ID (offset inside the ".logstr" section)
+ * @param args is the arguments of the format string
+ * @param numArgs is the number of arguments (up to LOGGER_MAX_ARGS)
+ * @return True - the record has been saved, otherwise - False (the buffer is full)
+ */
+bool LoggerWrite(LoggerDef *logger, uint16_t id, const uint32_t *args, uint8_t numArgs) {
+    if (numArgs > LOGGER_MAX_ARGS)
+        numArgs = LOGGER_MAX_ARGS;
+
+    uint8_t record[LOGGER_RECORD_SIZE];
+    uint32_t size = LOGGER_HEADER_SIZE + numArgs * 4U;
+    record[0] = LOGGER_SYNC_BYTE;
+    record[1] = (uint8_t) id;
+    record[2] = (uint8_t) (id >> 8);
+    record[3] = numArgs;
+    memcpy(record + LOGGER_HEADER_SIZE, args, numArgs * 4U); // little-endian
+
+    // the full buffer is refused before the writer is counted: the lost records don't delay the publication
+    uint32_t start = __atomic_load_n(&logger->reserved, __ATOMIC_ACQUIRE);
+    if (start - __atomic_load_n(&logger->tail, __ATOMIC_ACQUIRE) + size > LOGGER_BUFFER_SIZE) {
+        __atomic_add_fetch(&logger->lost, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    // the writer is counted before the reservation, the publication waits for all counted writers
+    __atomic_add_fetch(&logger->writers, 1, __ATOMIC_ACQ_REL);
+    start = __atomic_load_n(&logger->reserved, __ATOMIC_ACQUIRE);
+    do {
+        if (start - __atomic_load_n(&logger->tail, __ATOMIC_ACQUIRE) + size > LOGGER_BUFFER_SIZE) {
+            __atomic_add_fetch(&logger->lost, 1, __ATOMIC_RELAXED);
+            LoggerPublish(logger);
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(&logger->reserved, &start, start + size, true, __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE));
+
+    // the record is split at the end of the buffer at most once
+    uint32_t position = start % LOGGER_BUFFER_SIZE;
+    uint32_t first = (size < LOGGER_BUFFER_SIZE - position) ? size : LOGGER_BUFFER_SIZE - position;
+    memcpy(logger->buffer + position, record, first);
+    memcpy(logger->buffer, record + first, size - first);
+
+    LoggerPublish(logger);
+    return true;
+}
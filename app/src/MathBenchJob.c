@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+
+#include "MathBenchJob.h"
+#include "cycles.h"
+
+typedef struct {
+    const char *name;
+    uint8_t function; // Cordic_Functions value
+    uint8_t scale;
+    float low; // the range of x (and y), the arguments are x * 2^-scale
+    float high;
+} MathBenchTestDef;
+
+// the arguments cover the valid range of each function (see Cordic_Functions)
+static const MathBenchTestDef tests[] = {
+    {"sin_cos", CORDIC_SIN_COS, 0, -1.0f, 1.0f},
+    {"phase", CORDIC_PHASE, 0, -0.7f, 0.7f},
+    {"modulus", CORDIC_MODULUS, 0, -0.7f, 0.7f},
+    {"sqrt", CORDIC_SQRT, 0, 0.03f, 0.74f},
+    {"ln", CORDIC_LN, 1, 0.11f, 0.99f},
+};
+
+#define MATH_BENCH_NUMBER_TESTS (sizeof(tests) / sizeof(tests[0]))
+
+_Static_assert(MATH_BENCH_NUMBER_TESTS <= MATH_BENCH_MAX_TESTS, "MATH_BENCH_MAX_TESTS is too small");
+
+/**
+ * @brief Get the argument of the test range
+ * @param test is the test description
+ * @param index is the position in the range (0 ... MATH_BENCH_BATCH - 1)
+ * @return the argument (q1.31)
+ */
+static int32_t getArgument(const MathBenchTestDef *test, size_t index) {
+    float x = test->low + (test->high - test->low) * (float) index / (float) MATH_BENCH_BATCH;
+    return (int32_t) (ldexpf(x, -test->scale) * 2147483648.0f);
+}
+
+/**
+ * @brief Fill the arguments of the test: the points (x, y) don't follow a line, so the phases are spread
+ * @param bench is the MathBench data structure
+ * @param test is the test description
+ */
+static void fillArguments(MathBenchDef *bench, const MathBenchTestDef *test) {
+    for (size_t i = 0; i < MATH_BENCH_BATCH; ++i) {
+        if (CordicGetArguments(test->function) == 2) {
+            bench->arguments[2 * i] = getArgument(test, i);
+            bench->arguments[2 * i + 1] = getArgument(test, (i * 37 + 11) % MATH_BENCH_BATCH);
+        } else {
+            bench->arguments[i] = getArgument(test, i);
+        }
+    }
+}
+
+/**
+ * @brief Calculate the batch by the math service and by libm, compare the results
+ * @param bench is the MathBench data structure
+ * @param test is the test description
+ * @param result is the test statistics
+ */
+static void runTest(MathBenchDef *bench, const MathBenchTestDef *test, MathBenchResultDef *result) {
+    size_t size = MATH_BENCH_BATCH * CordicGetResults(test->function);
+
+    memset(result, 0, sizeof(MathBenchResultDef));
+    fillArguments(bench, test);
+
+    for (size_t i = 0; i < MATH_BENCH_REPEATS; ++i) {
+        uint32_t start = getCycleCounter();
+        int32_t status = CordicCalculate(bench->cordic, test->function, test->scale, bench->arguments,
+                                         bench->results, MATH_BENCH_BATCH);
+        result->cordicCycles += getCycleCounter() - start;
+
+        start = getCycleCounter();
+        CordicSoftware(test->function, test->scale, bench->arguments, bench->reference, MATH_BENCH_BATCH);
+        result->libmCycles += getCycleCounter() - start;
+
+        if (status != CORDIC_SUCCESS) {
+            result->errors++;
+            continue;
+        }
+
+        for (size_t k = 0; k < size; ++k) {
+            int64_t difference = (int64_t) bench->results[k] - bench->reference[k];
+            uint32_t value = (uint32_t) ((difference < 0) ? -difference : difference);
+            if (value > result->maxDifference)
+                result->maxDifference = value;
+        }
+    }
+}
+
+/**
+ * @brief Send one line of the report via the serial port
+ * @param bench is the MathBench data structure
+ * @param size is the line size (snprintf result)
+ */
+static void sendLine(MathBenchDef *bench, int size) {
+    if (size <= 0)
+        return;
+
+    if (size >= MATH_BENCH_LINE_SIZE)
+        size = MATH_BENCH_LINE_SIZE - 1;
+    SerialWriteData(bench->port, bench->line, (size_t) size);
+}
+
+/**
+ * @brief Send the report: JSON lines, the suite description and one line per test
+ * @param bench is the MathBench data structure
+ */
+static void sendReport(MathBenchDef *bench) {
+    const uint32_t operations = MATH_BENCH_BATCH * MATH_BENCH_REPEATS;
+    int size = snprintf(bench->line, MATH_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"suite\":\"math\",\"clock_hz\":%" PRIu32 ",\"batch\":%d"
+                        ",\"engine\":\"%s\",\"reconfigurations\":%" PRIu32 "}\n",
+                        bench->run, getCycleFrequency(), MATH_BENCH_BATCH,
+                        (bench->cordic->handle) ? "cordic" : "software", bench->cordic->reconfigurations);
+    sendLine(bench, size);
+
+    for (size_t i = 0; i < MATH_BENCH_NUMBER_TESTS; ++i) {
+        const MathBenchResultDef *result = &bench->tests[i];
+
+        size = snprintf(bench->line, MATH_BENCH_LINE_SIZE,
+                        "{\"run\":%" PRIu32 ",\"test\":\"%s\",\"operations\":%" PRIu32 ",\"errors\":%" PRIu32
+                        ",\"cordic_per_op\":%" PRIu32 ",\"libm_per_op\":%" PRIu32 ",\"max_diff_lsb\":%" PRIu32
+                        "}\n",
+                        bench->run, tests[i].name, operations, result->errors, result->cordicCycles / operations,
+                        result->libmCycles / operations, result->maxDifference);
+        sendLine(bench, size);
+    }
+}
+
+/**
+ * @brief Math benchmark task, it calculates the same batches by the CORDIC and by libm and reports the time
+ * @param arg is the function argument to which the scheduler will send the specified parameter
+ * (while creating the task - MathBench data structure)
+ */
+static void MathBenchJob(void *arg) {
+    MathBenchDef *bench = (MathBenchDef *) arg;
+
+    const TickType_t delay = pdMS_TO_TICKS(MATH_BENCH_PERIOD_MS);
+    initCycleCounter();
+
+    while (1) {
+        vTaskDelay(delay);
+
+        bench->run++;
+        for (size_t i = 0; i < MATH_BENCH_NUMBER_TESTS; ++i)
+            runTest(bench, &tests[i], &bench->tests[i]);
+
+        sendReport(bench);
+    }
+}
+
+/**
+ * @brief Create the math benchmark task
+ * @param bench is the MathBench data structure
+ * @param port is the SerialPort data structure (output)
+ * @param cordic is the math service (initialized)
+ * @param priorityLevel is the priority of the benchmark task
+ * @return pointer to the benchmark task handle
+ */
+TaskHandle_t MathBenchJobInit(MathBenchDef *bench, SerialPortDef *port, CordicDef *cordic, uint8_t priorityLevel) {
+    if (bench == NULL || port == NULL || cordic == NULL)
+        return NULL;
+
+    bench->port = port;
+    bench->cordic = cordic;
+    bench->run = 0;
+    memset(bench->tests, 0, sizeof(bench->tests));
+
+    TaskHandle_t task = xTaskCreateStatic(MathBenchJob, "mathBench", configMINIMAL_STACK_SIZE * 2, bench,
+                                          priorityLevel, bench->taskStack, &bench->taskTCB);
+    return task;
+}
@@ -0,0 +1,190 @@
+#include <string.h>
+
+#include "SensorPoll.h"
+
+/**
+ * @brief Compare two entries: by the bus, the device, the rate, then the first register
+ * @param a is the first entry
+ * @param b is the second entry
+ * @return True - a is placed before b, otherwise - False
+ */
+static bool isEntryBefore(const SensorPollEntryDef *a, const SensorPollEntryDef *b) {
+    if (a->bus != b->bus)
+        return a->bus < b->bus;
+    if (a->address != b->address)
+        return a->address < b->address;
+    if (a->periodMs != b->periodMs)
+        return a->periodMs < b->periodMs;
+    return a->reg < b->reg;
+}
+
+/**
+ * @brief Merge the sorted entries into the burst reads
+ * @param poll is the SensorPollDef data structure
+ * @param buses is the I2C buses of the devices
+ * @return SensorPoll_Errors value
+ */
+static int32_t buildGroups(SensorPollDef *poll, I2CBusDef *buses) {
+    SensorPollGroupDef *group = NULL;
+    poll->numGroups = 0;
+
+    for (uint8_t i = 0; i < poll->numEntries; ++i) {
+        const SensorPollEntryDef *entry = &poll->table[poll->order[i]];
+        uint16_t end = (uint16_t) (entry->reg + entry->size);
+
+        if (group && group->bus == &buses[entry->bus] && group->address == entry->address &&
+            group->period == pdMS_TO_TICKS(entry->periodMs) &&
+            entry->reg <= group->reg + group->size + SENSOR_POLL_MAX_GAP &&
+            end - group->reg <= SENSOR_POLL_BURST_SIZE) {
+            if (end > group->reg + group->size)
+                group->size = (uint8_t) (end - group->reg);
+            group->count++;
+            continue;
+        }
+
+        if (poll->numGroups == SENSOR_POLL_MAX_GROUPS)
+            return SENSOR_POLL_WRONG_DATA;
+
+        group = &poll->groups[poll->numGroups++];
+        memset(group, 0, sizeof(SensorPollGroupDef));
+        group->bus = &buses[entry->bus];
+        group->address = entry->address;
+        group->reg = entry->reg;
+        group->size = entry->size;
+        group->period = pdMS_TO_TICKS(entry->periodMs);
+        group->first = i;
+        group->count = 1;
+    }
+
+    // spread the first reads over the period, so the groups with a common rate don't start at the same tick
+    // (the buses are served by their own tasks, the reads of the different buses overlap)
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t i = 0; i < poll->numGroups; ++i) {
+        group = &poll->groups[i];
+        group->nextTime = now + (group->period * i) / poll->numGroups;
+        I2C_setNotification(&group->request, poll->task, 1UL << i);
+    }
+    return SENSOR_POLL_SUCCESS;
+}
+
+/**
+ * @brief Prepare the polling engine: sort the table and merge the entries into the burst reads
+ * @param poll is the SensorPollDef data structure
+ * @param buses is the I2C buses of the devices (SensorPollEntryDef.bus is the index)
+ * @param numBuses is the number of the I2C buses
+ * @param table is the polling table (it must stay valid)
+ * @param numEntries is the number of the table entries
+ * @param task is the task, that calls SensorPollStart/SensorPollComplete (it receives the completion bits)
+ * @return SensorPoll_Errors value
+ */
+int32_t SensorPollInit(SensorPollDef *poll, I2CBusDef *buses, size_t numBuses, const SensorPollEntryDef *table,
+                       size_t numEntries, TaskHandle_t task) {
+    if (poll == NULL || buses == NULL || (table == NULL && numEntries) || numEntries > SENSOR_POLL_MAX_ENTRIES)
+        return SENSOR_POLL_WRONG_DATA;
+
+    for (size_t i = 0; i < numEntries; ++i) {
+        if (table[i].bus >= numBuses || table[i].size == 0 || table[i].size > SENSOR_POLL_BURST_SIZE ||
+            table[i].periodMs == 0 || table[i].decode == NULL)
+            return SENSOR_POLL_WRONG_DATA;
+    }
+
+    poll->task = task;
+    poll->table = table;
+    poll->numEntries = (uint8_t) numEntries;
+    poll->reads = 0;
+    memset(poll->values, 0, sizeof(poll->values));
+
+    // insertion sort, the table is short
+    for (uint8_t i = 0; i < poll->numEntries; ++i) {
+        uint8_t j = i;
+        for (; j > 0 && isEntryBefore(&table[i], &table[poll->order[j - 1]]); --j)
+            poll->order[j] = poll->order[j - 1];
+        poll->order[j] = i;
+    }
+
+    return buildGroups(poll, buses);
+}
+
+/**
+ * @brief Start the burst reads, which are due
+ * @param poll is the SensorPollDef data structure
+ * @return the time until the next read (ticks)
+ */
+TickType_t SensorPollStart(SensorPollDef *poll) {
+    TickType_t now = xTaskGetTickCount();
+    TickType_t delay = portMAX_DELAY;
+
+    for (uint8_t i = 0; i < poll->numGroups; ++i) {
+        SensorPollGroupDef *group = &poll->groups[i];
+
+        if ((TickType_t) (now - group->nextTime) < portMAX_DELAY / 2) {
+            // the previous read is still pending: skip this period
+            if (!I2C_isReading(&group->request)) {
+                if (I2C_writeReadData(group->bus, &group->request, group->address, &group->reg, 1,
+                                      group->buffer, group->size) == I2C_SUCCESS)
+                    poll->reads++;
+                else
+                    group->errors++;
+            }
+
+            // keep the phase: the late reads don't shift the schedule
+            do {
+                group->nextTime += group->period;
+            } while ((TickType_t) (now - group->nextTime) < portMAX_DELAY / 2);
+        }
+
+        TickType_t left = group->nextTime - now;
+        if (left < delay)
+            delay = left;
+    }
+
+    return delay;
+}
+
+/**
+ * @brief Decode and publish the values of the completed burst reads
+ * @param poll is the SensorPollDef data structure
+ * @param completed is the task notification value (a bit per group)
+ */
+void SensorPollComplete(SensorPollDef *poll, uint32_t completed) {
+    TickType_t now = xTaskGetTickCount();
+
+    for (uint8_t i = 0; i < poll->numGroups; ++i) {
+        SensorPollGroupDef *group = &poll->groups[i];
+        if (!(completed & (1UL << i)))
+            continue;
+
+        if (I2C_getStatus(&group->request) != I2C_SUCCESS) {
+            group->errors++;
+            continue;
+        }
+
+        for (uint8_t j = group->first; j < group->first + group->count; ++j) {
+            const SensorPollEntryDef *entry = &poll->table[poll->order[j]];
+            int32_t value = entry->decode(&group->buffer[entry->reg - group->reg]);
+
+            taskENTER_CRITICAL();
+            poll->values[poll->order[j]].value = value;
+            poll->values[poll->order[j]].timestamp = now;
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+
+/**
+ * @brief Get the last decoded value of the table entry
+ * @param poll is the SensorPollDef data structure
+ * @param index is the table entry index
+ * @param value is the decoded value and its timestamp
+ * @return True - the value is available, otherwise - False
+ */
+bool SensorPollGetValue(const SensorPollDef *poll, size_t index, SensorValueDef *value) {
+    if (poll == NULL || value == NULL || index >= poll->numEntries)
+        return false;
+
+    taskENTER_CRITICAL();
+    *value = poll->values[index];
+    taskEXIT_CRITICAL();
+
+    return value->timestamp != 0;
+}
@@ -2,15 +2,234 @@
 #include <limits.h>
 
 #include "SerialJob.h"
+#include "cycles.h"
 
-static StaticSemaphore_t mutexBufferRx;
-static StaticStreamBuffer_t streamBufferRx;
-static uint8_t streamBufferRx_storage[SERIAL_PORT_STREAM_SIZE];
-static StaticSemaphore_t mutexBufferTx;
-static StaticStreamBuffer_t streamBufferTx;
-static uint8_t streamBufferTx_storage[SERIAL_PORT_STREAM_SIZE];
-static StaticTask_t taskTCB;
-static StackType_t taskStack[configMINIMAL_STACK_SIZE];
+/**
+ * @brief Get the free space of the output ring buffer (one byte is always kept empty)
+ * @param port is the SerialPort data structure
+ * @return the number of bytes that can be written
+ */
+static uint16_t getTxFreeSpace(const SerialPortDef *port) {
+    return (uint16_t) ((port->txTail + port->txRingSize - port->txHead - 1) % port->txRingSize);
+}
+
+/**
+ * @brief Copy data to the output ring buffer
+ * @param port is the SerialPort data structure
+ * @param src is the source buffer
+ * @param size is the required data size (bytes)
+ * @return the number of bytes that were copied
+ */
+static size_t writeTxRing(SerialPortDef *port, const uint8_t *src, size_t size) {
+    uint16_t head = port->txHead;
+    size_t numBytes = getTxFreeSpace(port);
+    if (numBytes > size)
+        numBytes = size;
+
+    size_t part = port->txRingSize - head;
+    if (part > numBytes)
+        part = numBytes;
+    memcpy(port->txRing + head, src, part);
+    memcpy(port->txRing, src + part, numBytes - part);
+
+    // the data must be in the ring before the Serial Port task can see the new write index
+    portMEMORY_BARRIER();
+    port->txHead = (uint16_t) ((head + numBytes) % port->txRingSize);
+    return numBytes;
+}
+
+/**
+ * @brief Remember the time of the write call, if the previous written data are being sent already
+ * @param port is the SerialPort data structure
+ */
+static void markWriteTime(SerialPortDef *port) {
+    taskENTER_CRITICAL();
+    if (!port->isTxWriteTimed) {
+        port->txWriteTime = getCycleCounter();
+        port->isTxWriteTimed = true;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Add the latency of the oldest write to the histogram (its first byte is started by DMA). The DMA start is
+ * the first byte on the wire: only the idle link is started (TC, the empty TX FIFO), the start bit follows the first
+ * DMA transfer to TDR within a few bus cycles (see README, "Serial ports")
+ * @param port is the SerialPort data structure
+ */
+static void saveWriteLatency(SerialPortDef *port) {
+    taskENTER_CRITICAL();
+    bool isTimed = port->isTxWriteTimed;
+    uint32_t latency = getCycleCounter() - port->txWriteTime;
+    port->isTxWriteTimed = false;
+    taskEXIT_CRITICAL();
+
+    if (!isTimed)
+        return;
+
+    uint32_t timeUs = latency / (getCycleFrequency() / 1000000U);
+    size_t bucket = 0;
+    while (bucket < SERIAL_LATENCY_BUCKETS - 1 && timeUs >= ((uint32_t) SERIAL_LATENCY_BASE_US << bucket))
+        ++bucket;
+    port->txLatency[bucket]++;
+    if (latency > port->txMaxLatency)
+        port->txMaxLatency = latency;
+}
+
+/**
+ * @brief Release the region of the output ring buffer or complete the asynchronous request, that has been sent
+ * @param port is the SerialPort data structure
+ */
+static void releaseTxRegion(SerialPortDef *port) {
+    if (port->txLength == 0)
+        return;
+
+    SerialRequestDef *request = port->txRequest;
+    if (request) {
+        port->txRequest = NULL;
+        port->txLength = 0;
+
+        request->status = SERIAL_REQUEST_DONE;
+        if (request->callback)
+            request->callback(request);
+        if (request->task)
+            xTaskNotify(request->task, request->notificationBits, eSetBits);
+        return;
+    }
+
+    port->txTail = (uint16_t) ((port->txTail + port->txLength) % port->txRingSize);
+    port->txLength = 0;
+    xSemaphoreGive(port->txSpace);
+}
+
+/**
+ * @brief Start sending the next data via DMA (without copying): the high priority request, the contiguous readable
+ * region of the output ring buffer or the low priority request. While the baud rate change is pending, only the
+ * ring data before the switch index are sent, the requests are held until the baud rate is changed.
+ * @param port is the SerialPort data structure
+ * @return True - the transmission has been started, otherwise - False (nothing to send or UART is busy)
+ */
+static bool startTransmission(SerialPortDef *port) {
+    uint16_t head = port->txHead;
+    uint16_t tail = port->txTail;
+    bool isSwitching = (port->requestedBaudRate != 0);
+
+    // the request stays here until it is sent (if UART is busy)
+    if (port->txRequest == NULL && !isSwitching) {
+        if (xQueueReceive(port->txQueues[SERIAL_PRIORITY_HIGH], &port->txRequest, 0) != pdPASS && head == tail)
+            xQueueReceive(port->txQueues[SERIAL_PRIORITY_LOW], &port->txRequest, 0);
+    }
+
+    if (port->txRequest) {
+        if (port->uart->sendData(port->uart, port->txRequest->data, port->txRequest->size) != UART_SUCCESS)
+            return false;
+
+        port->txLength = port->txRequest->size;
+        return true;
+    }
+
+    if (head == tail)
+        return false;
+
+    // the readable region ends at the write index or at the end of the ring
+    uint16_t numBytes = (head > tail) ? (uint16_t) (head - tail) : (uint16_t) (port->txRingSize - tail);
+    if (isSwitching) {
+        // the data after the switch index are sent with the new baud rate
+        uint16_t pending = (uint16_t) ((port->baudSwitchIndex + port->txRingSize - tail) % port->txRingSize);
+        if (numBytes > pending)
+            numBytes = pending;
+        if (numBytes == 0)
+            return false;
+    }
+
+    if (port->uart->sendData(port->uart, port->txRing + tail, numBytes) != UART_SUCCESS)
+        return false;
+
+    port->txLength = numBytes;
+    saveWriteLatency(port);
+    return true;
+}
+
+/**
+ * @brief Wake up the Serial Port task to start the transmission immediately, if the link is idle
+ * @param port is the SerialPort data structure
+ */
+static void kickTransmission(SerialPortDef *port) {
+    if (port->txLength == 0)
+        xTaskNotify(port->task, SERIAL_NOTIF_DATA_FLAG, eSetBits);
+}
+
+/**
+ * @brief Restart the reception (circular DMA) from the beginning of the receive buffer
+ * @param port is the SerialPort data structure
+ */
+static void restartReception(SerialPortDef *port) {
+    taskENTER_CRITICAL();
+    if (port->uart->readData(port->uart, port->rxBuffer, SERIAL_PORT_BUFFER_SIZE) == UART_SUCCESS) {
+        port->rxPosition = 0;
+        port->rxFrameLength = 0;
+        port->isFrameBroken = false;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Apply the new baud rate (the transmission must be stopped), the reception is restarted
+ * @param port is the SerialPort data structure
+ * @param baudRate is the new baud rate (bps)
+ * @return True - the baud rate has been changed, otherwise - False
+ */
+static bool changeBaudRate(SerialPortDef *port, uint32_t baudRate) {
+    bool isChanged = (port->uart->setBaudRate(port->uart, baudRate) == UART_SUCCESS);
+    if (isChanged) {
+        port->baudRate = baudRate;
+    } else {
+        // restore the previous configuration
+        port->uart->setBaudRate(port->uart, port->baudRate);
+    }
+
+    port->baudErrors = 0;
+    port->baudChangeTime = xTaskGetTickCount();
+    port->isBaudConfirmed = (port->baudRate == port->baseBaudRate);
+    restartReception(port);
+    return isChanged;
+}
+
+/**
+ * @brief Apply the requested baud rate, if all data, written before the request, have been sent
+ * @param port is the SerialPort data structure
+ */
+static void checkBaudRateRequest(SerialPortDef *port) {
+    if (port->requestedBaudRate == 0 || port->txLength != 0)
+        return;
+
+    // the output ring index moves forward only, so the data before the switch index are sent, if the tail
+    // has reached or passed it
+    uint16_t sent = (uint16_t) ((port->txTail + port->txRingSize - port->baudSwitchIndex) % port->txRingSize);
+    uint16_t pending = (uint16_t) ((port->txHead + port->txRingSize - port->baudSwitchIndex) % port->txRingSize);
+    if (sent > pending)
+        return;
+
+    uint32_t baudRate = port->requestedBaudRate;
+    port->requestedBaudRate = 0;
+    changeBaudRate(port, baudRate);
+}
+
+/**
+ * @brief Fall back to the base baud rate, if the new one hasn't been confirmed in time or produces errors
+ * @param port is the SerialPort data structure
+ */
+static void checkBaudRateHealth(SerialPortDef *port) {
+    if (port->baudRate == port->baseBaudRate || port->txLength != 0)
+        return;
+
+    bool isExpired = !port->isBaudConfirmed &&
+                     (xTaskGetTickCount() - port->baudChangeTime) > pdMS_TO_TICKS(SERIAL_BAUD_CONFIRM_MS);
+    if (isExpired || port->baudErrors >= SERIAL_BAUD_MAX_ERRORS) {
+        port->requestedBaudRate = 0;
+        changeBaudRate(port, port->baseBaudRate);
+    }
+}
 
 /**
  * @brief Serial Port task
@@ -23,75 +242,101 @@ static void SerialJob(void *arg) {
     const TickType_t delay = pdMS_TO_TICKS(SERIAL_PORT_DELAY_MS);
     BaseType_t result = pdFALSE;
     uint32_t notificationValue = 0;
-    uint32_t numBytes = 0;
-    bool isTransactionLocked = true;
 
-    // start to read/wait data via UART interface
+    // start to read/wait data via UART interface (circular DMA, it is never stopped)
+    port->rxPosition = 0;
     port->uart->readData(port->uart, port->rxBuffer, SERIAL_PORT_BUFFER_SIZE);
 
     while (1) {
         result = xTaskNotifyWait(0, ULONG_MAX, &notificationValue, delay);
         if (result == pdTRUE) {
             if (notificationValue & SERIAL_NOTIF_TX_FLAG) {
-                numBytes = xStreamBufferReceive(port->txStream, port->txBuffer, SERIAL_PORT_BUFFER_SIZE, delay);
-                if (numBytes) {
-                    port->uart->sendData(port->uart, port->txBuffer, numBytes);
-                } else {
-                    isTransactionLocked = true;
-                }
-            }
-
-            if (notificationValue & SERIAL_NOTIF_RX_FLAG) {
-                port->uart->readData(port->uart, port->rxBuffer, SERIAL_PORT_BUFFER_SIZE);
+                releaseTxRegion(port);
             }
 
             if (notificationValue & SERIAL_NOTIF_ERR_FLAG) {
                 port->uart->saveError(port->uart);
+                port->baudErrors++;
+
+                // HAL stops the reception after the blocking errors (overrun or DMA), restart it
+                restartReception(port);
             }
 
             if (notificationValue & SERIAL_NOTIF_ABORT_FLAG) {
             }
-        } else {
-            if (xSemaphoreTake(port->txMutex, delay / 2) == pdPASS) {
-                if (isTransactionLocked && !xStreamBufferIsEmpty(port->txStream)) {
-                    isTransactionLocked = false;
-                    xTaskNotify(xTaskGetCurrentTaskHandle(), SERIAL_NOTIF_TX_FLAG, eSetBits);
-                }
-                xSemaphoreGive(port->txMutex);
-            }
         }
+
+        // the baud rate is changed between the transmissions
+        checkBaudRateRequest(port);
+        checkBaudRateHealth(port);
+
+        // start the next transmission (TX complete or new data), or try again if UART was busy
+        if (port->txLength == 0)
+            startTransmission(port);
     }
 }
 
 /**
  * @brief Create the Serial Port task and all required structure
  * @param port is the SerialPort data structure
- * @param uart is the base UART data structure
+ * @param uart is the base UART data structure (it is bound to the port, so ISRs find the port in O(1))
+ * @param buffers is the static buffers of the port (see SERIAL_PORT_BUFFERS)
  * @param priorityLevel is the priority of the Serial Port task
  * @return pointer to the Serial Port task handle
  */
-TaskHandle_t SerialJobInit(SerialPortDef *port, UartDef *uart, uint8_t priorityLevel) {
+TaskHandle_t SerialJobInit(SerialPortDef *port, UartDef *uart, const SerialBuffersDef *buffers, uint8_t priorityLevel) {
+    if (port == NULL || uart == NULL || buffers == NULL)
+        return NULL;
+
     port->uart = uart;
+    port->uart->owner = port;
     port->uart->init(port->uart);
+    port->task = NULL;
+    port->buffers = buffers;
+
+    port->baseBaudRate = port->baudRate = (uint32_t) port->uart->getBaudRate(port->uart);
+    port->requestedBaudRate = 0;
+    port->baudSwitchIndex = 0;
+    port->baudErrors = 0;
+    port->baudChangeTime = 0;
+    port->isBaudConfirmed = true;
 
     port->errors = 0;
+    port->rxPosition = 0;
     memset(port->rxBuffer, 0, SERIAL_PORT_BUFFER_SIZE);
-    memset(port->txBuffer, 0, SERIAL_PORT_BUFFER_SIZE);
 
-    port->rxMutex = xSemaphoreCreateMutexStatic(&mutexBufferRx);
-    port->rxStream = xStreamBufferCreateStatic(SERIAL_PORT_STREAM_SIZE, SERIAL_PORT_TRIGGER_LEVEL,
-                                               streamBufferRx_storage, &streamBufferRx);
-    port->txMutex = xSemaphoreCreateMutexStatic(&mutexBufferTx);
-    port->txStream = xStreamBufferCreateStatic(SERIAL_PORT_STREAM_SIZE, SERIAL_PORT_TRIGGER_LEVEL,
-                                               streamBufferTx_storage, &streamBufferTx);
+    port->rxFrameLength = 0;
+    port->isFrameBroken = false;
+    port->rxFrames = NULL;
+    port->crc = NULL;
 
-    TaskHandle_t task = xTaskCreateStatic(SerialJob, "serialPort", configMINIMAL_STACK_SIZE, port, priorityLevel,
-                                          taskStack, &taskTCB);
-    return task;
+    port->txRing = buffers->txRing;
+    port->txRingSize = buffers->txRingSize;
+    port->txHead = port->txTail = 0;
+    port->txLength = 0;
+    port->isTxWriteTimed = false;
+    port->txWriteTime = port->txMaxLatency = 0;
+    memset(port->txLatency, 0, sizeof(port->txLatency));
+    initCycleCounter();
+    port->txRequest = NULL;
+    for (size_t i = 0; i < SERIAL_NUMBER_PRIORITIES; ++i) {
+        port->txQueues[i] = xQueueCreateStatic(SERIAL_REQUEST_QUEUE_SIZE, sizeof(SerialRequestDef *),
+                                               port->txQueuesStorage[i], &port->txQueuesBuffer[i]);
+    }
+
+    port->rxMutex = xSemaphoreCreateMutexStatic(&port->rxMutexBuffer);
+    port->rxStream = xStreamBufferCreateStatic(buffers->rxStreamSize, SERIAL_PORT_TRIGGER_LEVEL,
+                                               buffers->rxStream, &port->rxStreamBuffer);
+    port->txMutex = xSemaphoreCreateMutexStatic(&port->txMutexBuffer);
+    port->txSpace = xSemaphoreCreateBinaryStatic(&port->txSpaceBuffer);
+
+    port->task = xTaskCreateStatic(SerialJob, "serialPort", configMINIMAL_STACK_SIZE, port, priorityLevel,
+                                   port->taskStack, &port->taskTCB);
+    return port->task;
 }
 
 /**
- * @brief Send the required data to the Serial Port output buffer/stream
+ * @brief Send the required data to the Serial Port output ring buffer
  * @param port is the SerialPort data structure
  * @param src is the source buffer
  * @param size is the required data size (bytes)
@@ -107,12 +352,17 @@ int32_t SerialWriteData(SerialPortDef *port, const void *src, size_t size) {
     uint32_t numBytes = 0;
 
     if (xSemaphoreTake(port->txMutex, delay) == pdPASS) {
-        TickType_t remainTime = endTime - xTaskGetTickCount();
-        numBytes = xStreamBufferSend(port->txStream, data, size, remainTime);
+        markWriteTime(port);
+        numBytes = writeTxRing(port, data, size);
+        kickTransmission(port);
 
-        if (numBytes != size) {
-            remainTime = endTime - xTaskGetTickCount();
-            numBytes += xStreamBufferSend(port->txStream, data + numBytes, size - numBytes, remainTime);
+        // wait until the Serial Port task releases the sent region of the output ring
+        while (numBytes != size) {
+            TickType_t remainTime = endTime - xTaskGetTickCount();
+            if (remainTime > delay || xSemaphoreTake(port->txSpace, remainTime) != pdPASS)
+                break;
+            numBytes += writeTxRing(port, data + numBytes, size - numBytes);
+            kickTransmission(port);
         }
 
         xSemaphoreGive(port->txMutex);
@@ -123,6 +373,53 @@ int32_t SerialWriteData(SerialPortDef *port, const void *src, size_t size) {
     return (int32_t) numBytes;
 }
 
+/**
+ * @brief Send the required data to the Serial Port output ring buffer without waiting
+ * @param port is the SerialPort data structure
+ * @param src is the source buffer
+ * @param size is the required data size (bytes)
+ * @return the number of bytes that were sent: all or nothing (0 - back-pressure, the ring is full or busy)
+ */
+int32_t SerialTryWriteData(SerialPortDef *port, const void *src, size_t size) {
+    if (port == NULL || src == NULL || size == 0)
+        return -1;
+
+    uint32_t numBytes = 0;
+
+    if (xSemaphoreTake(port->txMutex, 0) == pdPASS) {
+        if (getTxFreeSpace(port) >= size) {
+            markWriteTime(port);
+            numBytes = writeTxRing(port, (const uint8_t *) src, size);
+            kickTransmission(port);
+        }
+        xSemaphoreGive(port->txMutex);
+    }
+
+    return (int32_t) numBytes;
+}
+
+/**
+ * @brief Submit the asynchronous write request, the data are sent directly from the caller buffer,
+ * the high priority requests overtake the output ring data, the low priority requests are sent after it
+ * @param port is the SerialPort data structure
+ * @param request is the write request (it must stay valid until its status is SERIAL_REQUEST_DONE)
+ * @return 0 - the request has been queued, otherwise - -1 (wrong data or back-pressure, the queue is full)
+ */
+int32_t SerialSubmitData(SerialPortDef *port, SerialRequestDef *request) {
+    if (port == NULL || request == NULL || request->data == NULL || request->size == 0 ||
+        request->priority >= SERIAL_NUMBER_PRIORITIES)
+        return -1;
+
+    request->status = SERIAL_REQUEST_PENDING;
+    if (xQueueSend(port->txQueues[request->priority], &request, 0) != pdPASS) {
+        request->status = SERIAL_REQUEST_DONE;
+        return -1;
+    }
+
+    kickTransmission(port);
+    return 0;
+}
+
 /**
  * @brief Read received data from the Serial Port input buffer/stream
  * @param port is the SerialPort data structure
@@ -145,3 +442,138 @@ int32_t SerialReadData(SerialPortDef *port, void *dst, size_t size) {
 
     return (int32_t) numBytes;
 }
+
+/**
+ * @brief Request the baud rate change, it is applied after all data, written before this call, have been sent
+ * (the asynchronous requests and the data written after this call wait for the change). The peer must confirm
+ * the new baud rate in SERIAL_BAUD_CONFIRM_MS (see SerialConfirmBaudRate), otherwise the Serial Port falls back to
+ * the base baud rate
+ * @param port is the SerialPort data structure
+ * @param baudRate is the new baud rate (bps)
+ * @return 0 - the request has been accepted, otherwise - -1
+ */
+int32_t SerialSetBaudRate(SerialPortDef *port, uint32_t baudRate) {
+    if (port == NULL || baudRate == 0)
+        return -1;
+
+    if (xSemaphoreTake(port->txMutex, pdMS_TO_TICKS(SERIAL_PORT_DELAY_MS)) != pdPASS)
+        return -1;
+
+    port->baudSwitchIndex = port->txHead;
+    port->requestedBaudRate = baudRate;
+    xSemaphoreGive(port->txMutex);
+
+    xTaskNotify(port->task, SERIAL_NOTIF_BAUD_FLAG, eSetBits);
+    return 0;
+}
+
+/**
+ * @brief Confirm, that the peer communicates with the current baud rate (cancel the fall back timeout)
+ * @param port is the SerialPort data structure
+ */
+void SerialConfirmBaudRate(SerialPortDef *port) {
+    if (port == NULL)
+        return;
+
+    port->isBaudConfirmed = true;
+}
+
+/**
+ * @brief Switch the Serial Port input to the packet mode (complete frames instead of the byte stream)
+ * @param port is the SerialPort data structure
+ * @param crc is the CRC module handle (HAL), it is used to check/calculate the packet CRC-32
+ */
+void SerialEnableFraming(SerialPortDef *port, void *crc) {
+    if (port == NULL || crc == NULL || port->buffers->rxFramesSize == 0)
+        return;
+
+    port->crc = crc;
+    port->rxFrameLength = 0;
+    port->isFrameBroken = false;
+    port->rxFrames = xMessageBufferCreateStatic(port->buffers->rxFramesSize, port->buffers->rxFrames,
+                                                &port->rxFramesBuffer);
+}
+
+/**
+ * @brief Split the received data into frames and save the complete ones, so a reader wakes up once per frame
+ * @param port is the SerialPort data structure
+ * @param src is the received data
+ * @param size is the received data size (bytes)
+ * @param priorityTaskWoken is set to pdTRUE, if a task with the higher priority has been unblocked
+ * @return the number of bytes that were accepted (lost frames are counted as errors)
+ */
+static size_t receiveFramesFromISR(SerialPortDef *port, const uint8_t *src, size_t size,
+                                   BaseType_t *priorityTaskWoken) {
+    for (size_t i = 0; i < size; ++i) {
+        if (src[i] == SERIAL_FRAME_DELIMITER) {
+            if (port->isFrameBroken) {
+                port->errors++;
+            } else if (port->rxFrameLength) {
+                if (xMessageBufferSendFromISR(port->rxFrames, port->rxFrame, port->rxFrameLength,
+                                              priorityTaskWoken) == 0)
+                    port->errors++;
+            }
+            port->rxFrameLength = 0;
+            port->isFrameBroken = false;
+        } else if (port->rxFrameLength < SERIAL_FRAME_SIZE) {
+            port->rxFrame[port->rxFrameLength++] = src[i];
+        } else {
+            port->isFrameBroken = true;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Pass the received data to the input stream or to the packet framing
+ * @param port is the SerialPort data structure
+ * @param src is the received data
+ * @param size is the received data size (bytes)
+ * @param priorityTaskWoken is set to pdTRUE, if a task with the higher priority has been unblocked
+ * @return the number of bytes that were accepted
+ */
+static size_t receiveFromISR(SerialPortDef *port, const uint8_t *src, size_t size, BaseType_t *priorityTaskWoken) {
+    if (port->rxFrames)
+        return receiveFramesFromISR(port, src, size, priorityTaskWoken);
+
+    return xStreamBufferSendFromISR(port->rxStream, src, size, priorityTaskWoken);
+}
+
+/**
+ * @brief Move the newly received data from the circular DMA buffer to the Serial Port input stream/frames
+ * (Half Transfer, Transfer Complete and IDLE events)
+ * @param port is the SerialPort data structure
+ * @param position is the current DMA write position inside the receive buffer (bytes)
+ * @param priorityTaskWoken is set to pdTRUE, if a task with the higher priority has been unblocked
+ * @return the number of bytes that were accepted
+ */
+size_t SerialReceiveFromISR(SerialPortDef *port, uint16_t position, BaseType_t *priorityTaskWoken) {
+    if (port == NULL || position > SERIAL_PORT_BUFFER_SIZE)
+        return 0;
+
+    size_t numBytes = 0;
+    size_t expected = 0;
+    uint16_t index = port->rxPosition;
+
+    if (position < index) {
+        // DMA has wrapped around, at first take the tail of the buffer (there is none after the TC event)
+        if (index < SERIAL_PORT_BUFFER_SIZE) {
+            expected += SERIAL_PORT_BUFFER_SIZE - index;
+            numBytes += receiveFromISR(port, port->rxBuffer + index, SERIAL_PORT_BUFFER_SIZE - index,
+                                       priorityTaskWoken);
+        }
+        index = 0;
+    }
+    if (position > index) {
+        expected += position - index;
+        numBytes += receiveFromISR(port, port->rxBuffer + index, position - index, priorityTaskWoken);
+    }
+
+    // the input stream is full, the remaining bytes are lost
+    if (numBytes != expected)
+        port->errors++;
+
+    // keep the full-buffer position (TC event), so a following IDLE event at the same position is skipped
+    port->rxPosition = position;
+    return numBytes;
+}
@@ -0,0 +1,194 @@
+#include <string.h>
+
+#include "SerialPacket.h"
+#include "utilities.h"
+
+static StaticSemaphore_t mutexCRC;
+static SemaphoreHandle_t crcMutex = NULL; // the CRC module is shared by all ports
+
+/**
+ * @brief Encode the data with Consistent Overhead Byte Stuffing (without the frame delimiter)
+ * @param src is the source data
+ * @param size is the source data size (bytes)
+ * @param dst is the destination buffer (size + size / 254 + 1 bytes at least)
+ * @return the encoded data size (bytes)
+ */
+size_t cobsEncode(const uint8_t *src, size_t size, uint8_t *dst) {
+    size_t code = 0; // position of the current code byte
+    size_t length = 1;
+    uint8_t distance = 1;
+
+    for (size_t i = 0; i < size; ++i) {
+        if (src[i] == SERIAL_FRAME_DELIMITER) {
+            dst[code] = distance;
+            code = length++;
+            distance = 1;
+        } else {
+            dst[length++] = src[i];
+            if (++distance == 0xFF) {
+                dst[code] = distance;
+                code = length++;
+                distance = 1;
+            }
+        }
+    }
+
+    dst[code] = distance;
+    return length;
+}
+
+/**
+ * @brief Decode the COBS encoded data (without the frame delimiter)
+ * @param src is the encoded data
+ * @param size is the encoded data size (bytes)
+ * @param dst is the destination buffer
+ * @param dstSize is the destination buffer size (bytes)
+ * @return the decoded data size (bytes) or SERIAL_PACKET_BROKEN
+ */
+int32_t cobsDecode(const uint8_t *src, size_t size, uint8_t *dst, size_t dstSize) {
+    size_t length = 0;
+    size_t i = 0;
+
+    while (i < size) {
+        uint8_t distance = src[i++];
+        if (distance == SERIAL_FRAME_DELIMITER || i + distance - 1 > size || length + distance - 1 > dstSize)
+            return SERIAL_PACKET_BROKEN;
+
+        memcpy(dst + length, src + i, distance - 1U);
+        length += distance - 1U;
+        i += distance - 1U;
+
+        // a zero byte was replaced by this code (except the last group and the maximum length groups)
+        if (distance != 0xFF && i < size) {
+            if (length == dstSize)
+                return SERIAL_PACKET_BROKEN;
+            dst[length++] = 0;
+        }
+    }
+
+    return (int32_t) length;
+}
+
+/**
+ * @brief Calculate CRC-32 of the packet payload
+ * @param port is the SerialPort data structure
+ * @param data is the packet payload
+ * @param size is the packet payload size (bytes)
+ * @param crc is CRC-32 value
+ * @return SERIAL_PACKET_SUCCESS or SERIAL_PACKET_BUSY (the CRC module isn't released in time)
+ */
+static int32_t getPacketCRC(const SerialPortDef *port, const void *data, size_t size, uint32_t *crc) {
+    if (xSemaphoreTake(crcMutex, pdMS_TO_TICKS(SERIAL_PORT_DELAY_MS)) != pdPASS)
+        return SERIAL_PACKET_BUSY;
+
+    *crc = getCRC(port->crc, data, (uint16_t) size);
+    xSemaphoreGive(crcMutex);
+    return SERIAL_PACKET_SUCCESS;
+}
+
+/**
+ * @brief Switch the Serial Port to the packet mode: COBS frames with CRC-32 (little-endian) after the payload
+ * @param port is the SerialPort data structure
+ * @param crc is the CRC module handle (HAL)
+ */
+void SerialPacketInit(SerialPortDef *port, void *crc) {
+    if (crcMutex == NULL)
+        crcMutex = xSemaphoreCreateMutexStatic(&mutexCRC);
+
+    SerialEnableFraming(port, crc);
+}
+
+/**
+ * @brief Send the packet via the Serial Port
+ * @param port is the SerialPort data structure
+ * @param src is the packet payload
+ * @param size is the packet payload size (up to SERIAL_PACKET_SIZE bytes)
+ * @return the number of payload bytes that were sent or SerialPacket_Errors value
+ */
+int32_t SerialWritePacket(SerialPortDef *port, const void *src, size_t size) {
+    if (port == NULL || port->rxFrames == NULL || src == NULL || size == 0 || size > SERIAL_PACKET_SIZE)
+        return SERIAL_PACKET_WRONG_DATA;
+
+    uint8_t packet[SERIAL_PACKET_SIZE + SERIAL_PACKET_CRC_SIZE];
+    uint8_t frame[SERIAL_FRAME_SIZE + 2];
+
+    uint32_t crc = 0;
+    int32_t status = getPacketCRC(port, src, size, &crc);
+    if (status != SERIAL_PACKET_SUCCESS)
+        return status;
+
+    memcpy(packet, src, size);
+    for (size_t i = 0; i < SERIAL_PACKET_CRC_SIZE; ++i)
+        packet[size + i] = (uint8_t) (crc >> (8 * i));
+
+    // the leading delimiter discards any garbage on the receiver side
+    frame[0] = SERIAL_FRAME_DELIMITER;
+    size_t length = 1 + cobsEncode(packet, size + SERIAL_PACKET_CRC_SIZE, frame + 1);
+    frame[length++] = SERIAL_FRAME_DELIMITER;
+
+    int32_t numBytes = SerialWriteData(port, frame, length);
+    return (numBytes == (int32_t) length) ? (int32_t) size : SERIAL_PACKET_WRONG_DATA;
+}
+
+/**
+ * @brief Read the next complete packet received via the Serial Port
+ * @param port is the SerialPort data structure
+ * @param dst is the destination buffer
+ * @param size is the destination buffer size (bytes)
+ * @return the packet payload size (0 - there is no packet) or SerialPacket_Errors value
+ */
+int32_t SerialReadPacket(SerialPortDef *port, void *dst, size_t size) {
+    if (port == NULL || port->rxFrames == NULL || dst == NULL || size == 0)
+        return SERIAL_PACKET_WRONG_DATA;
+
+    const TickType_t delay = pdMS_TO_TICKS(SERIAL_PORT_DELAY_MS);
+    uint8_t frame[SERIAL_FRAME_SIZE];
+    uint8_t packet[SERIAL_PACKET_SIZE + SERIAL_PACKET_CRC_SIZE];
+    size_t length = 0;
+
+    if (xSemaphoreTake(port->rxMutex, delay) == pdPASS) {
+        length = xMessageBufferReceive(port->rxFrames, frame, SERIAL_FRAME_SIZE, delay);
+        xSemaphoreGive(port->rxMutex);
+    }
+    if (length == 0)
+        return 0;
+
+    int32_t result = cobsDecode(frame, length, packet, sizeof(packet));
+    if (result <= SERIAL_PACKET_CRC_SIZE) {
+        port->errors++;
+        return SERIAL_PACKET_BROKEN;
+    }
+
+    size_t payloadSize = (size_t) result - SERIAL_PACKET_CRC_SIZE;
+    uint32_t crc = 0;
+    for (size_t i = 0; i < SERIAL_PACKET_CRC_SIZE; ++i)
+        crc |= (uint32_t) packet[payloadSize + i] << (8 * i);
+
+    // the frame is already taken from the buffer: it is dropped, if it can't be checked
+    uint32_t expected = 0;
+    int32_t status = getPacketCRC(port, packet, payloadSize, &expected);
+    if (status != SERIAL_PACKET_SUCCESS) {
+        port->errors++;
+        return status;
+    }
+
+    if (crc != expected || payloadSize > size) {
+        port->errors++;
+        return SERIAL_PACKET_BROKEN;
+    }
+
+    memcpy(dst, packet, payloadSize);
+    return (int32_t) payloadSize;
+}
+
+/**
+ * @brief Check, that there is at least one complete packet to read
+ * @param port is the SerialPort data structure
+ * @return True - a packet has been received, otherwise - False
+ */
+bool SerialIsPacketReceived(const SerialPortDef *port) {
+    if (port == NULL || port->rxFrames == NULL)
+        return false;
+
+    return xMessageBufferIsEmpty(port->rxFrames) == pdFALSE;
+}
@@ -0,0 +1,426 @@
+#include <string.h>
+#include <limits.h>
+
+#include "StorageJob.h"
+#include "cycles.h"
+
+/**
+ * @brief Get the I2C address of the memory area (1-byte address parts take the block number from it)
+ * @param storage is the StorageDef data structure
+ * @param memAddress is the memory address
+ * @return the I2C address
+ */
+static uint16_t getDeviceAddress(const StorageDef *storage, uint32_t memAddress) {
+    const StorageDeviceDef *device = storage->device;
+    if (device->addressSize == 1)
+        return (uint16_t) (device->address | ((memAddress >> 8) & 0x07));
+
+    return device->address;
+}
+
+/**
+ * @brief Put the memory address to the transaction buffer (big-endian)
+ * @param storage is the StorageDef data structure
+ * @param memAddress is the memory address
+ * @return the memory address size (bytes)
+ */
+static size_t putAddress(StorageDef *storage, uint32_t memAddress) {
+    size_t size = storage->device->addressSize;
+
+    for (size_t i = 0; i < size; ++i)
+        storage->buffer[i] = (uint8_t) (memAddress >> (8 * (size - 1 - i)));
+    return size;
+}
+
+/**
+ * @brief Get the burst size, the write can't cross the page boundary (the EEPROM wraps around the page)
+ * @param storage is the StorageDef data structure
+ * @param memAddress is the memory address of the burst
+ * @return the maximum burst size (bytes)
+ */
+static size_t getBurstSize(const StorageDef *storage, uint32_t memAddress) {
+    uint32_t page = storage->device->pageSize;
+    if (page == 0 || page > STORAGE_MAX_BURST)
+        page = STORAGE_MAX_BURST;
+
+    return page - (memAddress & (page - 1));
+}
+
+/**
+ * @brief Check, that the I2C request is owned by the bus (the transaction buffer can't be changed)
+ * @param storage is the StorageDef data structure
+ * @return True - the request isn't completed yet, otherwise - False
+ */
+static bool isTransactionPending(const StorageDef *storage) {
+    return I2C_isWriting(&storage->request) || I2C_isReading(&storage->request);
+}
+
+/**
+ * @brief Wait for the completion of the I2C request (the bus completes every queued request, the lost ones too),
+ * but not longer than STORAGE_BUS_WAIT_MS: the request is given up, if the bus task doesn't serve it
+ * @param storage is the StorageDef data structure
+ * @param result is the I2C request submission result
+ * @return I2C_Errors value (I2C_HW_ERROR - the request isn't completed in time)
+ */
+static int32_t waitTransaction(StorageDef *storage, int32_t result) {
+    if (result != I2C_SUCCESS)
+        return result;
+
+    // the request state is checked, not the notification: the late one of a given up request is ignored
+    const TickType_t startTime = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(STORAGE_BUS_WAIT_MS);
+    while (isTransactionPending(storage)) {
+        TickType_t elapsed = xTaskGetTickCount() - startTime;
+        if (elapsed >= timeout)
+            return I2C_HW_ERROR;
+        xTaskNotifyWait(0, ULONG_MAX, NULL, timeout - elapsed);
+    }
+
+    return I2C_getStatus(&storage->request);
+}
+
+/**
+ * @brief Wait for the end of the EEPROM write cycle by ACK polling: the device doesn't acknowledge its address
+ * until the data is written. The probe writes only the memory address (no data), each one is queued behind the
+ * other bus requests.
+ * @param storage is the StorageDef data structure
+ * @param memAddress is the memory address of the burst
+ * @return Storage_Errors value
+ */
+static int32_t waitWriteCycle(StorageDef *storage, uint32_t memAddress) {
+    const StorageDeviceDef *device = storage->device;
+    if (device->type != STORAGE_EEPROM || device->writeTimeMs == 0)
+        return STORAGE_SUCCESS;
+
+    uint32_t start = getCycleCounter();
+    TickType_t startTime = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(device->writeTimeMs) + 1;
+    uint16_t address = getDeviceAddress(storage, memAddress);
+    size_t size = putAddress(storage, memAddress);
+    int32_t status = I2C_NACK;
+
+    storage->request.isProbe = true;
+    while (status == I2C_NACK && (TickType_t) (xTaskGetTickCount() - startTime) <= timeout) {
+        status = waitTransaction(storage, I2C_writeData(storage->bus, &storage->request, address, storage->buffer,
+                                                        size, true));
+        if (status == I2C_NACK)
+            storage->polls++;
+    }
+    storage->request.isProbe = false;
+
+    uint32_t cycles = getCycleCounter() - start;
+    storage->writeCycles += cycles;
+    if (cycles > storage->maxWriteCycles)
+        storage->maxWriteCycles = cycles;
+
+    if (status == I2C_NACK)
+        return STORAGE_TIMEOUT;
+    return (status == I2C_SUCCESS) ? STORAGE_SUCCESS : STORAGE_BUS_ERROR;
+}
+
+/**
+ * @brief Write the burst (the memory address and the data are in the transaction buffer) and wait for the write
+ * cycle
+ * @param storage is the StorageDef data structure
+ * @param memAddress is the memory address of the burst
+ * @param size is the burst size with the memory address (bytes)
+ * @return Storage_Errors value
+ */
+static int32_t writeBurst(StorageDef *storage, uint32_t memAddress, size_t size) {
+    int32_t status = waitTransaction(storage, I2C_writeData(storage->bus, &storage->request,
+                                                            getDeviceAddress(storage, memAddress), storage->buffer,
+                                                            size, true));
+    if (status != I2C_SUCCESS)
+        return STORAGE_BUS_ERROR;
+
+    storage->bursts++;
+    return waitWriteCycle(storage, memAddress);
+}
+
+/**
+ * @brief Save the request result and notify its owner
+ * @param request is the completed request
+ * @param status is Storage_Errors value
+ */
+static void completeRequest(StorageRequestDef *request, int32_t status) {
+    TaskHandle_t task = request->task;
+    uint32_t notification = request->notification;
+
+    request->status = status;
+    request->isPending = false;
+    if (task)
+        xTaskNotify(task, notification, eSetBits);
+}
+
+/**
+ * @brief Take the queued write, that continues the burst (the records are written one after another)
+ * @param storage is the StorageDef data structure
+ * @param memAddress is the memory address after the burst
+ * @return the write request or NULL
+ */
+static StorageRequestDef *takeContiguousWrite(StorageDef *storage, uint32_t memAddress) {
+    StorageRequestDef *next = NULL;
+    if (xQueuePeek(storage->queue, &next, 0) != pdPASS)
+        return NULL;
+    if (next->operation != STORAGE_WRITE || next->memAddress != memAddress)
+        return NULL;
+
+    // the storage task is the only receiver
+    xQueueReceive(storage->queue, &next, 0);
+    storage->batched++;
+    return next;
+}
+
+/**
+ * @brief Write the request by the page-aligned bursts, the contiguous queued writes are merged into them
+ * @param storage is the StorageDef data structure
+ * @param first is the write request
+ */
+static void writeData(StorageDef *storage, StorageRequestDef *first) {
+    StorageRequestDef *batch[STORAGE_MAX_BATCH] = {first};
+    size_t count = 1;
+    size_t offset = 0; // the written bytes of the last request of the batch
+    int32_t status = STORAGE_SUCCESS;
+
+    while (status == STORAGE_SUCCESS && offset < batch[count - 1]->size) {
+        StorageRequestDef *request = batch[count - 1];
+        uint32_t memAddress = request->memAddress + (uint32_t) offset;
+        size_t header = putAddress(storage, memAddress);
+        size_t burst = getBurstSize(storage, memAddress);
+        size_t size = 0;
+
+        while (1) {
+            size_t part = request->size - offset;
+            if (part > burst - size)
+                part = burst - size;
+
+            memcpy(&storage->buffer[header + size], &request->data[offset], part);
+            size += part;
+            offset += part;
+            if (size == burst || count == STORAGE_MAX_BATCH)
+                break;
+
+            StorageRequestDef *next = takeContiguousWrite(storage, memAddress + (uint32_t) size);
+            if (next == NULL)
+                break;
+            batch[count++] = request = next;
+            offset = 0;
+        }
+
+        status = writeBurst(storage, memAddress, header + size);
+        if (status == STORAGE_SUCCESS && offset < request->size) {
+            // the requests before the last one are in the memory
+            for (size_t i = 0; i + 1 < count; ++i)
+                completeRequest(batch[i], STORAGE_SUCCESS);
+            batch[0] = request;
+            count = 1;
+        }
+    }
+
+    if (status != STORAGE_SUCCESS)
+        storage->errors++;
+    for (size_t i = 0; i < count; ++i)
+        completeRequest(batch[i], status);
+}
+
+/**
+ * @brief Read the request by the transactions of STORAGE_MAX_READ bytes (the other bus requests go between them),
+ * then complete it. The given up transaction still owns the request buffer: the request is completed later, when
+ * the bus releases it (the bus task fails the lost transactions).
+ * @param storage is the StorageDef data structure
+ * @param request is the read request
+ */
+static void readData(StorageDef *storage, StorageRequestDef *request) {
+    size_t size = 0;
+
+    for (size_t offset = 0; offset < request->size; offset += size) {
+        uint32_t memAddress = request->memAddress + (uint32_t) offset;
+        size = request->size - offset;
+        if (size > STORAGE_MAX_READ)
+            size = STORAGE_MAX_READ;
+
+        size_t header = putAddress(storage, memAddress);
+        int32_t status = waitTransaction(storage, I2C_writeReadData(storage->bus, &storage->request,
+                                                                    getDeviceAddress(storage, memAddress),
+                                                                    storage->buffer, header,
+                                                                    &request->data[offset], size));
+        if (status != I2C_SUCCESS) {
+            storage->errors++;
+            if (isTransactionPending(storage))
+                storage->abandoned = request;
+            else
+                completeRequest(request, STORAGE_BUS_ERROR);
+            return;
+        }
+    }
+
+    completeRequest(request, STORAGE_SUCCESS);
+}
+
+/**
+ * @brief Storage task, it serves the queued requests one transaction at a time: its priority is lower than the one
+ * of the sensor tasks, so their requests are queued on the bus between the storage transactions
+ * @param arg is the function argument to which the scheduler will send the specified parameter
+ * (while creating the task - StorageDef data structure)
+ */
+static void StorageJob(void *arg) {
+    StorageDef *storage = (StorageDef *) arg;
+    StorageRequestDef *request = NULL;
+
+    I2C_setNotification(&storage->request, xTaskGetCurrentTaskHandle(), STORAGE_NOTIF_I2C_FLAG);
+
+    while (1) {
+        // the given up read is polled for the bus release
+        TickType_t delay = (storage->abandoned) ? pdMS_TO_TICKS(STORAGE_DELAY_MS) : portMAX_DELAY;
+        BaseType_t isReceived = xQueueReceive(storage->queue, &request, delay);
+
+        if (storage->abandoned && !isTransactionPending(storage)) {
+            completeRequest(storage->abandoned, STORAGE_BUS_ERROR);
+            storage->abandoned = NULL;
+        }
+        if (isReceived != pdPASS)
+            continue;
+
+        // the given up transaction still uses the transaction buffer: its completion is waited for once more
+        if (isTransactionPending(storage))
+            waitTransaction(storage, I2C_SUCCESS);
+        if (isTransactionPending(storage)) {
+            storage->errors++;
+            completeRequest(request, STORAGE_BUS_ERROR);
+            continue;
+        }
+        if (storage->abandoned) {
+            completeRequest(storage->abandoned, STORAGE_BUS_ERROR);
+            storage->abandoned = NULL;
+        }
+
+        if (request->operation == STORAGE_WRITE)
+            writeData(storage, request);
+        else
+            readData(storage, request);
+    }
+}
+
+/**
+ * @brief Create the storage task and its queue
+ * @param storage is the StorageDef data structure
+ * @param device is the memory device description
+ * @param bus is the I2C bus of the device
+ * @param priorityLevel is the priority of the storage task (lower than the I2C bus task and the sensor tasks)
+ * @return pointer to the storage task handle
+ */
+TaskHandle_t StorageJobInit(StorageDef *storage, const StorageDeviceDef *device, I2CBusDef *bus,
+                            uint8_t priorityLevel) {
+    if (storage == NULL || device == NULL || bus == NULL || device->addressSize == 0 ||
+        device->addressSize > STORAGE_MAX_ADDRESS_SIZE || (device->pageSize & (device->pageSize - 1)))
+        return NULL;
+
+    storage->device = device;
+    storage->bus = bus;
+    memset(&storage->request, 0, sizeof(I2CRequestDef));
+    storage->abandoned = NULL;
+    storage->bursts = storage->batched = storage->polls = 0;
+    storage->writeCycles = storage->maxWriteCycles = storage->errors = 0;
+    initCycleCounter();
+
+    storage->queue = xQueueCreateStatic(STORAGE_QUEUE_SIZE, sizeof(StorageRequestDef *), storage->queueStorage,
+                                        &storage->queueBuffer);
+    storage->task = xTaskCreateStatic(StorageJob, "storage", configMINIMAL_STACK_SIZE, storage, priorityLevel,
+                                      storage->taskStack, &storage->taskTCB);
+    return storage->task;
+}
+
+/**
+ * @brief Deliver the request completion via the task notification
+ * @param request is the StorageRequestDef data structure
+ * @param task is the task to notify, NULL - no notification
+ * @param notification is the bits to set in the task notification value
+ */
+void StorageSetNotification(StorageRequestDef *request, TaskHandle_t task, uint32_t notification) {
+    request->task = task;
+    request->notification = notification;
+}
+
+/**
+ * @brief Queue the request for the storage task
+ * @param storage is the StorageDef data structure
+ * @param request is the prepared request
+ * @return Storage_Errors value
+ */
+static int32_t submit(StorageDef *storage, StorageRequestDef *request) {
+    if (request->memAddress >= storage->device->size || request->size > storage->device->size - request->memAddress)
+        return STORAGE_WRONG_DATA;
+
+    request->isPending = true;
+    if (xQueueSend(storage->queue, (const void *) &request, pdMS_TO_TICKS(STORAGE_DELAY_MS)) != pdPASS) {
+        request->isPending = false;
+        request->status = STORAGE_QUEUE_FULL;
+        return STORAGE_QUEUE_FULL;
+    }
+    return STORAGE_SUCCESS;
+}
+
+/**
+ * @brief Read the memory (asynchronously)
+ * @param storage is the StorageDef data structure
+ * @param request is the StorageRequestDef data structure (caller-owned, it must not be pending)
+ * @param memAddress is the memory address
+ * @param dst is the destination buffer, it must stay valid until the request is completed
+ * @param size is the data size (bytes)
+ * @return Storage_Errors value
+ */
+int32_t StorageRead(StorageDef *storage, StorageRequestDef *request, uint32_t memAddress, void *dst, size_t size) {
+    if (storage == NULL || request == NULL || dst == NULL || size == 0 || request->isPending)
+        return STORAGE_WRONG_DATA;
+
+    request->operation = STORAGE_READ;
+    request->memAddress = memAddress;
+    request->data = (uint8_t *) dst;
+    request->size = size;
+    return submit(storage, request);
+}
+
+/**
+ * @brief Write the memory (asynchronously), the request is completed after the write cycle
+ * @param storage is the StorageDef data structure
+ * @param request is the StorageRequestDef data structure (caller-owned, it must not be pending)
+ * @param memAddress is the memory address
+ * @param src is the data, it must stay valid until the request is completed
+ * @param size is the data size (bytes)
+ * @return Storage_Errors value
+ */
+int32_t StorageWrite(StorageDef *storage, StorageRequestDef *request, uint32_t memAddress, const void *src,
+                     size_t size) {
+    if (storage == NULL || request == NULL || src == NULL || size == 0 || request->isPending)
+        return STORAGE_WRONG_DATA;
+
+    request->operation = STORAGE_WRITE;
+    request->memAddress = memAddress;
+    request->data = (uint8_t *) src;
+    request->size = size;
+    return submit(storage, request);
+}
+
+/**
+ * @brief Check, that the request isn't completed yet
+ * @param request is the StorageRequestDef data structure
+ * @return True - pending, otherwise - False
+ */
+bool StorageIsPending(const StorageRequestDef *request) {
+    if (request == NULL)
+        return false;
+
+    return request->isPending;
+}
+
+/**
+ * @brief Get the result of the last completed request
+ * @param request is the StorageRequestDef data structure
+ * @return Storage_Errors value
+ */
+int32_t StorageGetStatus(const StorageRequestDef *request) {
+    if (request == NULL)
+        return STORAGE_WRONG_DATA;
+
+    return request->status;
+}
@@ -3,13 +3,50 @@
 #include "jobs.h"
 
 /**
- * @brief ADC interrupt callback function
+ * @brief Get the Serial Port, that owns the UART interface (O(1), see UART_getInterface)
+ * @param huart is the UART handle structure (HAL)
+ * @return the SerialPort data structure or NULL
+ */
+static SerialPortDef *getSerialPort(const UART_HandleTypeDef *huart) {
+    UartDef *uart = UART_getInterface(huart);
+    return (uart) ? (SerialPortDef *) uart->owner : NULL;
+}
+
+/**
+ * @brief Get the I2C bus, that owns the I2C interface (O(1), see I2C_getInterface)
+ * @param hi2c is the I2C handle structure (HAL)
+ * @return the I2CBusDef data structure or NULL
+ */
+static I2CBusDef *getI2CBus(const I2C_HandleTypeDef *hi2c) {
+    I2CDef *i2c = I2C_getInterface(hi2c);
+    return (i2c) ? (I2CBusDef *) i2c->owner : NULL;
+}
+
+/**
+ * @brief ADC half transfer callback function: the first half of the block buffer is filled
+ * @param hadc is the ADC handle structure (HAL)
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+    BaseType_t priorityTaskWoken = pdFALSE;
+
+    if (hadc->Instance == ((ADC_HandleTypeDef *) Application.hardware.adc.handle)->Instance) {
+        Application.hardware.adc.readyHalf = 0;
+        xTaskNotifyFromISR(Application.handles[SENSORS_JOB], JOB_NOTIF_SENSOR_HALF_FLAG, eSetBits,
+                           &priorityTaskWoken);
+    }
+
+    portYIELD_FROM_ISR(priorityTaskWoken);
+}
+
+/**
+ * @brief ADC interrupt callback function: the second half of the block buffer is filled
  * @param hadc is the ADC handle structure (HAL)
  */
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
     if (hadc->Instance == ((ADC_HandleTypeDef *) Application.hardware.adc.handle)->Instance) {
+        Application.hardware.adc.readyHalf = 1;
         xTaskNotifyFromISR(Application.handles[SENSORS_JOB], JOB_NOTIF_SENSOR_FLAG, eSetBits, &priorityTaskWoken);
     }
 
@@ -37,8 +74,9 @@ void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc) {
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (huart->Instance == ((UART_HandleTypeDef *) Serial.uart->handle)->Instance) {
-        xTaskNotifyFromISR(Application.handles[SERIAL_PORT_JOB], SERIAL_NOTIF_TX_FLAG, eSetBits, &priorityTaskWoken);
+    SerialPortDef *port = getSerialPort(huart);
+    if (port && port->task) {
+        xTaskNotifyFromISR(port->task, SERIAL_NOTIF_TX_FLAG, eSetBits, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
@@ -46,26 +84,17 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
 
 /**
  * @brief The reception callback function (Rx event notification called after use of advanced reception service)
+ * (HAL_UART_RXEVENT_HT, HAL_UART_RXEVENT_TC or HAL_UART_RXEVENT_IDLE)
  * @param huart is the UART handle structure (HAL)
- * @param Size is the number of data available in application reception buffer
+ * @param Size is the current DMA position in the application reception buffer
  */
 void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (huart->Instance == ((UART_HandleTypeDef *) Serial.uart->handle)->Instance) {
-        switch (huart->RxEventType) {
-            case HAL_UART_RXEVENT_TC:
-                break;
-            case HAL_UART_RXEVENT_HT:
-                break;
-            case HAL_UART_RXEVENT_IDLE:
-                xStreamBufferSendFromISR(Serial.rxStream, Serial.rxBuffer, Size, &priorityTaskWoken);
-                xTaskNotifyFromISR(Application.handles[SERIAL_PORT_JOB], SERIAL_NOTIF_RX_FLAG, eSetBits,
-                                   &priorityTaskWoken);
-                break;
-            default:
-                break;
-        }
+    SerialPortDef *port = getSerialPort(huart);
+    if (port) {
+        // circular mode: Half Transfer, Transfer Complete and IDLE events bring the new data
+        SerialReceiveFromISR(port, Size, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
@@ -78,8 +107,9 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (huart->Instance == ((UART_HandleTypeDef *) Serial.uart->handle)->Instance) {
-        xTaskNotifyFromISR(Application.handles[SERIAL_PORT_JOB], SERIAL_NOTIF_ERR_FLAG, eSetBits, &priorityTaskWoken);
+    SerialPortDef *port = getSerialPort(huart);
+    if (port && port->task) {
+        xTaskNotifyFromISR(port->task, SERIAL_NOTIF_ERR_FLAG, eSetBits, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
@@ -92,8 +122,9 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
 void HAL_UART_AbortCpltCallback(UART_HandleTypeDef *huart) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (huart->Instance == ((UART_HandleTypeDef *) Serial.uart->handle)->Instance) {
-        xTaskNotifyFromISR(Application.handles[SERIAL_PORT_JOB], SERIAL_NOTIF_ABORT_FLAG, eSetBits, &priorityTaskWoken);
+    SerialPortDef *port = getSerialPort(huart);
+    if (port && port->task) {
+        xTaskNotifyFromISR(port->task, SERIAL_NOTIF_ABORT_FLAG, eSetBits, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
@@ -106,8 +137,9 @@ void HAL_UART_AbortCpltCallback(UART_HandleTypeDef *huart) {
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (hi2c->Instance == ((I2C_HandleTypeDef *) Sensors.interface.i2c->handle)->Instance) {
-        xTaskNotifyFromISR(Application.handles[I2CBUS_JOB], I2CBUS_NOTIF_TX_FLAG, eSetBits, &priorityTaskWoken);
+    I2CBusDef *bus = getI2CBus(hi2c);
+    if (bus) {
+        I2C_completeFromISR(bus, I2CBUS_NOTIF_TX_FLAG, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
@@ -120,8 +152,9 @@ void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
 void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (hi2c->Instance == ((I2C_HandleTypeDef *) Sensors.interface.i2c->handle)->Instance) {
-        xTaskNotifyFromISR(Application.handles[I2CBUS_JOB], I2CBUS_NOTIF_RX_FLAG, eSetBits, &priorityTaskWoken);
+    I2CBusDef *bus = getI2CBus(hi2c);
+    if (bus) {
+        I2C_completeFromISR(bus, I2CBUS_NOTIF_RX_FLAG, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
@@ -134,8 +167,9 @@ void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (hi2c->Instance == ((I2C_HandleTypeDef *) Sensors.interface.i2c->handle)->Instance) {
-        xTaskNotifyFromISR(Application.handles[I2CBUS_JOB], I2CBUS_NOTIF_ERR_FLAG, eSetBits, &priorityTaskWoken);
+    I2CBusDef *bus = getI2CBus(hi2c);
+    if (bus) {
+        I2C_completeFromISR(bus, I2CBUS_NOTIF_ERR_FLAG, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
@@ -148,8 +182,37 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
 void HAL_I2C_AbortCpltCallback(I2C_HandleTypeDef *hi2c) {
     BaseType_t priorityTaskWoken = pdFALSE;
 
-    if (hi2c->Instance == ((I2C_HandleTypeDef *) Sensors.interface.i2c->handle)->Instance) {
-        xTaskNotifyFromISR(Application.handles[I2CBUS_JOB], I2CBUS_NOTIF_ABORT_FLAG, eSetBits, &priorityTaskWoken);
+    I2CBusDef *bus = getI2CBus(hi2c);
+    if (bus) {
+        I2C_completeFromISR(bus, I2CBUS_NOTIF_ABORT_FLAG, &priorityTaskWoken);
+    }
+
+    portYIELD_FROM_ISR(priorityTaskWoken);
+}
+
+/**
+ * @brief FMAC output callback function: the filtered block is in the output buffer
+ * @param hfmac is the FMAC handle structure (HAL)
+ */
+void HAL_FMAC_OutputDataReadyCallback(FMAC_HandleTypeDef *hfmac) {
+    BaseType_t priorityTaskWoken = pdFALSE;
+
+    if (AdcFilter.handle == hfmac) {
+        FilterCompleteFromISR(&AdcFilter, FILTER_SUCCESS, &priorityTaskWoken);
+    }
+
+    portYIELD_FROM_ISR(priorityTaskWoken);
+}
+
+/**
+ * @brief FMAC error callback function
+ * @param hfmac is the FMAC handle structure (HAL)
+ */
+void HAL_FMAC_ErrorCallback(FMAC_HandleTypeDef *hfmac) {
+    BaseType_t priorityTaskWoken = pdFALSE;
+
+    if (AdcFilter.handle == hfmac) {
+        FilterCompleteFromISR(&AdcFilter, FILTER_HW_ERROR, &priorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(priorityTaskWoken);
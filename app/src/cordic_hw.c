@@ -0,0 +1,74 @@
+#include "stm32g4xx_hal.h"
+
+#include "Cordic.h"
+
+// the CORDIC functions and the numbers of the arguments and the results (Cordic_Functions order)
+static const uint32_t functions[CORDIC_NUMBER_FUNCTIONS] = {
+    CORDIC_FUNCTION_COSINE, CORDIC_FUNCTION_PHASE, CORDIC_FUNCTION_MODULUS,
+    CORDIC_FUNCTION_SQUAREROOT, CORDIC_FUNCTION_NATURALLOG,
+};
+
+static const uint32_t scales[CORDIC_MAX_LN_SCALE + 1] = {
+    CORDIC_SCALE_0, CORDIC_SCALE_1, CORDIC_SCALE_2, CORDIC_SCALE_3, CORDIC_SCALE_4,
+};
+
+/**
+ * @brief Set the modulus (ARG2) of the cosine to 1: ARG2 keeps the last written value, the single-argument cosine
+ * would scale the results by the modulus of the last PHASE/MODULUS operation. One dummy operation is calculated
+ * with both arguments (angle 0, modulus 0x7FFFFFFF).
+ * @param handle is the CORDIC handle (HAL)
+ * @param config is the cosine configuration
+ * @return Cordic_Errors value
+ */
+static int32_t Cordic_resetModulus(CORDIC_HandleTypeDef *handle, CORDIC_ConfigTypeDef *config) {
+    int32_t arguments[2] = {0, INT32_MAX};
+    int32_t results[2];
+
+    config->NbWrite = CORDIC_NBWRITE_2;
+    if (HAL_CORDIC_Configure(handle, config) != HAL_OK)
+        return CORDIC_HW_ERROR;
+    if (HAL_CORDIC_CalculateZO(handle, arguments, results, 1, CORDIC_TIMEOUT_MS) != HAL_OK)
+        return CORDIC_HW_ERROR;
+    config->NbWrite = CORDIC_NBWRITE_1;
+    return CORDIC_SUCCESS;
+}
+
+/**
+ * @brief Configure the CORDIC for the function: q1.31 arguments and results, 6 cycles (24 iterations, 20 bits)
+ * @param cordic is the CordicDef data structure
+ * @return Cordic_Errors value
+ */
+int32_t Cordic_configHardware(CordicDef *cordic) {
+    CORDIC_HandleTypeDef *handle = (CORDIC_HandleTypeDef *) cordic->handle;
+    CORDIC_ConfigTypeDef config = {0};
+
+    config.Function = functions[cordic->function];
+    config.Scale = scales[cordic->scale];
+    config.InSize = CORDIC_INSIZE_32BITS;
+    config.OutSize = CORDIC_OUTSIZE_32BITS;
+    config.NbWrite = (CordicGetArguments(cordic->function) == 2) ? CORDIC_NBWRITE_2 : CORDIC_NBWRITE_1;
+    config.NbRead = (CordicGetResults(cordic->function) == 2) ? CORDIC_NBREAD_2 : CORDIC_NBREAD_1;
+    config.Precision = CORDIC_PRECISION_6CYCLES;
+
+    if (cordic->function == CORDIC_SIN_COS && Cordic_resetModulus(handle, &config) != CORDIC_SUCCESS)
+        return CORDIC_HW_ERROR;
+    if (HAL_CORDIC_Configure(handle, &config) != HAL_OK)
+        return CORDIC_HW_ERROR;
+    return CORDIC_SUCCESS;
+}
+
+/**
+ * @brief Calculate the batch in the zero-overhead mode: the next argument is written while the previous result is
+ * calculated, the bus is stalled until the result is ready
+ * @param cordic is the CordicDef data structure
+ * @param src is the arguments (q1.31)
+ * @param dst is the results (q1.31)
+ * @param count is the number of operations
+ * @return Cordic_Errors value
+ */
+int32_t Cordic_calculateHardware(CordicDef *cordic, const int32_t *src, int32_t *dst, size_t count) {
+    if (HAL_CORDIC_CalculateZO((CORDIC_HandleTypeDef *) cordic->handle, (int32_t *) src, dst, (uint32_t) count,
+                               CORDIC_TIMEOUT_MS) != HAL_OK)
+        return CORDIC_HW_ERROR;
+    return CORDIC_SUCCESS;
+}
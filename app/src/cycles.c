@@ -0,0 +1,29 @@
+#include "stm32g4xx_hal.h"
+
+#include "cycles.h"
+
+/**
+ * @brief Start the core cycle counter (DWT CYCCNT), it is only enabled: the modules call it at their start, while
+ * the others measure the intervals (the counter is never reset, only the unsigned differences are used)
+ */
+void initCycleCounter(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Get the current value of the core cycle counter, it wraps around every 2^32 cycles
+ * (use the unsigned difference of two values)
+ * @return the number of the core clock cycles
+ */
+uint32_t getCycleCounter(void) {
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Get the frequency of the cycle counter
+ * @return the core clock frequency (Hz)
+ */
+uint32_t getCycleFrequency(void) {
+    return HAL_RCC_GetHCLKFreq();
+}
@@ -0,0 +1,91 @@
+#include "stm32g4xx_hal.h"
+
+#include "Filter.h"
+
+enum FilterFmac_Constants {
+    FILTER_FMAC_MARGIN = 8, // the extra X1/Y space: the DMA refills and drains the buffers while the filter runs
+};
+
+// the preload of the history: the FMAC starts from the same zero state as the software engine
+static int16_t zeros[FILTER_MAX_TAPS];
+
+/**
+ * @brief Configure the FMAC: the local memory layout, the coefficients and the zero history (the filter is started
+ * with the first block)
+ * @param filter is the FilterDef data structure
+ * @return Filter_Errors value
+ */
+int32_t Filter_configHardware(FilterDef *filter) {
+    FMAC_HandleTypeDef *hfmac = (FMAC_HandleTypeDef *) filter->handle;
+    const FilterConfigDef *config = &filter->config;
+    FMAC_FilterConfigTypeDef fmacInit = {0};
+    uint8_t feedback = (config->type == FILTER_BIQUAD) ? FILTER_BIQUAD_FEEDBACK : 0;
+
+    fmacInit.InputBaseAddress = 0;
+    fmacInit.InputBufferSize = config->taps + FILTER_FMAC_MARGIN;
+    fmacInit.InputThreshold = FMAC_THRESHOLD_1;
+    fmacInit.CoeffBaseAddress = fmacInit.InputBufferSize;
+    fmacInit.CoeffBufferSize = config->taps + feedback;
+    fmacInit.OutputBaseAddress = fmacInit.CoeffBaseAddress + fmacInit.CoeffBufferSize;
+    fmacInit.OutputBufferSize = feedback + FILTER_FMAC_MARGIN;
+    fmacInit.OutputThreshold = FMAC_THRESHOLD_1;
+    fmacInit.pCoeffB = (int16_t *) config->b;
+    fmacInit.CoeffBSize = config->taps;
+    fmacInit.pCoeffA = (feedback) ? (int16_t *) config->a : NULL;
+    fmacInit.CoeffASize = feedback;
+    fmacInit.InputAccess = FMAC_BUFFER_ACCESS_DMA;
+    fmacInit.OutputAccess = FMAC_BUFFER_ACCESS_DMA;
+    fmacInit.Clip = FMAC_CLIP_ENABLED;
+    fmacInit.Filter = (feedback) ? FMAC_FUNC_IIR_DIRECT_FORM_1 : FMAC_FUNC_CONVO_FIR;
+    fmacInit.P = config->taps;
+    fmacInit.Q = feedback;
+    fmacInit.R = config->shift;
+
+    if (HAL_FMAC_FilterConfig(hfmac, &fmacInit) != HAL_OK)
+        return FILTER_HW_ERROR;
+
+    // the first output is calculated, when X1 holds P samples: P - 1 zeros and the first input
+    if (HAL_FMAC_FilterPreload(hfmac, zeros, (uint8_t) (config->taps - 1U), (feedback) ? zeros : NULL,
+                               feedback) != HAL_OK)
+        return FILTER_HW_ERROR;
+
+    filter->isStarted = false;
+    return FILTER_SUCCESS;
+}
+
+/**
+ * @brief Stream the input block through the FMAC: the input and the output DMA, the output completion is reported
+ * by HAL_FMAC_OutputDataReadyCallback
+ * @param filter is the FilterDef data structure
+ * @param size is the number of samples
+ * @return Filter_Errors value
+ */
+int32_t Filter_startHardware(FilterDef *filter, size_t size) {
+    FMAC_HandleTypeDef *hfmac = (FMAC_HandleTypeDef *) filter->handle;
+    HAL_StatusTypeDef result = HAL_ERROR;
+
+    filter->inputSize = filter->outputSize = (uint16_t) size;
+    filter->status = FILTER_SUCCESS;
+
+    // the output buffer is given first, so the DMA drains Y as soon as the first sample is calculated
+    if (!filter->isStarted) {
+        result = HAL_FMAC_FilterStart(hfmac, filter->output, &filter->outputSize);
+        filter->isStarted = (result == HAL_OK);
+    } else {
+        result = HAL_FMAC_ConfigFilterOutputBuffer(hfmac, filter->output, &filter->outputSize);
+    }
+    if (result == HAL_OK)
+        result = HAL_FMAC_AppendFilterData(hfmac, filter->input, &filter->inputSize);
+
+    return (result == HAL_OK) ? FILTER_SUCCESS : FILTER_HW_ERROR;
+}
+
+/**
+ * @brief Stop the FMAC (the error or the timeout) and load the configuration again, the next block starts from the
+ * zero history
+ * @param filter is the FilterDef data structure
+ */
+void Filter_stopHardware(FilterDef *filter) {
+    HAL_FMAC_FilterStop((FMAC_HandleTypeDef *) filter->handle);
+    Filter_configHardware(filter);
+}
@@ -1,6 +1,7 @@
 #include "stm32g4xx_hal.h"
 
 #include "i2c.h"
+#include "cycles.h"
 
 /**
  * @brief I2C interface initialization
@@ -23,7 +24,7 @@ static int32_t I2C_init(I2CDef *i2c) {
  * @param i2c is the base I2C data structure
  * @param addr is the device address on the I2C bus
  * @param src is the source buffer
- * @param size is the required data size (bytes)
+ * @param size is the required data size (bytes), the longer than I2C_MAX_NBYTES ones are reloaded (I2C_startReload)
  * @param isNeedStop
  * @return I2C_Error value
  */
@@ -34,6 +35,10 @@ static int32_t I2C_sendData(I2CDef *i2c, uint16_t addr, const void *src, size_t
     i2c->errType = HAL_I2C_ERROR_NONE;
     i2c->abort = false;
 
+    // HAL restarts DMA for each NBYTES chunk (an interrupt per 255 bytes), the reload engine doesn't
+    if (size > I2C_MAX_NBYTES)
+        return I2C_startReload(i2c, addr, (void *) src, size, false, isNeedStop);
+
     HAL_StatusTypeDef result = HAL_ERROR;
     result = HAL_I2C_Master_Seq_Transmit_DMA((I2C_HandleTypeDef *) i2c->handle, addr << 1,
                                              (uint8_t *) src, (uint16_t) size,
@@ -47,7 +52,7 @@ static int32_t I2C_sendData(I2CDef *i2c, uint16_t addr, const void *src, size_t
  * @param i2c is the base I2C data structure
  * @param addr is the device address on the I2C bus
  * @param dst is the destination buffer
- * @param size is the destination buffer size (bytes)
+ * @param size is the destination buffer size (bytes), the longer than I2C_MAX_NBYTES ones are reloaded
  * @return I2C_Error value
  */
 static int32_t I2C_readData(I2CDef *i2c, uint16_t addr, void *dst, size_t size) {
@@ -57,6 +62,9 @@ static int32_t I2C_readData(I2CDef *i2c, uint16_t addr, void *dst, size_t size)
     i2c->errType = HAL_I2C_ERROR_NONE;
     i2c->abort = false;
 
+    if (size > I2C_MAX_NBYTES)
+        return I2C_startReload(i2c, addr, dst, size, true, true);
+
     HAL_StatusTypeDef result = HAL_ERROR;
     result = HAL_I2C_Master_Seq_Receive_DMA((I2C_HandleTypeDef *) i2c->handle, addr << 1,
                                             (uint8_t *) dst, (uint16_t) size,
@@ -118,10 +126,279 @@ static int32_t I2C_isFailed(const I2CDef *i2c) {
     return (i2c->errType || i2c->abort);
 }
 
-static I2C_HandleTypeDef i2c1Handle;
+/**
+ * @brief Check, that the last error can leave the bus in the undefined state (the recovery is required)
+ * @param i2c is the base I2C data structure
+ * @return True - bus error, arbitration lost or SCL low timeout, otherwise - False
+ */
+static int32_t I2C_isBusStuck(const I2CDef *i2c) {
+    if (i2c == NULL)
+        return I2C_WRONG_DATA;
+
+    return (((uint32_t) i2c->errType) & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_ARLO | HAL_I2C_ERROR_TIMEOUT)) != 0;
+}
+
+/**
+ * @brief Check, that the current transfer is failed only because the target doesn't acknowledge
+ * (it is valid until the next transfer is started)
+ * @param i2c is the base I2C data structure
+ * @return True - NACK, otherwise - False
+ */
+static int32_t I2C_isNack(const I2CDef *i2c) {
+    if (i2c == NULL)
+        return I2C_WRONG_DATA;
+
+    return HAL_I2C_GetError((I2C_HandleTypeDef *) i2c->handle) == HAL_I2C_ERROR_AF;
+}
+
+/**
+ * @brief Get the SCL/SDA pins of the I2C interface
+ * @param instance is the I2C peripheral
+ * @param port is the GPIO port of the pins
+ * @param scl is the SCL pin
+ * @param sda is the SDA pin
+ * @return True - success, otherwise - False
+ */
+static bool I2C_getPins(const I2C_TypeDef *instance, GPIO_TypeDef **port, uint16_t *scl, uint16_t *sda) {
+    if (instance == I2C1) {
+        *port = GPIOB;
+        *scl = GPIO_PIN_8;
+        *sda = GPIO_PIN_9;
+        return true;
+    }
+    if (instance == I2C2) {
+        *port = GPIOA;
+        *scl = GPIO_PIN_9;
+        *sda = GPIO_PIN_8;
+        return true;
+    }
+    if (instance == I2C3) {
+        *port = GPIOC;
+        *scl = GPIO_PIN_8;
+        *sda = GPIO_PIN_9;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Busy wait (the recovery pulses are shorter than the RTOS tick)
+ * @param us is the delay (microseconds)
+ */
+static void I2C_delay(uint32_t us) {
+    uint32_t start = getCycleCounter();
+    uint32_t cycles = (getCycleFrequency() / 1000000) * us;
+    while (getCycleCounter() - start < cycles) {
+    }
+}
+
+/**
+ * @brief Release the stuck bus: stop DMA, reset the interface, clock SCL until a target releases SDA,
+ * generate Stop. The interface must be initialized again (settingI2C).
+ * @param i2c is the base I2C data structure
+ * @return I2C_SUCCESS - SDA is released, otherwise - I2C_HW_ERROR
+ */
+static int32_t I2C_recover(I2CDef *i2c) {
+    if (i2c == NULL)
+        return I2C_WRONG_DATA;
 
-I2CDef I2C1_intf = {
-    &i2c1Handle, false,false, I2C_NOT_INIT, 1,
-    I2C_init, I2C_sendData, I2C_readData,
-    I2C_saveError, I2C_getErrorType, I2C_getNumOfErrors, I2C_isFailed
+    I2C_HandleTypeDef *handle = (I2C_HandleTypeDef *) i2c->handle;
+    GPIO_TypeDef *port = NULL;
+    uint16_t scl = 0, sda = 0;
+    if (!I2C_getPins(handle->Instance, &port, &scl, &sda))
+        return I2C_WRONG_DATA;
+
+    if (handle->hdmatx)
+        HAL_DMA_Abort(handle->hdmatx);
+    if (handle->hdmarx)
+        HAL_DMA_Abort(handle->hdmarx);
+    HAL_I2C_DeInit(handle);
+    i2c->isInit = false;
+
+    // the pins are driven as open-drain GPIO, the input register reads the real line levels
+    GPIO_InitTypeDef gpioInit = {0};
+    gpioInit.Pin = scl | sda;
+    gpioInit.Mode = GPIO_MODE_OUTPUT_OD;
+    gpioInit.Pull = GPIO_PULLUP;
+    gpioInit.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_WritePin(port, scl | sda, GPIO_PIN_SET);
+    HAL_GPIO_Init(port, &gpioInit);
+    I2C_delay(I2C_RECOVERY_HALF_PERIOD_US);
+
+    for (size_t i = 0; i < I2C_RECOVERY_CLOCKS && HAL_GPIO_ReadPin(port, sda) == GPIO_PIN_RESET; ++i) {
+        HAL_GPIO_WritePin(port, scl, GPIO_PIN_RESET);
+        I2C_delay(I2C_RECOVERY_HALF_PERIOD_US);
+        HAL_GPIO_WritePin(port, scl, GPIO_PIN_SET);
+        I2C_delay(I2C_RECOVERY_HALF_PERIOD_US);
+    }
+
+    // Stop: SDA rises while SCL is high
+    HAL_GPIO_WritePin(port, scl, GPIO_PIN_RESET);
+    I2C_delay(I2C_RECOVERY_HALF_PERIOD_US);
+    HAL_GPIO_WritePin(port, sda, GPIO_PIN_RESET);
+    I2C_delay(I2C_RECOVERY_HALF_PERIOD_US);
+    HAL_GPIO_WritePin(port, scl, GPIO_PIN_SET);
+    I2C_delay(I2C_RECOVERY_HALF_PERIOD_US);
+    HAL_GPIO_WritePin(port, sda, GPIO_PIN_SET);
+    I2C_delay(I2C_RECOVERY_HALF_PERIOD_US);
+
+    i2c->abort = false;
+    return (HAL_GPIO_ReadPin(port, sda) == GPIO_PIN_SET) ? I2C_SUCCESS : I2C_HW_ERROR;
+}
+
+typedef struct {
+    uint32_t rateHz;
+    uint16_t holdMinNs; // tHD;DAT min
+    uint16_t validMaxNs; // tVD;DAT max
+    uint16_t setupMinNs; // tSU;DAT min
+    uint16_t lowMinNs; // tLOW min
+    uint16_t highMinNs; // tHIGH min
+    uint16_t riseMaxNs;
+    uint16_t fallMaxNs;
+} I2CSpecDef;
+
+// I2C-bus specification (UM10204), table 10
+static const I2CSpecDef i2cSpecs[] = {
+    {I2C_STANDARD_MODE_HZ, 0, 3450, 250, 4700, 4000, 1000, 300},
+    {I2C_FAST_MODE_HZ, 0, 900, 100, 1300, 600, 300, 300},
+    {I2C_FAST_MODE_PLUS_HZ, 0, 450, 50, 500, 260, 120, 120},
+};
+
+enum I2CTiming_Constants {
+    I2C_ANALOG_FILTER_MIN_NS = 50, // the analog filter delay (datasheet)
+    I2C_ANALOG_FILTER_MAX_NS = 260,
+    I2C_PRESC_MAX = 16,
+    I2C_SCLDEL_MAX = 16,
+    I2C_SDADEL_MAX = 16,
+    I2C_SCLL_MAX = 256,
+    I2C_SCLH_MAX = 256,
+    I2C_MIN_RATE_PERCENT = 80, // the lowest acceptable SCL frequency (of the required one)
+    I2C_PS_PER_NS = 1000,
 };
+
+#define I2C_PS_PER_SECOND 1000000000000ULL
+
+/**
+ * @brief Calculate the TIMINGR register value (RM0440, "I2C timings"): the data setup/hold delays satisfy the bus
+ * specification, the SCL low/high periods give the frequency closest to the required one
+ * @param clockHz is the I2C kernel clock (I2CCLK)
+ * @param config is the bus parameters
+ * @param timing is the TIMINGR value
+ * @return I2C_SUCCESS or I2C_WRONG_DATA (no valid settings)
+ */
+int32_t I2C_computeTiming(uint32_t clockHz, const I2CTimingDef *config, uint32_t *timing) {
+    if (clockHz == 0 || config == NULL || timing == NULL || config->speedHz == 0 || config->digitalFilter > 15)
+        return I2C_WRONG_DATA;
+
+    const I2CSpecDef *spec = NULL;
+    for (size_t i = 0; i < sizeof(i2cSpecs) / sizeof(i2cSpecs[0]) && spec == NULL; ++i) {
+        if (config->speedHz <= i2cSpecs[i].rateHz)
+            spec = &i2cSpecs[i];
+    }
+    if (spec == NULL || config->riseTimeNs > spec->riseMaxNs || config->fallTimeNs > spec->fallMaxNs)
+        return I2C_WRONG_DATA;
+
+    // picoseconds: the rounded I2CCLK period (62.5 ns at HSI, 6.94 ns at SYSCLK) would shift the limits
+    const int64_t clockPs = (int64_t) (I2C_PS_PER_SECOND / clockHz);
+    const int64_t busPs = (int64_t) (I2C_PS_PER_SECOND / config->speedHz);
+    const int64_t filterMin = (config->isAnalogFilter) ? I2C_ANALOG_FILTER_MIN_NS * I2C_PS_PER_NS : 0;
+    const int64_t filterMax = (config->isAnalogFilter) ? I2C_ANALOG_FILTER_MAX_NS * I2C_PS_PER_NS : 0;
+    const int64_t dnf = config->digitalFilter;
+    const int64_t rise = (int64_t) config->riseTimeNs * I2C_PS_PER_NS;
+    const int64_t fall = (int64_t) config->fallTimeNs * I2C_PS_PER_NS;
+    const int64_t lowMin = (int64_t) spec->lowMinNs * I2C_PS_PER_NS;
+    const int64_t highMin = (int64_t) spec->highMinNs * I2C_PS_PER_NS;
+
+    // the data hold (SDADEL) and setup (SCLDEL) delays
+    int64_t sdadelMin = fall - spec->holdMinNs * I2C_PS_PER_NS - filterMin - (dnf + 3) * clockPs;
+    int64_t sdadelMax = spec->validMaxNs * I2C_PS_PER_NS - rise - filterMax - (dnf + 4) * clockPs;
+    int64_t scldelMin = rise + spec->setupMinNs * I2C_PS_PER_NS;
+    if (sdadelMin < 0)
+        sdadelMin = 0;
+    if (sdadelMax < 0)
+        sdadelMax = 0;
+
+    // the SCL period: tLOW + tHIGH + rise + fall, tLOW/tHIGH include the synchronization delay (the shortest one, so
+    // the frequency never exceeds the required one)
+    const int64_t periodMin = busPs;
+    const int64_t periodMax =
+        (int64_t) (I2C_PS_PER_SECOND * 100U / ((uint64_t) config->speedHz * I2C_MIN_RATE_PERCENT));
+    const int64_t sync = filterMin + dnf * clockPs + 2 * clockPs;
+
+    int64_t bestError = INT64_MAX;
+    for (int32_t presc = 0; presc < I2C_PRESC_MAX; ++presc) {
+        const int64_t prescPs = (presc + 1) * clockPs;
+
+        // the shortest delays for this prescaler
+        int32_t scldel = -1, sdadel = -1;
+        for (int32_t l = 0; l < I2C_SCLDEL_MAX && scldel < 0; ++l) {
+            if ((l + 1) * prescPs >= scldelMin)
+                scldel = l;
+        }
+        for (int32_t a = 0; a < I2C_SDADEL_MAX && sdadel < 0; ++a) {
+            int64_t delay = (a * (presc + 1) + 1) * clockPs;
+            if (delay >= sdadelMin && delay <= sdadelMax)
+                sdadel = a;
+        }
+        if (scldel < 0 || sdadel < 0)
+            continue;
+
+        for (int32_t l = 0; l < I2C_SCLL_MAX; ++l) {
+            const int64_t low = (l + 1) * prescPs + sync;
+            if (low < lowMin || clockPs >= (low - filterMin - dnf * clockPs) / 4)
+                continue;
+
+            // the high period, which gives the closest SCL period: the nearest two values
+            int32_t h = (int32_t) ((busPs - low - rise - fall - sync) / prescPs) - 1;
+            for (int32_t k = h; k <= h + 1; ++k) {
+                if (k < 0 || k >= I2C_SCLH_MAX)
+                    continue;
+
+                const int64_t high = (k + 1) * prescPs + sync;
+                const int64_t period = low + high + rise + fall;
+                if (period < periodMin || period > periodMax || high < highMin || high <= clockPs)
+                    continue;
+
+                int64_t error = (period > busPs) ? period - busPs : busPs - period;
+                if (error < bestError) {
+                    bestError = error;
+                    *timing = ((uint32_t) presc << 28) | ((uint32_t) scldel << 20) | ((uint32_t) sdadel << 16) |
+                              ((uint32_t) k << 8) | (uint32_t) l;
+                }
+            }
+        }
+    }
+
+    return (bestError == INT64_MAX) ? I2C_WRONG_DATA : I2C_SUCCESS;
+}
+
+// the handles are stored in the table, so an interrupt callback finds its interface by the handle address
+static I2C_HandleTypeDef i2cHandles[I2C_NUMBER_INTERFACES];
+
+#define I2C_INTERFACE(index) { \
+    &i2cHandles[index], NULL, false, false, I2C_NOT_INIT, 1, \
+    I2C_init, I2C_sendData, I2C_readData, \
+    I2C_saveError, I2C_getErrorType, I2C_getNumOfErrors, I2C_isFailed, \
+    I2C_isBusStuck, I2C_isNack, I2C_recover, {0} \
+}
+
+I2CDef I2C1_intf = I2C_INTERFACE(I2C1_INDEX);
+I2CDef I2C2_intf = I2C_INTERFACE(I2C2_INDEX);
+I2CDef I2C3_intf = I2C_INTERFACE(I2C3_INDEX); // the target (slave) interface, see I2CTarget.h
+
+static I2CDef *const i2cInterfaces[I2C_NUMBER_INTERFACES] = {
+    &I2C1_intf, &I2C2_intf, &I2C3_intf,
+};
+
+/**
+ * @brief Get the I2C interface by its handle (O(1), without the instance comparison)
+ * @param handle is the I2C handle structure (HAL)
+ * @return the base I2C data structure or NULL
+ */
+I2CDef *I2C_getInterface(const void *handle) {
+    const I2C_HandleTypeDef *hi2c = (const I2C_HandleTypeDef *) handle;
+    if (hi2c < i2cHandles || hi2c >= i2cHandles + I2C_NUMBER_INTERFACES)
+        return NULL;
+
+    return i2cInterfaces[hi2c - i2cHandles];
+}
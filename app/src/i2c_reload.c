@@ -0,0 +1,219 @@
+#include "stm32g4xx_hal.h"
+
+#include "i2c.h"
+
+// the HAL private I2C_STATE_xxx values: the HAL error handler (I2C_ITError) aborts DMA of this direction
+enum I2CReload_States {
+    I2C_RELOAD_STATE_NONE = HAL_I2C_MODE_NONE,
+    I2C_RELOAD_STATE_TX = HAL_I2C_MODE_MASTER | (HAL_I2C_STATE_BUSY_TX & 0x03),
+    I2C_RELOAD_STATE_RX = HAL_I2C_MODE_MASTER | (HAL_I2C_STATE_BUSY_RX & 0x03),
+};
+
+static void I2C_reloadDMAError(DMA_HandleTypeDef *hdma);
+
+/**
+ * @brief Get the DMA channel of the transfer direction
+ * @param hi2c is the I2C handle structure (HAL)
+ * @param reload is the transfer
+ * @return the DMA handle structure (HAL)
+ */
+static DMA_HandleTypeDef *I2C_getReloadDMA(const I2C_HandleTypeDef *hi2c, const I2CReloadDef *reload) {
+    return (reload->isRead) ? hi2c->hdmarx : hi2c->hdmatx;
+}
+
+/**
+ * @brief Give the next segment of the buffer to DMA (CNDTR is 16 bits), SCL is stretched meanwhile
+ * @param hi2c is the I2C handle structure (HAL)
+ * @param reload is the transfer
+ * @return HAL status
+ */
+static HAL_StatusTypeDef I2C_startReloadDMA(I2C_HandleTypeDef *hi2c, I2CReloadDef *reload) {
+    DMA_HandleTypeDef *hdma = I2C_getReloadDMA(hi2c, reload);
+    uint32_t size = (reload->dmaLeft > I2C_MAX_DMA_SIZE) ? I2C_MAX_DMA_SIZE : (uint32_t) reload->dmaLeft;
+    uint32_t memory = (uint32_t) (uintptr_t) reload->data;
+
+    HAL_StatusTypeDef result = HAL_ERROR;
+    if (reload->isRead)
+        result = HAL_DMA_Start_IT(hdma, (uint32_t) (uintptr_t) &hi2c->Instance->RXDR, memory, size);
+    else
+        result = HAL_DMA_Start_IT(hdma, memory, (uint32_t) (uintptr_t) &hi2c->Instance->TXDR, size);
+
+    if (result == HAL_OK) {
+        reload->data += size;
+        reload->dmaLeft -= size;
+    }
+    return result;
+}
+
+/**
+ * @brief Take the next NBYTES chunk: RELOAD while the data is left, AUTOEND (Stop) after the last one
+ * @param reload is the transfer
+ * @return the NBYTES, RELOAD and AUTOEND fields of CR2
+ */
+static uint32_t I2C_getReloadChunk(I2CReloadDef *reload) {
+    uint32_t cr2 = 0;
+    size_t size = reload->left;
+
+    if (size > I2C_MAX_NBYTES) {
+        size = I2C_MAX_NBYTES;
+        cr2 |= I2C_CR2_RELOAD;
+    } else if (reload->isNeedStop) {
+        cr2 |= I2C_CR2_AUTOEND;
+    }
+
+    reload->left -= size;
+    return cr2 | ((uint32_t) size << I2C_CR2_NBYTES_Pos);
+}
+
+/**
+ * @brief Finish the transfer and call the HAL completion (or error) callback
+ * @param hi2c is the I2C handle structure (HAL)
+ * @param reload is the transfer
+ * @param isStopped flag, True - Stop is generated, False - the bus is held for the repeated start
+ */
+static void I2C_finishReload(I2C_HandleTypeDef *hi2c, I2CReloadDef *reload, bool isStopped) {
+    hi2c->Instance->CR1 &= ~(I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | I2C_CR1_ERRIE |
+                             I2C_CR1_TXDMAEN | I2C_CR1_RXDMAEN);
+    if (hi2c->ErrorCode != HAL_I2C_ERROR_NONE)
+        HAL_DMA_Abort(I2C_getReloadDMA(hi2c, reload));
+
+    // the byte prefetched by DMA isn't sent
+    hi2c->Instance->ISR = I2C_ISR_TXE;
+
+    hi2c->XferISR = NULL;
+    hi2c->State = HAL_I2C_STATE_READY;
+    hi2c->Mode = HAL_I2C_MODE_NONE;
+    hi2c->PreviousState = (isStopped) ? I2C_RELOAD_STATE_NONE : I2C_RELOAD_STATE_TX;
+
+    if (hi2c->ErrorCode != HAL_I2C_ERROR_NONE)
+        HAL_I2C_ErrorCallback(hi2c);
+    else if (reload->isRead)
+        HAL_I2C_MasterRxCpltCallback(hi2c);
+    else
+        HAL_I2C_MasterTxCpltCallback(hi2c);
+}
+
+/**
+ * @brief Serve the event interrupt of the reloaded transfer (HAL_I2C_EV_IRQHandler calls it via XferISR)
+ * @param hi2c is the I2C handle structure (HAL)
+ * @param ITFlags is the ISR register
+ * @param ITSources is the CR1 register
+ * @return HAL status
+ */
+static HAL_StatusTypeDef I2C_reloadISR(struct __I2C_HandleTypeDef *hi2c, uint32_t ITFlags, uint32_t ITSources) {
+    (void) ITSources;
+    I2CDef *i2c = I2C_getInterface(hi2c);
+    if (i2c == NULL)
+        return HAL_ERROR;
+
+    I2CReloadDef *reload = &i2c->reload;
+
+    // the target doesn't acknowledge: the controller generates Stop automatically
+    if (ITFlags & I2C_ISR_NACKF) {
+        hi2c->Instance->ICR = I2C_ICR_NACKCF;
+        hi2c->ErrorCode |= HAL_I2C_ERROR_AF;
+    }
+
+    if (ITFlags & I2C_ISR_STOPF) {
+        hi2c->Instance->ICR = I2C_ICR_STOPCF;
+        I2C_finishReload(hi2c, reload, true);
+        return HAL_OK;
+    }
+
+    if (ITFlags & I2C_ISR_TCR) {
+        // SCL is stretched until NBYTES is written, DMA keeps running
+        MODIFY_REG(hi2c->Instance->CR2, I2C_CR2_NBYTES | I2C_CR2_RELOAD | I2C_CR2_AUTOEND,
+                   I2C_getReloadChunk(reload));
+        reload->reloads++;
+    } else if (ITFlags & I2C_ISR_TC) {
+        // the last chunk without Stop (the write phase of the write-then-read transaction)
+        I2C_finishReload(hi2c, reload, false);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief DMA segment is done: start the next one (the transfers longer than I2C_MAX_DMA_SIZE)
+ * @param hdma is the DMA handle structure (HAL)
+ */
+static void I2C_reloadDMAComplete(DMA_HandleTypeDef *hdma) {
+    I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *) hdma->Parent;
+    I2CDef *i2c = I2C_getInterface(hi2c);
+
+    if (i2c && i2c->reload.dmaLeft && hi2c->XferISR == I2C_reloadISR) {
+        if (I2C_startReloadDMA(hi2c, &i2c->reload) != HAL_OK)
+            I2C_reloadDMAError(hdma);
+    }
+}
+
+/**
+ * @brief DMA error: Stop ends the transfer, the error is reported by the STOPF interrupt
+ * @param hdma is the DMA handle structure (HAL)
+ */
+static void I2C_reloadDMAError(DMA_HandleTypeDef *hdma) {
+    I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *) hdma->Parent;
+
+    hi2c->ErrorCode |= HAL_I2C_ERROR_DMA;
+    hi2c->Instance->CR2 |= I2C_CR2_STOP;
+}
+
+/**
+ * @brief Start the transfer of any length (the controller mode, DMA): one Start, the data is read or written by one
+ * DMA stream (a segment per I2C_MAX_DMA_SIZE bytes), NBYTES is reloaded every I2C_MAX_NBYTES bytes by the TCR
+ * interrupt. The completion is reported by the HAL callbacks (HAL_I2C_MasterTxCpltCallback, ...), the bus errors -
+ * by HAL_I2C_ER_IRQHandler.
+ * @param i2c is the base I2C data structure
+ * @param addr is the device address on the I2C bus
+ * @param data is the source or destination buffer, it must stay valid until the transfer is completed
+ * @param size is the data size (bytes)
+ * @param isRead flag, True - read, otherwise - write
+ * @param isNeedStop flag, True - generate Stop after the data, False - the bus is held (the write phase only)
+ * @return I2C_Error value
+ */
+int32_t I2C_startReload(I2CDef *i2c, uint16_t addr, void *data, size_t size, bool isRead, bool isNeedStop) {
+    if (i2c == NULL || data == NULL || size == 0)
+        return I2C_WRONG_DATA;
+
+    I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *) i2c->handle;
+    I2CReloadDef *reload = &i2c->reload;
+    if (hi2c->State != HAL_I2C_STATE_READY)
+        return I2C_HW_ERROR;
+
+    reload->data = (uint8_t *) data;
+    reload->left = reload->dmaLeft = size;
+    reload->isRead = isRead;
+    reload->isNeedStop = isRead || isNeedStop;
+
+    DMA_HandleTypeDef *hdma = I2C_getReloadDMA(hi2c, reload);
+    if (hdma == NULL)
+        return I2C_NOT_INIT;
+
+    hi2c->State = (isRead) ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+    hi2c->Mode = HAL_I2C_MODE_MASTER;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->PreviousState = (isRead) ? I2C_RELOAD_STATE_RX : I2C_RELOAD_STATE_TX;
+    hi2c->XferISR = I2C_reloadISR;
+
+    hdma->XferCpltCallback = I2C_reloadDMAComplete;
+    hdma->XferHalfCpltCallback = NULL;
+    hdma->XferErrorCallback = I2C_reloadDMAError;
+    hdma->XferAbortCallback = NULL;
+    if (I2C_startReloadDMA(hi2c, reload) != HAL_OK) {
+        hi2c->XferISR = NULL;
+        hi2c->State = HAL_I2C_STATE_READY;
+        hi2c->Mode = HAL_I2C_MODE_NONE;
+        return I2C_HW_ERROR;
+    }
+
+    // the first chunk and the (repeated) Start
+    uint32_t cr2 = I2C_getReloadChunk(reload) | (((uint32_t) addr << 1) & I2C_CR2_SADD) | I2C_CR2_START;
+    if (isRead)
+        cr2 |= I2C_CR2_RD_WRN;
+
+    hi2c->Instance->CR1 |= I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | I2C_CR1_ERRIE |
+                           ((isRead) ? I2C_CR1_RXDMAEN : I2C_CR1_TXDMAEN);
+    MODIFY_REG(hi2c->Instance->CR2, I2C_CR2_SADD | I2C_CR2_NBYTES | I2C_CR2_RELOAD | I2C_CR2_AUTOEND |
+                                    I2C_CR2_RD_WRN | I2C_CR2_START | I2C_CR2_STOP, cr2);
+    return I2C_SUCCESS;
+}
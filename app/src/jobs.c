@@ -4,21 +4,61 @@
 
 #include "jobs.h"
 #include "utilities.h"
+#include "SerialPacket.h"
 
 static StaticTask_t task1CB;
 static StackType_t task1Stack[configMINIMAL_STACK_SIZE];
 static StaticTask_t task2CB;
 static StackType_t task2Stack[configMINIMAL_STACK_SIZE];
 static StaticTask_t task3CB;
-static StackType_t task3Stack[configMINIMAL_STACK_SIZE];
+static StackType_t task3Stack[configMINIMAL_STACK_SIZE * 2];
 static StaticTask_t task4CB;
 static StackType_t task4Stack[configMINIMAL_STACK_SIZE];
 
+// the high-rate data link (packets) and the debug console (binary log records)
+SERIAL_PORT_BUFFERS(serialBuffers, SERIAL_PORT_STREAM_SIZE, SERIAL_PORT_STREAM_SIZE, SERIAL_FRAMES_STORAGE_SIZE);
+SERIAL_PORT_BUFFERS(consoleBuffers, SERIAL_PORT_BUFFER_SIZE, LOGGER_BUFFER_SIZE, 0);
+
+#ifdef KERNEL_BENCHMARK
+static KernelBenchDef kernelBench;
+#endif
+#ifdef I2C_BENCHMARK
+static I2CBenchDef i2cBench; // the read buffer is large
+#endif
+#ifdef MATH_BENCHMARK
+static MathBenchDef mathBench;
+#endif
+#ifdef DSP_BENCHMARK
+static DspBenchDef dspBench;
+#endif
+
 static StaticTask_t idleCB;
 static StackType_t idleStack[configMINIMAL_STACK_SIZE];
 static StaticTask_t timerCB;
 static StackType_t timerStack[configTIMER_TASK_STACK_DEPTH];
 
+// 24xx512 EEPROM, the 5 ms write cycle is the datasheet maximum (the end is detected by ACK polling)
+static const StorageDeviceDef storageDevice = {STORAGE_EEPROM, 0x50, 65536, 128, 2, 5};
+
+// the analog inputs: 25 kHz / 64 = 390.6 Hz, the temperature sensor: 25 kHz / 256 = 97.7 Hz
+static const DecimatorStagesDef adcStages[NUMBER_ADC_CHANNELS] = {{4, 2}, {4, 2}, {5, 3}};
+static DecimatorDef adcDecimator;
+
+// the analog input 1 stream: 15-tap low-pass FIR (Hamming window), 1 kHz cut-off at 25 kHz, DC gain - 1
+static const int16_t adcFilterTaps[] = {209, 388, 895, 1717, 2725, 3702, 4412, 4671,
+                                        4412, 3702, 2725, 1717, 895, 388, 209};
+static const FilterConfigDef adcFilterConfig = {FILTER_FIR, sizeof(adcFilterTaps) / sizeof(adcFilterTaps[0]), 0,
+                                                adcFilterTaps, NULL};
+
+// the filtered analog input 1: the last block (q1.15)
+typedef struct {
+    int16_t last;
+    DspStatsDef stats;
+    int16_t rms;
+} FilteredInputDef;
+
+static FilteredInputDef filteredInput;
+
 /**
  * @brief Routine task
  * @param arg is the function argument to which the scheduler will send the specified parameter
@@ -27,8 +67,23 @@ static void routineJob(void *arg) {
     McuDef *mcu = (McuDef *) arg;
 
     const TickType_t delay = pdMS_TO_TICKS(ROUTINE_DELAY_MS);
-
-    const char *text = "[Thread 0] Push the button\n\r";
+    uint32_t counter = 0;
+    uint32_t loaded = 0; // the read destination, the late read writes it (not the counter)
+    uint32_t stored = 0; // the write source, it is valid until the request is completed
+    uint32_t notificationValue = 0;
+    StorageRequestDef request = {0};
+
+    // the button counter survives the reset, the read is waited for as long as the storage task can wait for the bus
+    StorageSetNotification(&request, xTaskGetCurrentTaskHandle(), JOB_NOTIF_STORAGE_FLAG);
+    if (StorageRead(&Storage, &request, STORAGE_ADDR_BUTTON_COUNTER, &loaded, sizeof(loaded)) == STORAGE_SUCCESS) {
+        const TickType_t start = xTaskGetTickCount();
+        while (StorageIsPending(&request) && xTaskGetTickCount() - start < pdMS_TO_TICKS(STORAGE_WAIT_MS)) {
+            HAL_IWDG_Refresh((IWDG_HandleTypeDef *) mcu->handles.wdt);
+            xTaskNotifyWait(0, ULONG_MAX, &notificationValue, delay);
+        }
+    }
+    if (!StorageIsPending(&request) && StorageGetStatus(&request) == STORAGE_SUCCESS && loaded != UINT32_MAX)
+        counter = loaded;
 
     while (1) {
         vTaskDelay(delay);
@@ -38,11 +93,89 @@ static void routineJob(void *arg) {
         checkPinState(&mcu->button);
         if (isPinTriggered(&mcu->button)) {
             mcu->button.isTriggered = false;
-            SerialWriteData(&Serial, text, 28);
+            LOG("[Thread 0] Push the button (%u)\n\r", ++counter);
+
+            // the previous write isn't waited for, the next push saves the counter
+            if (!StorageIsPending(&request)) {
+                stored = counter;
+                StorageWrite(&Storage, &request, STORAGE_ADDR_BUTTON_COUNTER, &stored, sizeof(stored));
+            }
         }
     }
 }
 
+/**
+ * @brief Put the 32-bit value to the buffer (little-endian)
+ * @param dst is the destination buffer
+ * @param value is the target value
+ */
+static void putValue(uint8_t *dst, uint32_t value) {
+    for (size_t i = 0; i < sizeof(value); ++i)
+        dst[i] = (uint8_t) (value >> (8 * i));
+}
+
+// the controller can change only the PWM duty cycle
+static const uint8_t targetWritable[I2C_TARGET_MAP_SIZE] = {[TARGET_REG_PWM_CONTROL] = 1};
+
+/**
+ * @brief Publish the measured values via the I2C target register map (one snapshot)
+ * @param mcu is the base MCU data structure
+ * @param duty is the current PWM duty cycle (%)
+ * @param isFixed is True - the duty cycle is set by the controller
+ * @param updates is the update counter
+ */
+static void updateTarget(const McuDef *mcu, uint8_t duty, bool isFixed, uint32_t updates) {
+    uint8_t values[NUMBER_TARGET_REGISTERS] = {0};
+
+    values[TARGET_REG_STATUS] = TARGET_STATUS_READY;
+    if (mcu->adc.errors)
+        values[TARGET_REG_STATUS] |= TARGET_STATUS_ADC_ERROR;
+    if (isFixed)
+        values[TARGET_REG_STATUS] |= TARGET_STATUS_PWM_FIXED;
+
+    for (size_t i = 0; i < 2; ++i) {
+        values[TARGET_REG_ANALOG_IN_1 + 2 * i] = (uint8_t) mcu->adc.values[ANALOG_IN_1 + i];
+        values[TARGET_REG_ANALOG_IN_1 + 2 * i + 1] = (uint8_t) (mcu->adc.values[ANALOG_IN_1 + i] >> 8);
+    }
+    values[TARGET_REG_TEMPERATURE] = (uint8_t) mcu->temp;
+    values[TARGET_REG_TEMPERATURE + 1] = (uint8_t) ((uint32_t) mcu->temp >> 8);
+    values[TARGET_REG_PWM_DUTY] = duty;
+    putValue(&values[TARGET_REG_UPDATES], updates);
+
+    I2CTargetUpdate(&Target, TARGET_REG_STATUS, &values[TARGET_REG_STATUS],
+                    TARGET_REG_PWM_CONTROL - TARGET_REG_STATUS);
+}
+
+/**
+ * @brief Keep the range, the mean and RMS of the filtered block (FilterFun_output)
+ * @param samples is the filtered block (q1.15)
+ * @param size is the number of samples
+ * @param arg is the FilteredInputDef data structure
+ */
+static void keepFilteredBlock(const int16_t *samples, size_t size, void *arg) {
+    FilteredInputDef *input = (FilteredInputDef *) arg;
+
+    DspStatsQ15(samples, size, &input->stats);
+    DspRmsQ15(samples, size, &input->rms);
+    input->last = samples[size - 1];
+}
+
+/**
+ * @brief Pass the ADC block through the decimation chains and the analog input 1 filter (AdcFun_block)
+ * @param samples is the block: scans of NUMBER_ADC_CHANNELS samples
+ * @param scans is the number of scans
+ * @param arg is the DecimatorDef data structure
+ */
+static void processBlock(const uint16_t *samples, size_t scans, void *arg) {
+    DecimatorProcess((DecimatorDef *) arg, samples, scans);
+
+    // the unsigned samples are q1.15 in [0, 1), the FMAC streams them while the task sleeps
+    int16_t *input = FilterGetInput(&AdcFilter);
+    for (size_t i = 0; i < scans; ++i)
+        input[i] = (int16_t) (samples[i * NUMBER_ADC_CHANNELS + ANALOG_IN_1] << (15 - ADC_SAMPLE_BITS));
+    FilterProcess(&AdcFilter, scans);
+}
+
 /**
  * @brief Sensors task
  * @param arg is the function argument to which the scheduler will send the specified parameter
@@ -50,38 +183,55 @@ static void routineJob(void *arg) {
 static void sensorsJob(void *arg) {
     McuDef *mcu = (McuDef *) arg;
 
-    const TickType_t delay = pdMS_TO_TICKS(SENSORS_DELAY_MS);
     const TickType_t notifDelay = pdMS_TO_TICKS(SENSORS_NOTIF_DELAY_MS);
     BaseType_t result = pdFALSE;
     uint32_t notificationValue = 0;
+    uint32_t updates = 0;
+
+    // hardware oversampling (14 bits), then CIC and half-band stages in software (16-bit outputs)
+    DecimatorInit(&adcDecimator, adcStages, NUMBER_ADC_CHANNELS, ADC_SAMPLE_BITS);
+    mcu->adc.process = processBlock;
+    mcu->adc.arg = &adcDecimator;
+
+    if (FilterInit(&AdcFilter, &adcFilterConfig, mcu->handles.fmac) == FILTER_HW_ERROR)
+        LOG("[Sensors] FMAC isn't configured, the software filter is used\n\r");
+    FilterAddConsumer(&AdcFilter, keepFilteredBlock, &filteredInput);
 
     HAL_TIM_Base_Start((TIM_HandleTypeDef *) mcu->adc.timer.handle);
-    HAL_ADC_Start_DMA((ADC_HandleTypeDef *) mcu->adc.handle, mcu->adc.rawValues, NUMBER_ADC_CHANNELS);
+    startADCBlocks(&mcu->adc, SENSORS_BLOCK_SCANS);
     HAL_TIM_PWM_Start((TIM_HandleTypeDef *) mcu->pwm.handle, TIM_CHANNEL_1);
     HAL_TIMEx_PWMN_Start((TIM_HandleTypeDef *) mcu->pwm.handle, TIM_CHANNEL_1);
 
     while (1) {
-        vTaskDelay(delay);
-
+        // each block is processed while the DMA fills the other half of the buffer
         result = xTaskNotifyWait(0x00, ULONG_MAX, &notificationValue, notifDelay);
         if (result == pdTRUE) {
-            if (notificationValue & JOB_NOTIF_SENSOR_FLAG) {
-                // calculate the analog input pins values
+            if (notificationValue & (JOB_NOTIF_SENSOR_HALF_FLAG | JOB_NOTIF_SENSOR_FLAG)) {
+                // both halves are filled: the older one is being overwritten, only the last one is taken
+                if ((notificationValue & JOB_NOTIF_SENSOR_HALF_FLAG) && (notificationValue & JOB_NOTIF_SENSOR_FLAG))
+                    mcu->adc.overruns++;
+                processADCBlock(&mcu->adc);
+
+                // calculate the analog input pins values (the decimated outputs: 65535 - VDD)
                 uint32_t value = 0;
                 for (size_t i = 0; i < (NUMBER_ADC_CHANNELS - 1); ++i) {
-                    value = mcu->adc.rawValues[i];
-                    value = (value * VDD_VALUE) >> 12;
+                    value = DecimatorGetOutput(&adcDecimator, i);
+                    value = (value * VDD_VALUE) >> DECIMATOR_OUTPUT_BITS;
                     mcu->adc.values[i] = (uint16_t) value;
                 }
 
                 // calculate the temperature of the build-in temperature sensor (in Celsius)
-                mcu->temp = __HAL_ADC_CALC_TEMPERATURE(VDD_VALUE, mcu->adc.rawValues[NUMBER_ADC_CHANNELS - 1],
-                                                       ADC_RESOLUTION_12B);
-
-                // update the PWM duty cycle value
-                value = mcu->adc.rawValues[ANALOG_IN_2];
-                value = (value * 100) >> 12;
+                value = DecimatorGetOutput(&adcDecimator, ANALOG_TEMP_VREF) >> (DECIMATOR_OUTPUT_BITS - 12);
+                mcu->temp = __HAL_ADC_CALC_TEMPERATURE(VDD_VALUE, value, ADC_RESOLUTION_12B);
+
+                // update the PWM duty cycle value (or the one set by the I2C controller)
+                uint8_t control = TARGET_PWM_AUTO;
+                I2CTargetGetRegisters(&Target, TARGET_REG_PWM_CONTROL, &control, sizeof(control));
+                value = DecimatorGetOutput(&adcDecimator, ANALOG_IN_2);
+                value = (control <= 100) ? control : (value * 100) >> DECIMATOR_OUTPUT_BITS;
                 setPWMDutyCycle(&mcu->pwm, TIM_CHANNEL_1, (uint8_t) value);
+
+                updateTarget(mcu, (uint8_t) value, control <= 100, ++updates);
             }
             if (notificationValue & JOB_NOTIF_SENSOR_ERR_FLAG) {
                 mcu->adc.errType = HAL_ADC_GetError((ADC_HandleTypeDef *) mcu->adc.handle);
@@ -91,6 +241,67 @@ static void sensorsJob(void *arg) {
     }
 }
 
+/**
+ * @brief Execute the Serial Port packet command
+ * @param bench is the benchmark state
+ * @param data is the received packet
+ * @param size is the received packet size (bytes)
+ * @return True - the packet is a command, otherwise - False
+ */
+static bool handleCommand(BenchmarkDef *bench, const uint8_t *data, size_t size) {
+    uint8_t reply[17 + NUMBER_SENSOR_BUSES * 16] = {data[0], COMMAND_SUCCESS};
+    size_t replySize = 2;
+
+    switch (data[0]) {
+        case COMMAND_SET_BAUD: {
+            uint32_t baudRate = 0;
+            if (size < 5) {
+                reply[1] = COMMAND_ERROR;
+            } else {
+                for (size_t i = 0; i < sizeof(baudRate); ++i)
+                    baudRate |= (uint32_t) data[1 + i] << (8 * i);
+            }
+
+            // the reply is sent with the current baud rate
+            SerialWritePacket(&Serial, reply, replySize);
+            if (reply[1] == COMMAND_SUCCESS)
+                SerialSetBaudRate(&Serial, baudRate);
+            return true;
+        }
+        case COMMAND_BENCHMARK:
+            if (size < 2 || data[1] > BENCHMARK_SINK) {
+                reply[1] = COMMAND_ERROR;
+            } else {
+                bench->mode = data[1];
+                bench->rxBytes = bench->txBytes = 0;
+                bench->startTime = xTaskGetTickCount();
+            }
+            break;
+        case COMMAND_STATISTICS:
+            putValue(reply + 1, bench->rxBytes);
+            putValue(reply + 5, bench->txBytes);
+            putValue(reply + 9, (xTaskGetTickCount() - bench->startTime) * portTICK_PERIOD_MS);
+            putValue(reply + 13, Serial.errors + (uint32_t) Serial.uart->getNumOfErrors(Serial.uart));
+            replySize = 17;
+
+            // the stuck bus recoveries and the lost bus time of the sensor buses (cycles, see cycles.h)
+            for (size_t i = 0; i < NUMBER_SENSOR_BUSES; ++i) {
+                const I2CBusDef *bus = &Sensors.buses[i];
+                putValue(reply + replySize, bus->recoveries);
+                putValue(reply + replySize + 4, bus->recoveryCycles);
+                putValue(reply + replySize + 8, bus->maxRecoveryCycles);
+                putValue(reply + replySize + 12, bus->lostCycles);
+                replySize += 16;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    SerialWritePacket(&Serial, reply, replySize);
+    return true;
+}
+
 /**
  * @brief Communication task
  * @param arg is the function argument to which the scheduler will send the specified parameter
@@ -98,23 +309,64 @@ static void sensorsJob(void *arg) {
 static void communicationJob(void *arg) {
     McuDef *mcu = (McuDef *) arg;
 
-    const TickType_t delay = pdMS_TO_TICKS(COMMUNICATION_DELAY_MS);
-
-    const char *text = "[Thread 2] Input data:";
     int32_t numBytes = 0;
-    uint8_t buff[64] = {0};
+    uint8_t buff[SERIAL_PACKET_SIZE] = {0};
+    BenchmarkDef bench = {BENCHMARK_ECHO, 0, 0, xTaskGetTickCount()};
 
     while (1) {
-        vTaskDelay(delay);
+        if (bench.mode == BENCHMARK_SOURCE) {
+            // the sequence number is in the first bytes
+            putValue(buff, bench.txBytes / SERIAL_PACKET_SIZE);
+            if (SerialWritePacket(&Serial, buff, SERIAL_PACKET_SIZE) > 0)
+                bench.txBytes += SERIAL_PACKET_SIZE;
+
+            if (!SerialIsPacketReceived(&Serial))
+                continue;
+        }
+
+        // wait for the next complete packet
+        numBytes = SerialReadPacket(&Serial, buff, SERIAL_PACKET_SIZE);
+        if (numBytes <= 0)
+            continue;
 
-        numBytes = SerialReadData(&Serial, buff, 64);
-        if (numBytes) {
-            SerialWriteData(&Serial, text, 22);
-            SerialWriteData(&Serial, buff, numBytes);
+        // any valid packet confirms the current baud rate
+        SerialConfirmBaudRate(&Serial);
+        bench.rxBytes += (uint32_t) numBytes;
+
+        if (!handleCommand(&bench, buff, (size_t) numBytes) && bench.mode == BENCHMARK_ECHO) {
+            if (SerialWritePacket(&Serial, buff, (size_t) numBytes) > 0)
+                bench.txBytes += (uint32_t) numBytes;
         }
     }
 }
 
+/**
+ * @brief Decode the LM75 temperature register (9 bits, 0.5 C)
+ * @param data is the register value (big-endian)
+ * @return temperature (0.1 C)
+ */
+static int32_t decodeLM75Temperature(const uint8_t *data) {
+    int16_t raw = (int16_t) ((data[0] << 8) | data[1]);
+    return (raw >> 7) * 5;
+}
+
+/**
+ * @brief Decode the ADXL345 axis register pair
+ * @param data is the register value (little-endian)
+ * @return acceleration (raw, 3.9 mg/LSB)
+ */
+static int32_t decodeADXL345Axis(const uint8_t *data) {
+    return (int16_t) (data[0] | (data[1] << 8));
+}
+
+// the axes are adjacent registers of the same device: one burst read
+static const SensorPollEntryDef sensorTable[NUMBER_SENSOR_VALUES] = {
+    [SENSOR_TEMPERATURE] = {SENSOR_BUS_SLOW, 0x48, 0x00, 2, 100, decodeLM75Temperature},
+    [SENSOR_ACCEL_X] = {SENSOR_BUS_FAST, 0x53, 0x32, 2, 20, decodeADXL345Axis},
+    [SENSOR_ACCEL_Y] = {SENSOR_BUS_FAST, 0x53, 0x34, 2, 20, decodeADXL345Axis},
+    [SENSOR_ACCEL_Z] = {SENSOR_BUS_FAST, 0x53, 0x36, 2, 20, decodeADXL345Axis},
+};
+
 /**
  * @brief Service task for updating the status of sensors
  * @param arg is the function argument to which the scheduler will send the specified parameter
@@ -122,14 +374,18 @@ static void communicationJob(void *arg) {
 static void serviceJob(void *arg) {
     SensorsDef *sensors = (SensorsDef *) arg;
 
-    const TickType_t delay = pdMS_TO_TICKS(SERVICE_DELAY_MS);
-    EventBits_t event = 0;
+    TickType_t delay = 0;
+    uint32_t completed = 0;
+
+    SensorPollInit(&sensors->poll, sensors->buses, NUMBER_SENSOR_BUSES, sensorTable, NUMBER_SENSOR_VALUES,
+                   xTaskGetCurrentTaskHandle());
 
     while (1) {
-        event = xEventGroupWaitBits(sensors->interface.eventGroup, 1,pdTRUE,pdFALSE, delay);
+        delay = SensorPollStart(&sensors->poll);
 
-        if (event & 1) {
-        }
+        // the completion bits of the burst reads
+        if (xTaskNotifyWait(0, ULONG_MAX, &completed, delay) == pdTRUE)
+            SensorPollComplete(&sensors->poll, completed);
     }
 }
 
@@ -146,17 +402,96 @@ int createJobs(JobsDef *jobs) {
                                                    configMINIMAL_STACK_SIZE, (void *) &jobs->hardware,
                                                    tskIDLE_PRIORITY + 4, task2Stack, &task2CB);
     jobs->handles[COMMUNICATION_JOB] = xTaskCreateStatic(communicationJob, "communication",
-                                                         configMINIMAL_STACK_SIZE, (void *) &jobs->hardware,
+                                                         configMINIMAL_STACK_SIZE * 2, (void *) &jobs->hardware,
                                                          tskIDLE_PRIORITY + 1, task3Stack, &task3CB);
-    jobs->handles[SERIAL_PORT_JOB] = SerialJobInit(&Serial, &UART1_intf, tskIDLE_PRIORITY + 3);
-    jobs->handles[I2CBUS_JOB] = I2CJobInit(&Sensors.interface, &I2C1_intf, tskIDLE_PRIORITY + 3);
+    jobs->handles[SERIAL_PORT_JOB] = SerialJobInit(&Serial, &UART1_intf, &serialBuffers, tskIDLE_PRIORITY + 3);
+    SerialPacketInit(&Serial, jobs->hardware.handles.crc);
+    CordicInit(&Cordic, jobs->hardware.handles.cordic);
+    jobs->handles[CONSOLE_JOB] = SerialJobInit(&Console, &LPUART1_intf, &consoleBuffers, tskIDLE_PRIORITY + 2);
+    jobs->handles[I2C1_BUS_JOB] = I2CJobInit(&Sensors.buses[SENSOR_BUS_FAST], &I2C1_intf, tskIDLE_PRIORITY + 3);
+    jobs->handles[I2C2_BUS_JOB] = I2CJobInit(&Sensors.buses[SENSOR_BUS_SLOW], &I2C2_intf, tskIDLE_PRIORITY + 3);
     jobs->handles[SERVICE_JOB] = xTaskCreateStatic(serviceJob, "service",
                                                    configMINIMAL_STACK_SIZE, (void *) &Sensors,
                                                    tskIDLE_PRIORITY + 4, task4Stack, &task4CB);
+    jobs->handles[LOGGER_JOB] = LoggerJobInit(&Logger, &Console, tskIDLE_PRIORITY + 1);
+    jobs->handles[STORAGE_JOB] = StorageJobInit(&Storage, &storageDevice, &Sensors.buses[SENSOR_BUS_SLOW],
+                                                tskIDLE_PRIORITY + 1);
+
+    // the I2C target registers are read by the interrupts only, there is no task
+    const uint8_t id = TARGET_DEVICE_ID;
+    const uint8_t control = TARGET_PWM_AUTO;
+    I2CTargetInit(&Target, &I2C3_intf, targetWritable);
+    I2CTargetUpdate(&Target, TARGET_REG_ID, &id, sizeof(id));
+    I2CTargetUpdate(&Target, TARGET_REG_PWM_CONTROL, &control, sizeof(control));
+
+    changePinState(&jobs->hardware.led, GPIO_PIN_SET);
+    return 0;
+}
+
+#ifdef KERNEL_BENCHMARK
+/**
+ * @brief Create the kernel benchmark tasks only (the results are sent via the debug console)
+ * @param jobs is the JobsDef data structure
+ * @return 0 - success
+ */
+int createBenchmarkJobs(JobsDef *jobs) {
+    jobs->handles[CONSOLE_JOB] = SerialJobInit(&Console, &LPUART1_intf, &consoleBuffers, tskIDLE_PRIORITY + 1);
+    jobs->handles[KERNEL_BENCH_JOB] = KernelBenchJobInit(&kernelBench, &Console, tskIDLE_PRIORITY + 2);
+
+    changePinState(&jobs->hardware.led, GPIO_PIN_SET);
+    return 0;
+}
+#endif
+
+#ifdef I2C_BENCHMARK
+/**
+ * @brief Create the I2C throughput benchmark tasks only: the EEPROM on the fast sensor bus (I2C1) is read,
+ * the results are sent via the debug console
+ * @param jobs is the JobsDef data structure
+ * @return 0 - success
+ */
+int createI2CBenchmarkJobs(JobsDef *jobs) {
+    jobs->handles[CONSOLE_JOB] = SerialJobInit(&Console, &LPUART1_intf, &consoleBuffers, tskIDLE_PRIORITY + 1);
+    jobs->handles[I2C1_BUS_JOB] = I2CJobInit(&Sensors.buses[SENSOR_BUS_FAST], &I2C1_intf, tskIDLE_PRIORITY + 3);
+    jobs->handles[I2C_BENCH_JOB] = I2CBenchJobInit(&i2cBench, &Console, &Sensors.buses[SENSOR_BUS_FAST],
+                                                   tskIDLE_PRIORITY + 2);
+
+    changePinState(&jobs->hardware.led, GPIO_PIN_SET);
+    return 0;
+}
+#endif
+
+#ifdef MATH_BENCHMARK
+/**
+ * @brief Create the math benchmark tasks only: the CORDIC against libm, the results are sent via the debug console
+ * @param jobs is the JobsDef data structure
+ * @return 0 - success
+ */
+int createMathBenchmarkJobs(JobsDef *jobs) {
+    jobs->handles[CONSOLE_JOB] = SerialJobInit(&Console, &LPUART1_intf, &consoleBuffers, tskIDLE_PRIORITY + 1);
+    CordicInit(&Cordic, jobs->hardware.handles.cordic);
+    jobs->handles[MATH_BENCH_JOB] = MathBenchJobInit(&mathBench, &Console, &Cordic, tskIDLE_PRIORITY + 2);
+
+    changePinState(&jobs->hardware.led, GPIO_PIN_SET);
+    return 0;
+}
+#endif
+
+#ifdef DSP_BENCHMARK
+/**
+ * @brief Create the DSP benchmark tasks only: the packed kernels against the portable ones, the results are sent
+ * via the debug console
+ * @param jobs is the JobsDef data structure
+ * @return 0 - success
+ */
+int createDspBenchmarkJobs(JobsDef *jobs) {
+    jobs->handles[CONSOLE_JOB] = SerialJobInit(&Console, &LPUART1_intf, &consoleBuffers, tskIDLE_PRIORITY + 1);
+    jobs->handles[DSP_BENCH_JOB] = DspBenchJobInit(&dspBench, &Console, tskIDLE_PRIORITY + 2);
 
     changePinState(&jobs->hardware.led, GPIO_PIN_SET);
     return 0;
 }
+#endif
 
 /**
  * @brief The function is used to provide the memory for the RTOS Idle task
@@ -4,15 +4,31 @@
 #include "jobs.h"
 
 SerialPortDef Serial;
+SerialPortDef Console;
+LoggerDef Logger;
 JobsDef Application;
 SensorsDef Sensors;
+I2CTargetDef Target;
+StorageDef Storage;
+FilterDef AdcFilter;
+CordicDef Cordic;
 
 int main(void) {
     HAL_Init();
     initialization(&Application.hardware);
     HAL_NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
 
+#ifdef KERNEL_BENCHMARK
+    createBenchmarkJobs(&Application);
+#elif defined(I2C_BENCHMARK)
+    createI2CBenchmarkJobs(&Application);
+#elif defined(MATH_BENCHMARK)
+    createMathBenchmarkJobs(&Application);
+#elif defined(DSP_BENCHMARK)
+    createDspBenchmarkJobs(&Application);
+#else
     createJobs(&Application);
+#endif
     vTaskStartScheduler();
 
     while (1) {
@@ -3,12 +3,15 @@
 #include "settings.h"
 #include "SerialJob.h"
 #include "I2CBusJob.h"
+#include "I2CTarget.h"
 
 static TIM_HandleTypeDef timer15Handle;
 static TIM_HandleTypeDef timer16Handle;
 static ADC_HandleTypeDef adcHandle;
 static CRC_HandleTypeDef crcHandle;
 static IWDG_HandleTypeDef wdtHandle;
+static FMAC_HandleTypeDef fmacHandle;
+static CORDIC_HandleTypeDef cordicHandle;
 
 /**
  * @brief Setting system clocks
@@ -97,12 +100,12 @@ static int settingTimer(TimerDef *t) {
     sourceClock <<= 1;
 
     t->handle = (void *) &timer15Handle;
-    t->freq = 100000;
+    t->freq = 25000; // the ADC scan rate, one scan takes 31.7 us (see settingADC)
     t->basePrescaler = t->currentPrescaler = 71;
 
     timInit = (TIM_HandleTypeDef *) t->handle;
     timInit->Instance = TIM15;
-    timInit->Init.Period = 9;
+    timInit->Init.Period = 39;
     timInit->Init.Prescaler = t->basePrescaler;
     timInit->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
     timInit->Init.CounterMode = TIM_COUNTERMODE_UP;
@@ -140,15 +143,20 @@ static int settingADC(AdcDef *adc) {
     adcInit->Init.LowPowerAutoWait = DISABLE;
     adcInit->Init.ContinuousConvMode = DISABLE;
     adcInit->Init.NbrOfConversion = 3;
-    adcInit->Init.DiscontinuousConvMode = ENABLE;
+    // one trigger - the whole scan, each rank is oversampled (the hardware accumulator) before the next one
+    adcInit->Init.DiscontinuousConvMode = DISABLE;
     adcInit->Init.NbrOfDiscConversion = 1;
     adcInit->Init.ExternalTrigConv = ADC_EXTERNALTRIG_T15_TRGO;
     adcInit->Init.ExternalTrigConvEdge = ADC_EXTERNALTRIG_EDGE_RISING;
     adcInit->Init.SamplingMode = ADC_SAMPLING_MODE_NORMAL;
     adcInit->Init.DMAContinuousRequests = ENABLE;
     adcInit->Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
-    adcInit->Init.OversamplingMode = DISABLE;
-    //    adcInit->Init.Oversampling =;
+    // x4 accumulation without shift: 14-bit samples (ADC_SAMPLE_BITS) at the cost of the conversion time only
+    adcInit->Init.OversamplingMode = ENABLE;
+    adcInit->Init.Oversampling.Ratio = ADC_OVERSAMPLING_RATIO_4;
+    adcInit->Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_NONE;
+    adcInit->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    adcInit->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
 
     if (HAL_ADC_Init(adcInit) != HAL_OK)
         return SETTING_ERROR;
@@ -158,7 +166,8 @@ static int settingADC(AdcDef *adc) {
 
     ADC_ChannelConfTypeDef chInit = {0};
 
-    chInit.SamplingTime = ADC_SAMPLETIME_247CYCLES_5; // 5.41658 us
+    // the scan: 4 x (60 + 60 + 260) cycles at 48 MHz = 31.7 us, the trigger period is 40 us
+    chInit.SamplingTime = ADC_SAMPLETIME_47CYCLES_5; // 1.25 us (with the conversion)
     chInit.SingleDiff = ADC_SINGLE_ENDED;
     chInit.OffsetNumber = ADC_OFFSET_NONE;
     chInit.Offset = 0;
@@ -181,6 +190,7 @@ static int settingADC(AdcDef *adc) {
     // ADC_CHANNEL_TEMPSENSOR_ADC1 or ADC_CHANNEL_VREFINT
     chInit.Channel = ADC_CHANNEL_TEMPSENSOR_ADC1;
     chInit.Rank = ADC_REGULAR_RANK_3;
+    chInit.SamplingTime = ADC_SAMPLETIME_247CYCLES_5; // 5.42 us, the sensor needs at least 5 us
     if (HAL_ADC_ConfigChannel(adcInit, &chInit) != HAL_OK)
         return SETTING_ERROR;
 
@@ -236,12 +246,14 @@ static int settingPWM(TimerDef *t) {
 /**
  * @brief Setting UART modules
  * @param uart is the UartDef data structure
+ * @param instance is the UART peripheral (USART1, LPUART1, ...)
+ * @param baudRate is the initial baud rate (bps)
  * @return SETTING_SUCCESS or SETTING_ERROR
  */
-static int settingUART(UartDef *uart) {
+static int settingUART(UartDef *uart, USART_TypeDef *instance, uint32_t baudRate) {
     UART_HandleTypeDef *uartInit = (UART_HandleTypeDef *) uart->handle;
-    uartInit->Instance = USART1;
-    uartInit->Init.BaudRate = 115200; // bps
+    uartInit->Instance = instance;
+    uartInit->Init.BaudRate = baudRate;
     uartInit->Init.Mode = UART_MODE_TX_RX;
     uartInit->Init.WordLength = UART_WORDLENGTH_8B;
     uartInit->Init.StopBits = UART_STOPBITS_1;
@@ -250,24 +262,108 @@ static int settingUART(UartDef *uart) {
     uartInit->Init.OverSampling = UART_OVERSAMPLING_16;
     uartInit->Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
     uartInit->Init.ClockPrescaler = UART_PRESCALER_DIV1;
-    uartInit->FifoMode = UART_FIFOMODE_DISABLE;
+    uartInit->FifoMode = UART_FIFOMODE_ENABLE;
     uartInit->AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
 
     if (HAL_UART_Init(uartInit) != HAL_OK)
         return SETTING_ERROR;
 
+    // 8-bytes FIFOs, DMA requests are served from FIFO
+    if (HAL_UARTEx_SetTxFifoThreshold(uartInit, UART_TXFIFO_THRESHOLD_1_2) != HAL_OK)
+        return SETTING_ERROR;
+
+    if (HAL_UARTEx_SetRxFifoThreshold(uartInit, UART_RXFIFO_THRESHOLD_1_2) != HAL_OK)
+        return SETTING_ERROR;
+
+    if (HAL_UARTEx_EnableFifoMode(uartInit) != HAL_OK)
+        return SETTING_ERROR;
+
     return SETTING_SUCCESS;
 }
 
+// the bus parameters, TIMINGR is calculated from the live I2C kernel clock
+static const I2CTimingDef i2cTiming = {SETTING_I2C_SPEED_HZ, 100, 10, true, 0};
+
+typedef struct {
+    I2CDef *i2c;
+    I2C_TypeDef *instance;
+    uint32_t clock; // RCC_PERIPHCLK_I2Cx
+    uint32_t fastModePlus; // the Fm+ drive of the pins
+} I2CBusSettingDef;
+
+// the controller (master) interfaces, I2C3 is the target
+static const I2CBusSettingDef i2cBuses[] = {
+    {&I2C1_intf, I2C1, RCC_PERIPHCLK_I2C1, I2C_FASTMODEPLUS_PB8 | I2C_FASTMODEPLUS_PB9},
+    {&I2C2_intf, I2C2, RCC_PERIPHCLK_I2C2, I2C_FASTMODEPLUS_I2C2},
+};
+
+/**
+ * @brief Get the settings of the I2C controller interface
+ * @param i2c is the I2CDef data structure
+ * @return the I2CBusSettingDef data structure or NULL
+ */
+static const I2CBusSettingDef *getI2CBusSetting(const I2CDef *i2c) {
+    for (size_t i = 0; i < sizeof(i2cBuses) / sizeof(i2cBuses[0]); ++i) {
+        if (i2cBuses[i].i2c == i2c)
+            return &i2cBuses[i];
+    }
+    return NULL;
+}
+
 /**
- * @brief Setting I2C modules
+ * @brief Setting the I2C clock dependent registers: TIMINGR, SCL low timeout and Fast-mode Plus drive.
+ * Call it again after the I2C kernel clock is changed (the bus must be idle)
  * @param i2c is the I2CDef data structure
  * @return SETTING_SUCCESS or SETTING_ERROR
  */
-static int settingI2C(I2CDef *i2c) {
+int settingI2CTiming(I2CDef *i2c) {
+    const I2CBusSettingDef *setting = getI2CBusSetting(i2c);
+    if (setting == NULL)
+        return SETTING_ERROR;
+
     I2C_HandleTypeDef *i2cInit = (I2C_HandleTypeDef *) i2c->handle;
-    i2cInit->Instance = I2C1;
-    i2cInit->Init.Timing = 0x10320707; // 400kHz
+    uint32_t clock = HAL_RCCEx_GetPeriphCLKFreq(setting->clock);
+    uint32_t timing = 0;
+
+    if (I2C_computeTiming(clock, &i2cTiming, &timing) != I2C_SUCCESS)
+        return SETTING_ERROR;
+
+    // SCL low timeout (a target stretches the clock or holds the bus): (TIMEOUTA + 1) * 2048 / I2CCLK
+    uint32_t timeout = clock / 2048 * SETTING_I2C_TIMEOUT_MS / 1000;
+    if (timeout == 0 || timeout > (I2C_TIMEOUTR_TIMEOUTA >> I2C_TIMEOUTR_TIMEOUTA_Pos) + 1)
+        return SETTING_ERROR;
+
+    if (i2cTiming.speedHz > I2C_FAST_MODE_HZ)
+        HAL_I2CEx_EnableFastModePlus(setting->fastModePlus);
+    else
+        HAL_I2CEx_DisableFastModePlus(setting->fastModePlus);
+
+    // TIMINGR and TIMEOUTA can be changed only while the interface (and the timeout) is disabled
+    __HAL_I2C_DISABLE(i2cInit);
+    i2cInit->Init.Timing = timing;
+    i2cInit->Instance->TIMINGR = timing;
+    i2cInit->Instance->TIMEOUTR = 0;
+    i2cInit->Instance->TIMEOUTR = ((timeout - 1) << I2C_TIMEOUTR_TIMEOUTA_Pos);
+    i2cInit->Instance->TIMEOUTR |= I2C_TIMEOUTR_TIMOUTEN;
+    __HAL_I2C_ENABLE(i2cInit);
+
+    return SETTING_SUCCESS;
+}
+
+/**
+ * @brief Setting the I2C controller interfaces (it is also used to initialize the interface again after the bus
+ * recovery)
+ * @param i2c is the I2CDef data structure (see i2cBuses)
+ * @return SETTING_SUCCESS or SETTING_ERROR
+ */
+int settingI2C(I2CDef *i2c) {
+    const I2CBusSettingDef *setting = getI2CBusSetting(i2c);
+    if (setting == NULL)
+        return SETTING_ERROR;
+
+    I2C_HandleTypeDef *i2cInit = (I2C_HandleTypeDef *) i2c->handle;
+    i2cInit->Instance = setting->instance;
+    i2cInit->Init.Timing = 0; // the kernel clock is selected by MSP, see settingI2CTiming
     i2cInit->Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
     i2cInit->Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
     i2cInit->Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
@@ -276,15 +372,60 @@ static int settingI2C(I2CDef *i2c) {
     i2cInit->Init.OwnAddress2 = 0;
     i2cInit->Init.OwnAddress2Masks = I2C_OA2_NOMASK;
 
+    if (HAL_I2C_Init(i2cInit) != HAL_OK)
+        return SETTING_ERROR;
+
+    if (HAL_I2CEx_ConfigAnalogFilter(i2cInit, (i2cTiming.isAnalogFilter) ? I2C_ANALOGFILTER_ENABLE :
+                                                                           I2C_ANALOGFILTER_DISABLE) != HAL_OK)
+        return SETTING_ERROR;
+
+    if (HAL_I2CEx_ConfigDigitalFilter(i2cInit, i2cTiming.digitalFilter) != HAL_OK)
+        return SETTING_ERROR;
+
+    if (settingI2CTiming(i2c) != SETTING_SUCCESS)
+        return SETTING_ERROR;
+
+    i2c->isInit = true;
+    return SETTING_SUCCESS;
+}
+
+// the target is served by the external controller (up to Fast-mode)
+static const I2CTimingDef i2cTargetTiming = {I2C_FAST_MODE_HZ, 100, 10, true, 0};
+
+/**
+ * @brief Setting the I2C target (slave) interface, see I2CTargetInit
+ * @param i2c is the I2CDef data structure
+ * @return SETTING_SUCCESS or SETTING_ERROR
+ */
+int settingI2CTarget(I2CDef *i2c) {
+    I2C_HandleTypeDef *i2cInit = (I2C_HandleTypeDef *) i2c->handle;
+    i2cInit->Instance = I2C3;
+    i2cInit->Init.Timing = 0; // the kernel clock is selected by MSP
+    i2cInit->Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+    i2cInit->Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+    i2cInit->Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+    i2cInit->Init.NoStretchMode = I2C_NOSTRETCH_DISABLE; // SCL is stretched while the address match is served
+    i2cInit->Init.OwnAddress1 = SETTING_I2C_TARGET_ADDRESS << 1;
+    i2cInit->Init.OwnAddress2 = 0;
+    i2cInit->Init.OwnAddress2Masks = I2C_OA2_NOMASK;
+
     if (HAL_I2C_Init(i2cInit) != HAL_OK)
         return SETTING_ERROR;
 
     if (HAL_I2CEx_ConfigAnalogFilter(i2cInit, I2C_ANALOGFILTER_ENABLE) != HAL_OK)
         return SETTING_ERROR;
 
-    if (HAL_I2CEx_ConfigDigitalFilter(i2cInit, 0) != HAL_OK)
+    // a target uses only the data hold/setup delays (SDADEL/SCLDEL) of TIMINGR
+    uint32_t timing = 0;
+    if (I2C_computeTiming(HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_I2C3), &i2cTargetTiming, &timing) != I2C_SUCCESS)
         return SETTING_ERROR;
 
+    __HAL_I2C_DISABLE(i2cInit);
+    i2cInit->Init.Timing = timing;
+    i2cInit->Instance->TIMINGR = timing;
+    __HAL_I2C_ENABLE(i2cInit);
+
+    i2c->isInit = true;
     return SETTING_SUCCESS;
 }
 
@@ -310,6 +451,38 @@ static int settingCRC(McuDef *mcu) {
     return SETTING_SUCCESS;
 }
 
+/**
+ * @brief Setting Filter Mathematical Accelerator (FMAC) module, the filter is configured by FilterInit
+ * @param mcu is the base MCU data structure
+ * @return SETTING_SUCCESS or SETTING_ERROR
+ */
+static int settingFMAC(McuDef *mcu) {
+    mcu->handles.fmac = &fmacHandle;
+    FMAC_HandleTypeDef *fmacInit = (FMAC_HandleTypeDef *) mcu->handles.fmac;
+    fmacInit->Instance = FMAC;
+
+    if (HAL_FMAC_Init(fmacInit) != HAL_OK)
+        return SETTING_ERROR;
+
+    return SETTING_SUCCESS;
+}
+
+/**
+ * @brief Setting CORDIC co-processor, the function is configured by the math service (see Cordic.h)
+ * @param mcu is the base MCU data structure
+ * @return SETTING_SUCCESS or SETTING_ERROR
+ */
+static int settingCORDIC(McuDef *mcu) {
+    mcu->handles.cordic = &cordicHandle;
+    CORDIC_HandleTypeDef *cordicInit = (CORDIC_HandleTypeDef *) mcu->handles.cordic;
+    cordicInit->Instance = CORDIC;
+
+    if (HAL_CORDIC_Init(cordicInit) != HAL_OK)
+        return SETTING_ERROR;
+
+    return SETTING_SUCCESS;
+}
+
 /**
  * @brief Setting watchdog timer (WDT) module
  * @param mcu is the base MCU data structure
@@ -347,9 +520,14 @@ int initialization(McuDef *mcu) {
     } else if (settingTimer(&mcu->adc.timer) != SETTING_SUCCESS) {
     } else if (settingADC(&mcu->adc) != SETTING_SUCCESS) {
     } else if (settingPWM(&mcu->pwm) != SETTING_SUCCESS) {
-    } else if (settingUART(&UART1_intf) != SETTING_SUCCESS) {
-    } else if (settingI2C(&I2C1_intf) != SETTING_SUCCESS) {
+    } else if (settingUART(&UART1_intf, USART1, 115200) != SETTING_SUCCESS) { // data link
+    } else if (settingUART(&LPUART1_intf, LPUART1, 115200) != SETTING_SUCCESS) { // debug console (ST-LINK VCP)
+    } else if (settingI2C(&I2C1_intf) != SETTING_SUCCESS) { // fast sensors
+    } else if (settingI2C(&I2C2_intf) != SETTING_SUCCESS) { // slow sensors
+    } else if (settingI2CTarget(&I2C3_intf) != SETTING_SUCCESS) {
     } else if (settingCRC(mcu) != SETTING_SUCCESS) {
+    } else if (settingFMAC(mcu) != SETTING_SUCCESS) {
+    } else if (settingCORDIC(mcu) != SETTING_SUCCESS) {
     } else if (settingWDT(mcu) != SETTING_SUCCESS) {
     } else {
         return SETTING_SUCCESS;
@@ -21,6 +21,8 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm32g4xx_hal.h"
 
+#include "settings.h"
+
 /** @addtogroup STM32G4xx_HAL_Driver
   * @{
   */
@@ -39,6 +41,13 @@ static DMA_HandleTypeDef dma2Handle;
 static DMA_HandleTypeDef dma3Handle;
 static DMA_HandleTypeDef dma4Handle;
 static DMA_HandleTypeDef dma5Handle;
+static DMA_HandleTypeDef dma6Handle;
+static DMA_HandleTypeDef dma7Handle;
+static DMA_HandleTypeDef dma8Handle;
+static DMA_HandleTypeDef dma9Handle;
+static DMA_HandleTypeDef dma10Handle;
+static DMA_HandleTypeDef dma11Handle;
+static DMA_HandleTypeDef dma12Handle;
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -154,7 +163,7 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc) {
             dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
             dmaInit->Init.MemInc = DMA_MINC_ENABLE;
             dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
-            dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+            dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD; // the block buffer (AdcDef)
             dmaInit->Init.Mode = DMA_CIRCULAR;
             dmaInit->Init.Priority = DMA_PRIORITY_HIGH;
             if (HAL_DMA_Init(dmaInit) == HAL_OK) {
@@ -196,7 +205,7 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart) {
 
     if (huart->Instance == USART1) {
         clockInit.PeriphClockSelection = RCC_PERIPHCLK_USART1;
-        clockInit.Usart1ClockSelection = RCC_USART1CLKSOURCE_HSI;
+        clockInit.Usart1ClockSelection = RCC_USART1CLKSOURCE_SYSCLK; // 144MHz, up to 18Mbps
 
         if (HAL_RCCEx_PeriphCLKConfig(&clockInit) == HAL_OK) {
             __HAL_RCC_USART1_CLK_ENABLE();
@@ -238,7 +247,7 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart) {
             dmaInit->Init.MemInc = DMA_MINC_ENABLE;
             dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
             dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
-            dmaInit->Init.Mode = DMA_NORMAL;
+            dmaInit->Init.Mode = DMA_CIRCULAR;
             dmaInit->Init.Priority = DMA_PRIORITY_HIGH;
             if (HAL_DMA_Init(dmaInit) == HAL_OK) {
                 __HAL_LINKDMA(huart, hdmarx, *dmaInit);
@@ -250,6 +259,63 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart) {
             HAL_NVIC_SetPriority(USART1_IRQn, 8, 0);
             HAL_NVIC_EnableIRQ(USART1_IRQn);
         }
+    } else if (huart->Instance == LPUART1) {
+        clockInit.PeriphClockSelection = RCC_PERIPHCLK_LPUART1;
+        clockInit.Lpuart1ClockSelection = RCC_LPUART1CLKSOURCE_PCLK1; // 36MHz, up to 12Mbps (ST-LINK VCP)
+
+        if (HAL_RCCEx_PeriphCLKConfig(&clockInit) == HAL_OK) {
+            __HAL_RCC_LPUART1_CLK_ENABLE();
+
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+            gpioInit.Pin = GPIO_PIN_2 | GPIO_PIN_3;
+            gpioInit.Mode = GPIO_MODE_AF_PP;
+            gpioInit.Pull = GPIO_PULLUP;
+            gpioInit.Speed = GPIO_SPEED_FREQ_HIGH;
+            gpioInit.Alternate = GPIO_AF12_LPUART1;
+            HAL_GPIO_Init(GPIOA, &gpioInit);
+
+            // DMA1 channels are taken by ADC, I2C1, USART1 and I2C2 TX (DMA2 channel 3 - I2C3, channel 4 - I2C2 RX)
+            __HAL_RCC_DMAMUX1_CLK_ENABLE();
+            __HAL_RCC_DMA2_CLK_ENABLE();
+
+            dmaInit = &dma6Handle;
+            dmaInit->Instance = DMA2_Channel1;
+            dmaInit->Init.Request = DMA_REQUEST_LPUART1_TX;
+            dmaInit->Init.Direction = DMA_MEMORY_TO_PERIPH;
+            dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
+            dmaInit->Init.MemInc = DMA_MINC_ENABLE;
+            dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+            dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+            dmaInit->Init.Mode = DMA_NORMAL;
+            dmaInit->Init.Priority = DMA_PRIORITY_LOW;
+
+            if (HAL_DMA_Init(dmaInit) == HAL_OK) {
+                __HAL_LINKDMA(huart, hdmatx, *dmaInit);
+
+                HAL_NVIC_SetPriority(DMA2_Channel1_IRQn, 9, 0);
+                HAL_NVIC_EnableIRQ(DMA2_Channel1_IRQn);
+            }
+
+            dmaInit = &dma7Handle;
+            dmaInit->Instance = DMA2_Channel2;
+            dmaInit->Init.Request = DMA_REQUEST_LPUART1_RX;
+            dmaInit->Init.Direction = DMA_PERIPH_TO_MEMORY;
+            dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
+            dmaInit->Init.MemInc = DMA_MINC_ENABLE;
+            dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+            dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+            dmaInit->Init.Mode = DMA_CIRCULAR;
+            dmaInit->Init.Priority = DMA_PRIORITY_MEDIUM;
+            if (HAL_DMA_Init(dmaInit) == HAL_OK) {
+                __HAL_LINKDMA(huart, hdmarx, *dmaInit);
+
+                HAL_NVIC_SetPriority(DMA2_Channel2_IRQn, 9, 0);
+                HAL_NVIC_EnableIRQ(DMA2_Channel2_IRQn);
+            }
+
+            HAL_NVIC_SetPriority(LPUART1_IRQn, 10, 0);
+            HAL_NVIC_EnableIRQ(LPUART1_IRQn);
+        }
     }
 }
 
@@ -272,6 +338,20 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef *huart) {
 
         HAL_DMA_DeInit(&dma2Handle);
         HAL_DMA_DeInit(&dma3Handle);
+    } else if (huart->Instance == LPUART1) {
+        __HAL_RCC_LPUART1_FORCE_RESET();
+        __HAL_RCC_LPUART1_RELEASE_RESET();
+        __HAL_RCC_LPUART1_CLK_DISABLE();
+
+        HAL_GPIO_DeInit(GPIOA, GPIO_PIN_2);
+        HAL_GPIO_DeInit(GPIOA, GPIO_PIN_3);
+
+        HAL_NVIC_DisableIRQ(DMA2_Channel1_IRQn);
+        HAL_NVIC_DisableIRQ(DMA2_Channel2_IRQn);
+        HAL_NVIC_DisableIRQ(LPUART1_IRQn);
+
+        HAL_DMA_DeInit(&dma6Handle);
+        HAL_DMA_DeInit(&dma7Handle);
     }
 }
 
@@ -286,7 +366,9 @@ void HAL_I2C_MspInit(I2C_HandleTypeDef *hi2c) {
 
     if (hi2c->Instance == I2C1) {
         clockInit.PeriphClockSelection = RCC_PERIPHCLK_I2C1;
-        clockInit.I2c1ClockSelection = RCC_I2C1CLKSOURCE_HSI;
+        // HSI (16MHz) can't meet the Fm+ data valid time with the analog filter
+        clockInit.I2c1ClockSelection = ((uint32_t) SETTING_I2C_SPEED_HZ > I2C_FAST_MODE_HZ) ?
+                                       RCC_I2C1CLKSOURCE_SYSCLK : RCC_I2C1CLKSOURCE_HSI;
 
         if (HAL_RCCEx_PeriphCLKConfig(&clockInit) == HAL_OK) {
             __HAL_RCC_I2C1_CLK_ENABLE();
@@ -342,6 +424,105 @@ void HAL_I2C_MspInit(I2C_HandleTypeDef *hi2c) {
             HAL_NVIC_SetPriority(I2C1_ER_IRQn, 9, 0);
             HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
         }
+    } else if (hi2c->Instance == I2C2) {
+        clockInit.PeriphClockSelection = RCC_PERIPHCLK_I2C2;
+        clockInit.I2c2ClockSelection = ((uint32_t) SETTING_I2C_SPEED_HZ > I2C_FAST_MODE_HZ) ?
+                                       RCC_I2C2CLKSOURCE_SYSCLK : RCC_I2C2CLKSOURCE_HSI;
+
+        if (HAL_RCCEx_PeriphCLKConfig(&clockInit) == HAL_OK) {
+            __HAL_RCC_I2C2_CLK_ENABLE();
+
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+            gpioInit.Pin = GPIO_PIN_8 | GPIO_PIN_9;
+            gpioInit.Mode = GPIO_MODE_AF_OD;
+            gpioInit.Pull = GPIO_PULLUP;
+            gpioInit.Speed = GPIO_SPEED_FREQ_LOW;
+            gpioInit.Alternate = GPIO_AF4_I2C2;
+            HAL_GPIO_Init(GPIOA, &gpioInit);
+
+            // DMA1 channel 6 is the last free one of DMA1, the reception goes to DMA2
+            __HAL_RCC_DMAMUX1_CLK_ENABLE();
+            __HAL_RCC_DMA1_CLK_ENABLE();
+            __HAL_RCC_DMA2_CLK_ENABLE();
+
+            dmaInit = &dma9Handle;
+            dmaInit->Instance = DMA1_Channel6;
+            dmaInit->Init.Request = DMA_REQUEST_I2C2_TX;
+            dmaInit->Init.Direction = DMA_MEMORY_TO_PERIPH;
+            dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
+            dmaInit->Init.MemInc = DMA_MINC_ENABLE;
+            dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+            dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+            dmaInit->Init.Mode = DMA_NORMAL;
+            dmaInit->Init.Priority = DMA_PRIORITY_LOW;
+
+            if (HAL_DMA_Init(dmaInit) == HAL_OK) {
+                __HAL_LINKDMA(hi2c, hdmatx, *dmaInit);
+
+                HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 7, 0);
+                HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+            }
+
+            dmaInit = &dma10Handle;
+            dmaInit->Instance = DMA2_Channel4;
+            dmaInit->Init.Request = DMA_REQUEST_I2C2_RX;
+            dmaInit->Init.Direction = DMA_PERIPH_TO_MEMORY;
+            dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
+            dmaInit->Init.MemInc = DMA_MINC_ENABLE;
+            dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+            dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+            dmaInit->Init.Mode = DMA_NORMAL;
+            dmaInit->Init.Priority = DMA_PRIORITY_HIGH;
+            if (HAL_DMA_Init(dmaInit) == HAL_OK) {
+                __HAL_LINKDMA(hi2c, hdmarx, *dmaInit);
+
+                HAL_NVIC_SetPriority(DMA2_Channel4_IRQn, 6, 0);
+                HAL_NVIC_EnableIRQ(DMA2_Channel4_IRQn);
+            }
+
+            HAL_NVIC_SetPriority(I2C2_EV_IRQn, 8, 0);
+            HAL_NVIC_EnableIRQ(I2C2_EV_IRQn);
+            HAL_NVIC_SetPriority(I2C2_ER_IRQn, 9, 0);
+            HAL_NVIC_EnableIRQ(I2C2_ER_IRQn);
+        }
+    } else if (hi2c->Instance == I2C3) {
+        clockInit.PeriphClockSelection = RCC_PERIPHCLK_I2C3;
+        clockInit.I2c3ClockSelection = RCC_I2C3CLKSOURCE_HSI;
+
+        if (HAL_RCCEx_PeriphCLKConfig(&clockInit) == HAL_OK) {
+            __HAL_RCC_I2C3_CLK_ENABLE();
+
+            __HAL_RCC_GPIOC_CLK_ENABLE();
+            gpioInit.Pin = GPIO_PIN_8 | GPIO_PIN_9;
+            gpioInit.Mode = GPIO_MODE_AF_OD;
+            gpioInit.Pull = GPIO_NOPULL; // the controller board has the pull-up resistors
+            gpioInit.Speed = GPIO_SPEED_FREQ_LOW;
+            gpioInit.Alternate = GPIO_AF8_I2C3;
+            HAL_GPIO_Init(GPIOC, &gpioInit);
+
+            __HAL_RCC_DMAMUX1_CLK_ENABLE();
+            __HAL_RCC_DMA2_CLK_ENABLE();
+
+            // the register map is read by circular DMA until Stop, the received bytes are served by the interrupt
+            dmaInit = &dma8Handle;
+            dmaInit->Instance = DMA2_Channel3;
+            dmaInit->Init.Request = DMA_REQUEST_I2C3_TX;
+            dmaInit->Init.Direction = DMA_MEMORY_TO_PERIPH;
+            dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
+            dmaInit->Init.MemInc = DMA_MINC_ENABLE;
+            dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+            dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+            dmaInit->Init.Mode = DMA_CIRCULAR;
+            dmaInit->Init.Priority = DMA_PRIORITY_HIGH;
+            if (HAL_DMA_Init(dmaInit) == HAL_OK)
+                __HAL_LINKDMA(hi2c, hdmatx, *dmaInit);
+
+            // the address match is served with SCL stretched: the response latency
+            HAL_NVIC_SetPriority(I2C3_EV_IRQn, 6, 0);
+            HAL_NVIC_EnableIRQ(I2C3_EV_IRQn);
+            HAL_NVIC_SetPriority(I2C3_ER_IRQn, 7, 0);
+            HAL_NVIC_EnableIRQ(I2C3_ER_IRQn);
+        }
     }
 }
 
@@ -362,6 +543,30 @@ void HAL_I2C_MspDeInit(I2C_HandleTypeDef *hi2c) {
         HAL_NVIC_DisableIRQ(DMA1_Channel3_IRQn);
         HAL_NVIC_DisableIRQ(I2C1_EV_IRQn);
         HAL_NVIC_DisableIRQ(I2C1_ER_IRQn);
+    } else if (hi2c->Instance == I2C2) {
+        __HAL_RCC_I2C2_FORCE_RESET();
+        __HAL_RCC_I2C2_RELEASE_RESET();
+        __HAL_RCC_I2C2_CLK_DISABLE();
+
+        HAL_GPIO_DeInit(GPIOA, GPIO_PIN_8);
+        HAL_GPIO_DeInit(GPIOA, GPIO_PIN_9);
+
+        HAL_NVIC_DisableIRQ(DMA1_Channel6_IRQn);
+        HAL_NVIC_DisableIRQ(DMA2_Channel4_IRQn);
+        HAL_NVIC_DisableIRQ(I2C2_EV_IRQn);
+        HAL_NVIC_DisableIRQ(I2C2_ER_IRQn);
+    } else if (hi2c->Instance == I2C3) {
+        __HAL_RCC_I2C3_FORCE_RESET();
+        __HAL_RCC_I2C3_RELEASE_RESET();
+        __HAL_RCC_I2C3_CLK_DISABLE();
+
+        HAL_GPIO_DeInit(GPIOC, GPIO_PIN_8);
+        HAL_GPIO_DeInit(GPIOC, GPIO_PIN_9);
+
+        HAL_NVIC_DisableIRQ(I2C3_EV_IRQn);
+        HAL_NVIC_DisableIRQ(I2C3_ER_IRQn);
+
+        HAL_DMA_DeInit(&dma8Handle);
     }
 }
 
@@ -387,6 +592,99 @@ void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc) {
     }
 }
 
+/**
+ * @brief Initialize the FMAC module, turn ON a clock source, setup DMA (the input and the output streams) and
+ * interrupt vectors
+ * @param hfmac is the pointer to the data structure of the FMAC handle (HAL).
+ */
+void HAL_FMAC_MspInit(FMAC_HandleTypeDef *hfmac) {
+    if (hfmac->Instance == FMAC) {
+        __HAL_RCC_FMAC_CLK_ENABLE();
+        __HAL_RCC_DMAMUX1_CLK_ENABLE();
+        __HAL_RCC_DMA2_CLK_ENABLE();
+
+        // the input samples (X1)
+        DMA_HandleTypeDef *dmaInit = &dma11Handle;
+        dmaInit->Instance = DMA2_Channel5;
+        dmaInit->Init.Request = DMA_REQUEST_FMAC_WRITE;
+        dmaInit->Init.Direction = DMA_MEMORY_TO_PERIPH;
+        dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
+        dmaInit->Init.MemInc = DMA_MINC_ENABLE;
+        dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+        dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+        dmaInit->Init.Mode = DMA_NORMAL;
+        dmaInit->Init.Priority = DMA_PRIORITY_LOW;
+        if (HAL_DMA_Init(dmaInit) == HAL_OK) {
+            __HAL_LINKDMA(hfmac, hdmaIn, *dmaInit);
+
+            HAL_NVIC_SetPriority(DMA2_Channel5_IRQn, 11, 0);
+            HAL_NVIC_EnableIRQ(DMA2_Channel5_IRQn);
+        }
+
+        // the filtered samples (Y)
+        dmaInit = &dma12Handle;
+        dmaInit->Instance = DMA2_Channel6;
+        dmaInit->Init.Request = DMA_REQUEST_FMAC_READ;
+        dmaInit->Init.Direction = DMA_PERIPH_TO_MEMORY;
+        dmaInit->Init.PeriphInc = DMA_PINC_DISABLE;
+        dmaInit->Init.MemInc = DMA_MINC_ENABLE;
+        dmaInit->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+        dmaInit->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+        dmaInit->Init.Mode = DMA_NORMAL;
+        dmaInit->Init.Priority = DMA_PRIORITY_LOW;
+        if (HAL_DMA_Init(dmaInit) == HAL_OK) {
+            __HAL_LINKDMA(hfmac, hdmaOut, *dmaInit);
+
+            HAL_NVIC_SetPriority(DMA2_Channel6_IRQn, 11, 0);
+            HAL_NVIC_EnableIRQ(DMA2_Channel6_IRQn);
+        }
+
+        // the overflow, underflow and saturation errors
+        HAL_NVIC_SetPriority(FMAC_IRQn, 11, 0);
+        HAL_NVIC_EnableIRQ(FMAC_IRQn);
+    }
+}
+
+/**
+ * @brief DeInitialize the FMAC module
+ * @param hfmac is the pointer to the data structure of the FMAC handle (HAL).
+ */
+void HAL_FMAC_MspDeInit(FMAC_HandleTypeDef *hfmac) {
+    if (hfmac->Instance == FMAC) {
+        __HAL_RCC_FMAC_FORCE_RESET();
+        __HAL_RCC_FMAC_RELEASE_RESET();
+        __HAL_RCC_FMAC_CLK_DISABLE();
+
+        HAL_NVIC_DisableIRQ(DMA2_Channel5_IRQn);
+        HAL_NVIC_DisableIRQ(DMA2_Channel6_IRQn);
+        HAL_NVIC_DisableIRQ(FMAC_IRQn);
+
+        HAL_DMA_DeInit(&dma11Handle);
+        HAL_DMA_DeInit(&dma12Handle);
+    }
+}
+
+/**
+ * @brief Initialize the CORDIC module, turn ON a clock source (the zero-overhead mode, no DMA and interrupts)
+ * @param hcordic is the pointer to the data structure of the CORDIC handle (HAL).
+ */
+void HAL_CORDIC_MspInit(CORDIC_HandleTypeDef *hcordic) {
+    if (hcordic->Instance == CORDIC)
+        __HAL_RCC_CORDIC_CLK_ENABLE();
+}
+
+/**
+ * @brief DeInitialize the CORDIC module
+ * @param hcordic is the pointer to the data structure of the CORDIC handle (HAL).
+ */
+void HAL_CORDIC_MspDeInit(CORDIC_HandleTypeDef *hcordic) {
+    if (hcordic->Instance == CORDIC) {
+        __HAL_RCC_CORDIC_FORCE_RESET();
+        __HAL_RCC_CORDIC_RELEASE_RESET();
+        __HAL_RCC_CORDIC_CLK_DISABLE();
+    }
+}
+
 /**
   * @brief  Initialize the PPP MSP.
   * @param  None
@@ -23,6 +23,7 @@
 
 #include "stm32g4xx_it.h"
 #include "jobs.h"
+#include "cycles.h"
 /******************************************************************************/
 /*           Cortex-M4 Processor Interruption and Exception Handlers          */
 /******************************************************************************/
@@ -78,33 +79,103 @@ void DebugMon_Handler(void) {
 /******************************************************************************/
 
 void DMA1_Channel1_IRQHandler(void) {
-    HAL_DMA_IRQHandler(((ADC_HandleTypeDef *) Application.hardware.adc.handle)->DMA_Handle);
+    AdcDef *adc = &Application.hardware.adc;
+    uint32_t start = getCycleCounter();
+
+    HAL_DMA_IRQHandler(((ADC_HandleTypeDef *) adc->handle)->DMA_Handle);
+
+    // the ISR load of the ADC acquisition
+    adc->isrCycles += getCycleCounter() - start;
+    adc->interrupts++;
 }
 
 void DMA1_Channel4_IRQHandler(void) {
-    HAL_DMA_IRQHandler(((UART_HandleTypeDef *) Serial.uart->handle)->hdmatx);
+    HAL_DMA_IRQHandler(((UART_HandleTypeDef *) UART1_intf.handle)->hdmatx);
 }
 
 void DMA1_Channel5_IRQHandler(void) {
-    HAL_DMA_IRQHandler(((UART_HandleTypeDef *) Serial.uart->handle)->hdmarx);
+    HAL_DMA_IRQHandler(((UART_HandleTypeDef *) UART1_intf.handle)->hdmarx);
 }
 
 void USART1_IRQHandler(void) {
-    HAL_UART_IRQHandler((UART_HandleTypeDef *) Serial.uart->handle);
+    HAL_UART_IRQHandler((UART_HandleTypeDef *) UART1_intf.handle);
+}
+
+void DMA2_Channel1_IRQHandler(void) {
+    HAL_DMA_IRQHandler(((UART_HandleTypeDef *) LPUART1_intf.handle)->hdmatx);
+}
+
+void DMA2_Channel2_IRQHandler(void) {
+    HAL_DMA_IRQHandler(((UART_HandleTypeDef *) LPUART1_intf.handle)->hdmarx);
+}
+
+void LPUART1_IRQHandler(void) {
+    HAL_UART_IRQHandler((UART_HandleTypeDef *) LPUART1_intf.handle);
+}
+
+/**
+ * @brief Serve the error interrupt of the I2C controller interface
+ * @param handle is the I2C handle structure (HAL)
+ */
+static void serveI2CError(I2C_HandleTypeDef *handle) {
+    // HAL doesn't serve the SCL low timeout (TIMEOUTR), the bus is recovered by the I2C interface task
+    if (__HAL_I2C_GET_FLAG(handle, I2C_FLAG_TIMEOUT)) {
+        __HAL_I2C_CLEAR_FLAG(handle, I2C_FLAG_TIMEOUT);
+        handle->ErrorCode |= HAL_I2C_ERROR_TIMEOUT;
+        HAL_I2C_ErrorCallback(handle);
+    }
+
+    HAL_I2C_ER_IRQHandler(handle);
 }
 
 void DMA1_Channel2_IRQHandler(void) {
-    HAL_DMA_IRQHandler(((I2C_HandleTypeDef *) Sensors.interface.i2c->handle)->hdmatx);
+    HAL_DMA_IRQHandler(((I2C_HandleTypeDef *) I2C1_intf.handle)->hdmatx);
 }
 
 void DMA1_Channel3_IRQHandler(void) {
-    HAL_DMA_IRQHandler(((I2C_HandleTypeDef *) Sensors.interface.i2c->handle)->hdmarx);
+    HAL_DMA_IRQHandler(((I2C_HandleTypeDef *) I2C1_intf.handle)->hdmarx);
 }
 
 void I2C1_EV_IRQHandler(void) {
-    HAL_I2C_EV_IRQHandler((I2C_HandleTypeDef *) Sensors.interface.i2c->handle);
+    HAL_I2C_EV_IRQHandler((I2C_HandleTypeDef *) I2C1_intf.handle);
 }
 
 void I2C1_ER_IRQHandler(void) {
-    HAL_I2C_ER_IRQHandler((I2C_HandleTypeDef *) Sensors.interface.i2c->handle);
+    serveI2CError((I2C_HandleTypeDef *) I2C1_intf.handle);
+}
+
+void DMA1_Channel6_IRQHandler(void) {
+    HAL_DMA_IRQHandler(((I2C_HandleTypeDef *) I2C2_intf.handle)->hdmatx);
+}
+
+void DMA2_Channel4_IRQHandler(void) {
+    HAL_DMA_IRQHandler(((I2C_HandleTypeDef *) I2C2_intf.handle)->hdmarx);
+}
+
+void I2C2_EV_IRQHandler(void) {
+    HAL_I2C_EV_IRQHandler((I2C_HandleTypeDef *) I2C2_intf.handle);
+}
+
+void I2C2_ER_IRQHandler(void) {
+    serveI2CError((I2C_HandleTypeDef *) I2C2_intf.handle);
+}
+
+void I2C3_EV_IRQHandler(void) {
+    I2CTargetEventFromISR(&Target);
+}
+
+void I2C3_ER_IRQHandler(void) {
+    I2CTargetErrorFromISR(&Target);
+}
+
+void DMA2_Channel5_IRQHandler(void) {
+    HAL_DMA_IRQHandler(((FMAC_HandleTypeDef *) Application.hardware.handles.fmac)->hdmaIn);
+}
+
+void DMA2_Channel6_IRQHandler(void) {
+    HAL_DMA_IRQHandler(((FMAC_HandleTypeDef *) Application.hardware.handles.fmac)->hdmaOut);
+}
+
+void FMAC_IRQHandler(void) {
+    HAL_FMAC_IRQHandler((FMAC_HandleTypeDef *) Application.hardware.handles.fmac);
 }
@@ -91,10 +91,96 @@ static int32_t UART_getNumOfErrors(const UartDef *uart) {
     return uart->errors;
 }
 
-static UART_HandleTypeDef uart1Handle;
+/**
+ * @brief Get the kernel clock frequency of the UART interface
+ * @param huart is the UART handle structure (HAL)
+ * @return frequency (Hz)
+ */
+static uint32_t UART_getClock(const UART_HandleTypeDef *huart) {
+    if (huart->Instance == USART1)
+        return HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_USART1);
+    else if (huart->Instance == LPUART1)
+        return HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_LPUART1);
+
+    return HAL_RCC_GetPCLK1Freq();
+}
+
+/**
+ * @brief Change the baud rate of the UART interface, all current transfers are aborted
+ * @param uart is the base UART data structure
+ * @param baudRate is the required baud rate (bps), up to the UART kernel clock / 8 (LPUART - clock / 3)
+ * @return UART_Error value
+ */
+static int32_t UART_setBaudRate(UartDef *uart, uint32_t baudRate) {
+    if (uart == NULL || baudRate == 0)
+        return UART_WRONG_DATA;
+
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *) uart->handle;
+    uint32_t clock = UART_getClock(huart);
+    bool isLowPower = UART_INSTANCE_LOWPOWER(huart);
+    if (baudRate > ((isLowPower) ? clock / 3 : clock / 8))
+        return UART_WRONG_DATA;
+
+    if (HAL_UART_Abort(huart) != HAL_OK)
+        return UART_HW_ERROR;
+
+    // RM0440 Reference manual, 37.5.7 USART baud rate generation: oversampling by 8 - up to fCK / 8
+    huart->Init.BaudRate = baudRate;
+    // LPUART has no oversampling: 256 * fCK / baud rate >= 0x300
+    huart->Init.OverSampling = (baudRate > clock / 16 && !isLowPower) ? UART_OVERSAMPLING_8 : UART_OVERSAMPLING_16;
+    if (HAL_UART_Init(huart) != HAL_OK)
+        return UART_HW_ERROR;
+
+    // HAL_UART_Init resets the FIFO configuration
+    if (HAL_UARTEx_SetTxFifoThreshold(huart, UART_TXFIFO_THRESHOLD_1_2) != HAL_OK)
+        return UART_HW_ERROR;
+    if (HAL_UARTEx_SetRxFifoThreshold(huart, UART_RXFIFO_THRESHOLD_1_2) != HAL_OK)
+        return UART_HW_ERROR;
+    if (HAL_UARTEx_EnableFifoMode(huart) != HAL_OK)
+        return UART_HW_ERROR;
+
+    return UART_SUCCESS;
+}
 
-UartDef UART1_intf = {
-    &uart1Handle, false, UART_NOT_INIT, 1,
-    UART_init, UART_sendData, UART_readData,
-    UART_saveError, UART_getErrorType, UART_getNumOfErrors,
+/**
+ * @brief Get the current baud rate of the UART interface
+ * @param uart is the base UART data structure
+ * @return baud rate (bps)
+ */
+static int32_t UART_getBaudRate(const UartDef *uart) {
+    if (uart == NULL)
+        return UART_WRONG_DATA;
+
+    return (int32_t) ((const UART_HandleTypeDef *) uart->handle)->Init.BaudRate;
+}
+
+// the handles are stored in the table, so an interrupt callback finds its interface by the handle address;
+// only the interfaces with the MSP, IRQ and DMA wiring (stm32g4xx_hal_msp.c, stm32g4xx_it.c) are listed
+static UART_HandleTypeDef uartHandles[UART_NUMBER_INTERFACES];
+
+#define UART_INTERFACE(index) { \
+    &uartHandles[index], NULL, false, UART_NOT_INIT, 1, \
+    UART_init, UART_sendData, UART_readData, \
+    UART_saveError, UART_getErrorType, UART_getNumOfErrors, \
+    UART_setBaudRate, UART_getBaudRate, \
+}
+
+UartDef UART1_intf = UART_INTERFACE(UART1_INDEX);
+UartDef LPUART1_intf = UART_INTERFACE(LPUART1_INDEX);
+
+static UartDef *const uartInterfaces[UART_NUMBER_INTERFACES] = {
+    &UART1_intf, &LPUART1_intf,
 };
+
+/**
+ * @brief Get the UART interface by its handle (O(1), without the instance comparison)
+ * @param handle is the UART handle structure (HAL)
+ * @return the base UART data structure or NULL
+ */
+UartDef *UART_getInterface(const void *handle) {
+    const UART_HandleTypeDef *huart = (const UART_HandleTypeDef *) handle;
+    if (huart < uartHandles || huart >= uartHandles + UART_NUMBER_INTERFACES)
+        return NULL;
+
+    return uartInterfaces[huart - uartHandles];
+}
@@ -67,6 +67,49 @@ void setPWMDutyCycle(TimerDef *tim, uint16_t channel, uint8_t value) {
     __HAL_TIM_SET_COMPARE((TIM_HandleTypeDef *) tim->handle, channel, value);
 }
 
+/**
+ * @brief Start the block acquisition: the ADC scans are moved by circular DMA to the ping-pong buffer, the half
+ * transfer and the transfer complete interrupts mark the filled half (HAL_ADC_ConvHalfCpltCallback,
+ * HAL_ADC_ConvCpltCallback)
+ * @param adc is the base ADC data structure (the trigger timer must be started)
+ * @param scans is the block length (from 1 to ADC_MAX_BLOCK_SCANS scans)
+ * @return True - success, otherwise - False
+ */
+bool startADCBlocks(AdcDef *adc, uint16_t scans) {
+    if (scans == 0 || scans > ADC_MAX_BLOCK_SCANS)
+        return false;
+
+    adc->blockScans = scans;
+    adc->readyHalf = 0;
+    adc->blocks = adc->overruns = 0;
+    adc->interrupts = adc->isrCycles = 0;
+
+    // the memory width is a half-word, so the length is in samples
+    return HAL_ADC_Start_DMA((ADC_HandleTypeDef *) adc->handle, (uint32_t *) adc->buffer,
+                             2U * scans * NUMBER_ADC_CHANNELS) == HAL_OK;
+}
+
+/**
+ * @brief Process the last filled block: the channel averages (rawValues) and the block callback
+ * @param adc is the base ADC data structure
+ */
+void processADCBlock(AdcDef *adc) {
+    size_t length = (size_t) adc->blockScans * NUMBER_ADC_CHANNELS;
+    const uint16_t *block = &adc->buffer[adc->readyHalf * length];
+    uint32_t sums[NUMBER_ADC_CHANNELS] = {0};
+
+    for (size_t i = 0; i < length; i += NUMBER_ADC_CHANNELS) {
+        for (size_t j = 0; j < NUMBER_ADC_CHANNELS; ++j)
+            sums[j] += block[i + j];
+    }
+    for (size_t j = 0; j < NUMBER_ADC_CHANNELS; ++j)
+        adc->rawValues[j] = sums[j] / adc->blockScans;
+
+    if (adc->process)
+        adc->process(block, adc->blockScans, adc->arg);
+    adc->blocks++;
+}
+
 /**
  * @brief Get the MCU Unique ID
  * @return pointer to a unique id value
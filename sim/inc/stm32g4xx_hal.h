@@ -0,0 +1,89 @@
+#ifndef SIM_STM32G4XX_HAL_H
+#define SIM_STM32G4XX_HAL_H
+
+/*
+ * Linux host simulation: the HAL types, constants and macros are taken from the original HAL headers,
+ * the HAL functions are implemented by sim/src/hal_sim.c. The peripheral registers, accessed directly by
+ * the application macros (__HAL_RCC_xxx_CLK_ENABLE, __HAL_TIM_SET_COMPARE, ...), are redirected to the host memory.
+ */
+#include_next "stm32g4xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    RCC_TypeDef rcc;
+    GPIO_TypeDef gpioA;
+    GPIO_TypeDef gpioB;
+    GPIO_TypeDef gpioC;
+    TIM_TypeDef tim15;
+    TIM_TypeDef tim16;
+    ADC_TypeDef adc1;
+    USART_TypeDef usart1;
+    USART_TypeDef usart2;
+    USART_TypeDef usart3;
+    USART_TypeDef lpuart1;
+    I2C_TypeDef i2c1;
+    I2C_TypeDef i2c2;
+    I2C_TypeDef i2c3;
+    CRC_TypeDef crc;
+    IWDG_TypeDef iwdg;
+
+    // factory calibration values (system memory)
+    uint16_t tempSensorCal1;
+    uint16_t tempSensorCal2;
+    uint16_t vrefIntCal;
+} SimPeripheralsDef;
+
+extern SimPeripheralsDef SimPeripherals;
+
+#undef RCC
+#define RCC (&SimPeripherals.rcc)
+#undef GPIOA
+#define GPIOA (&SimPeripherals.gpioA)
+#undef GPIOB
+#define GPIOB (&SimPeripherals.gpioB)
+#undef GPIOC
+#define GPIOC (&SimPeripherals.gpioC)
+#undef TIM15
+#define TIM15 (&SimPeripherals.tim15)
+#undef TIM16
+#define TIM16 (&SimPeripherals.tim16)
+#undef ADC1
+#define ADC1 (&SimPeripherals.adc1)
+#undef USART1
+#define USART1 (&SimPeripherals.usart1)
+#undef USART2
+#define USART2 (&SimPeripherals.usart2)
+#undef USART3
+#define USART3 (&SimPeripherals.usart3)
+#undef LPUART1
+#define LPUART1 (&SimPeripherals.lpuart1)
+#undef I2C1
+#define I2C1 (&SimPeripherals.i2c1)
+#undef I2C2
+#define I2C2 (&SimPeripherals.i2c2)
+#undef I2C3
+#define I2C3 (&SimPeripherals.i2c3)
+#undef CRC
+#define CRC (&SimPeripherals.crc)
+#undef IWDG
+#define IWDG (&SimPeripherals.iwdg)
+
+#undef TEMPSENSOR_CAL1_ADDR
+#define TEMPSENSOR_CAL1_ADDR (&SimPeripherals.tempSensorCal1)
+#undef TEMPSENSOR_CAL2_ADDR
+#define TEMPSENSOR_CAL2_ADDR (&SimPeripherals.tempSensorCal2)
+#undef VREFINT_CAL_ADDR
+#define VREFINT_CAL_ADDR (&SimPeripherals.vrefIntCal)
+
+// there are no interrupts to mask, the "interrupts" are served by the simulation task (see hal_sim.c)
+#define __disable_irq() ((void) 0)
+#define __enable_irq() ((void) 0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //SIM_STM32G4XX_HAL_H
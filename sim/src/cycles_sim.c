@@ -0,0 +1,34 @@
+#define _GNU_SOURCE
+
+#include <time.h>
+
+#include "cycles.h"
+
+enum Cycles_Constants {
+    CYCLES_FREQUENCY_HZ = 1000000000, // the host counter ticks in nanoseconds
+};
+
+/**
+ * @brief Start the cycle counter (the host monotonic clock is always running)
+ */
+void initCycleCounter(void) {
+}
+
+/**
+ * @brief Get the current value of the cycle counter, it wraps around every 2^32 ns
+ * (use the unsigned difference of two values)
+ * @return the host monotonic clock (ns)
+ */
+uint32_t getCycleCounter(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint32_t) ((uint64_t) time.tv_sec * CYCLES_FREQUENCY_HZ + (uint64_t) time.tv_nsec);
+}
+
+/**
+ * @brief Get the frequency of the cycle counter
+ * @return the host counter frequency (Hz)
+ */
+uint32_t getCycleFrequency(void) {
+    return CYCLES_FREQUENCY_HZ;
+}
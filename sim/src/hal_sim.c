@@ -0,0 +1,836 @@
+#define _GNU_SOURCE
+
+// the HAL headers go first: termios.h defines CR1, CR2, ... (register names of the HAL structures)
+#include "stm32g4xx_hal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "i2c.h"
+#include "Filter.h"
+#include "Cordic.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+enum Sim_Constants {
+    SIM_NUMBER_UARTS = 4,
+    SIM_NUMBER_I2C = 2, // the controllers (I2C3 is the target)
+    SIM_I2C_NUMBER_DEVICES = 128,
+    SIM_I2C_NUMBER_REGISTERS = 256,
+    SIM_I2C_DEFAULT_VALUE = 0xFF,
+    SIM_EEPROM_ADDRESS = 0x50, // 24xx512: 64 KB, 2 address bytes (big-endian), 128-byte pages
+    SIM_EEPROM_SIZE = 65536,
+    SIM_EEPROM_PAGE_SIZE = 128,
+    SIM_EEPROM_WRITE_MS = 3, // the write cycle (typical, the datasheet maximum is 5 ms), the address is NACKed
+
+    SIM_ADC_FULL_SCALE = 4095,
+    SIM_ADC_SINE_PERIOD_MS = 1000, // analog input 1
+    SIM_ADC_RAMP_PERIOD_MS = 4000, // analog input 2
+    SIM_ADC_TEMPERATURE = 25, // Celsius
+    SIM_ADC_SCANS_PER_MS = 25, // the conversion sequences, TIM15 trigger - 25 kHz
+
+    SIM_SYSCLK_HZ = 144000000,
+    SIM_PCLK_HZ = 36000000,
+    SIM_HSI_HZ = 16000000,
+};
+
+typedef struct {
+    USART_TypeDef *instance;
+    const char *name;
+    UART_HandleTypeDef *huart;
+
+    int fd; // pseudo terminal (master side), -1 - not opened
+    int peerFd; // the slave side is kept open, so the master doesn't fail while no client is connected
+    uint32_t lostBytes; // the client doesn't read the pseudo terminal
+
+    bool isTxPending; // the transmission is complete, the callback hasn't been called yet
+    uint8_t *rxBuffer; // circular DMA buffer
+    uint16_t rxSize;
+    uint16_t rxPosition;
+} SimUartDef;
+
+typedef struct {
+    I2C_TypeDef *instance;
+    I2C_HandleTypeDef *hi2c;
+    bool isPending;
+    bool isRead;
+    bool isNack; // the pending transfer ends with the error (HAL_I2C_ERROR_AF)
+
+    // every bus has its own devices, they are simple register files: the first written byte is the register
+    // address (auto increment)
+    uint8_t registers[SIM_I2C_NUMBER_DEVICES][SIM_I2C_NUMBER_REGISTERS];
+    uint8_t pointers[SIM_I2C_NUMBER_DEVICES];
+
+    // except SIM_EEPROM_ADDRESS: the write wraps around the page, the read - around the memory
+    uint8_t eeprom[SIM_EEPROM_SIZE];
+    uint16_t eepromPointer;
+    bool isEepromWriting;
+    TickType_t eepromWriteTime; // the write cycle start
+} SimI2CDef;
+
+typedef struct {
+    ADC_HandleTypeDef *hadc;
+    uint16_t *data; // the circular buffer of the half-word samples (two halves)
+    uint32_t length;
+    uint32_t channels; // the conversion sequence length
+    uint32_t ratio; // the hardware oversampling: the accumulated conversions
+    uint32_t shift; // the hardware oversampling: the right shift of the sum
+    uint32_t scans; // the sequences, which are converted but not moved to the buffer yet
+    uint32_t sample; // the sequence counter (the waveform time)
+    uint8_t half; // the next half to fill
+    TickType_t time; // the last conversion
+} SimADCDef;
+
+SimPeripheralsDef SimPeripherals = {
+    // STM32G431 typical calibration values (VREF+ = 3.0 V): TS_CAL1 - 30 C, TS_CAL2 - 130 C
+    .tempSensorCal1 = 1034,
+    .tempSensorCal2 = 1375,
+    .vrefIntCal = 1655,
+};
+
+uint32_t SystemCoreClock = SIM_SYSCLK_HZ;
+__IO uint32_t uwTick;
+uint32_t uwTickPrio = TICK_INT_PRIORITY;
+uint32_t uwTickFreq = HAL_TICK_FREQ_DEFAULT;
+
+static SimUartDef uarts[SIM_NUMBER_UARTS] = {
+    {.instance = USART1, .name = "USART1", .fd = -1, .peerFd = -1},
+    {.instance = USART2, .name = "USART2", .fd = -1, .peerFd = -1},
+    {.instance = USART3, .name = "USART3", .fd = -1, .peerFd = -1},
+    {.instance = LPUART1, .name = "LPUART1", .fd = -1, .peerFd = -1},
+};
+static SimI2CDef i2cBuses[SIM_NUMBER_I2C] = {
+    {.instance = I2C1},
+    {.instance = I2C2},
+};
+static SimADCDef adc;
+
+static TaskHandle_t simTask;
+static StaticTask_t simTaskTCB;
+static StackType_t simTaskStack[configMINIMAL_STACK_SIZE];
+
+/**
+ * @brief Stop the simulation (FreeRTOS configASSERT)
+ * @param file is the source file name
+ * @param line is the source line number
+ */
+void vAssertCalled(const char *file, unsigned long line) {
+    fprintf(stderr, "[sim] assertion failed: %s:%lu\n", file, line);
+    abort();
+}
+
+/**
+ * @brief Wake up the simulation task to serve the "interrupts" immediately (DMA transfer complete)
+ */
+static void wakeSimulation(void) {
+    if (simTask && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+        xTaskNotifyGive(simTask);
+}
+
+/**
+ * @brief Get the simulated UART by its HAL handle
+ * @param huart is the UART handle structure (HAL)
+ * @return the simulated UART or NULL
+ */
+static SimUartDef *getUart(const UART_HandleTypeDef *huart) {
+    for (size_t i = 0; i < SIM_NUMBER_UARTS; ++i) {
+        if (uarts[i].instance == huart->Instance)
+            return &uarts[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the simulated I2C bus by its HAL handle
+ * @param hi2c is the I2C handle structure (HAL)
+ * @return the simulated I2C bus or NULL
+ */
+static SimI2CDef *getI2C(const I2C_HandleTypeDef *hi2c) {
+    for (size_t i = 0; i < SIM_NUMBER_I2C; ++i) {
+        if (i2cBuses[i].instance == hi2c->Instance)
+            return &i2cBuses[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Write to the simulated device: the first byte is the register address (2 bytes for the EEPROM)
+ * @param i2c is the simulated I2C bus
+ * @param address is the device address (7 bits)
+ * @param data is the written data
+ * @param size is the data size (bytes)
+ */
+static void writeI2CDevice(SimI2CDef *i2c, uint8_t address, const uint8_t *data, size_t size) {
+    if (address != SIM_EEPROM_ADDRESS) {
+        i2c->pointers[address] = data[0];
+        for (size_t i = 1; i < size; ++i)
+            i2c->registers[address][i2c->pointers[address]++] = data[i];
+        return;
+    }
+
+    if (size < 2)
+        return;
+
+    uint16_t pointer = (uint16_t) ((data[0] << 8) | data[1]);
+    uint16_t page = pointer & (uint16_t) ~(SIM_EEPROM_PAGE_SIZE - 1);
+    for (size_t i = 2; i < size; ++i) {
+        i2c->eeprom[pointer] = data[i];
+        pointer = page | ((pointer + 1) & (SIM_EEPROM_PAGE_SIZE - 1));
+    }
+    i2c->eepromPointer = pointer;
+
+    // only the address write (the read pointer, the ACK polling) doesn't start the write cycle
+    if (size > 2) {
+        i2c->isEepromWriting = true;
+        i2c->eepromWriteTime = xTaskGetTickCount();
+    }
+}
+
+/**
+ * @brief Check, that the simulated EEPROM is in the write cycle (it doesn't acknowledge its address)
+ * @param i2c is the simulated I2C bus
+ * @return True - busy, otherwise - False
+ */
+static bool isEepromBusy(SimI2CDef *i2c) {
+    if (i2c->isEepromWriting && xTaskGetTickCount() - i2c->eepromWriteTime >= pdMS_TO_TICKS(SIM_EEPROM_WRITE_MS))
+        i2c->isEepromWriting = false;
+
+    return i2c->isEepromWriting;
+}
+
+/**
+ * @brief Read from the simulated device (auto increment)
+ * @param i2c is the simulated I2C bus
+ * @param address is the device address (7 bits)
+ * @param data is the destination buffer
+ * @param size is the data size (bytes)
+ */
+static void readI2CDevice(SimI2CDef *i2c, uint8_t address, uint8_t *data, size_t size) {
+    if (address != SIM_EEPROM_ADDRESS) {
+        for (size_t i = 0; i < size; ++i)
+            data[i] = i2c->registers[address][i2c->pointers[address]++];
+        return;
+    }
+
+    for (size_t i = 0; i < size; ++i)
+        data[i] = i2c->eeprom[i2c->eepromPointer++];
+}
+
+/**
+ * @brief Do the transfer at once, the completion callback is called by the simulation task
+ * @param hi2c is the I2C handle structure (HAL)
+ * @param DevAddress is the device address (shifted left)
+ * @param data is the source or destination buffer
+ * @param size is the data size (bytes)
+ * @param isRead flag, True - read, otherwise - write
+ * @return HAL status
+ */
+static HAL_StatusTypeDef startI2CTransfer(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *data, size_t size,
+                                          bool isRead) {
+    if (data == NULL || size == 0)
+        return HAL_ERROR;
+
+    SimI2CDef *i2c = getI2C(hi2c);
+    if (i2c == NULL)
+        return HAL_ERROR;
+    if (hi2c->State != HAL_I2C_STATE_READY)
+        return HAL_BUSY;
+
+    uint8_t address = (uint8_t) ((DevAddress >> 1) % SIM_I2C_NUMBER_DEVICES);
+    i2c->isNack = (address == SIM_EEPROM_ADDRESS && isEepromBusy(i2c));
+    hi2c->ErrorCode = (i2c->isNack) ? HAL_I2C_ERROR_AF : HAL_I2C_ERROR_NONE;
+    if (!i2c->isNack && isRead)
+        readI2CDevice(i2c, address, data, size);
+    else if (!i2c->isNack)
+        writeI2CDevice(i2c, address, data, size);
+
+    hi2c->State = (isRead) ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+    i2c->hi2c = hi2c;
+    i2c->isRead = isRead;
+    i2c->isPending = true;
+    wakeSimulation();
+    return HAL_OK;
+}
+
+/**
+ * @brief Open the pseudo terminal (raw mode), that is connected to the simulated UART
+ * @param uart is the simulated UART
+ * @return True - the pseudo terminal has been opened, otherwise - False
+ */
+static bool openTerminal(SimUartDef *uart) {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0)
+        return false;
+
+    const char *name = (grantpt(fd) == 0 && unlockpt(fd) == 0) ? ptsname(fd) : NULL;
+    int peerFd = (name) ? open(name, O_RDWR | O_NOCTTY) : -1;
+    if (peerFd < 0) {
+        close(fd);
+        return false;
+    }
+
+    struct termios settings;
+    if (tcgetattr(peerFd, &settings) == 0) {
+        cfmakeraw(&settings);
+        tcsetattr(peerFd, TCSANOW, &settings);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    uart->fd = fd;
+    uart->peerFd = peerFd;
+    printf("[sim] %s: %s\n", uart->name, name);
+    return true;
+}
+
+/**
+ * @brief Serve the simulated UART: complete the transmission and move the received data to the DMA buffer
+ * (Transfer Complete and IDLE events)
+ * @param uart is the simulated UART
+ */
+static void serveUart(SimUartDef *uart) {
+    UART_HandleTypeDef *huart = uart->huart;
+    if (huart == NULL || uart->fd < 0)
+        return;
+
+    if (uart->isTxPending) {
+        uart->isTxPending = false;
+        huart->gState = HAL_UART_STATE_READY;
+        HAL_UART_TxCpltCallback(huart);
+    }
+
+    if (huart->RxState != HAL_UART_STATE_BUSY_RX)
+        return;
+
+    bool isReceived = false;
+    while (1) {
+        ssize_t numBytes = read(uart->fd, uart->rxBuffer + uart->rxPosition, uart->rxSize - uart->rxPosition);
+        if (numBytes <= 0)
+            break;
+
+        uart->rxPosition = (uint16_t) (uart->rxPosition + numBytes);
+        isReceived = true;
+        if (uart->rxPosition == uart->rxSize) {
+            // circular mode: the DMA continues from the beginning of the buffer
+            uart->rxPosition = 0;
+            isReceived = false;
+            huart->RxEventType = HAL_UART_RXEVENT_TC;
+            HAL_UARTEx_RxEventCallback(huart, uart->rxSize);
+        }
+    }
+
+    if (isReceived) {
+        huart->RxEventType = HAL_UART_RXEVENT_IDLE;
+        HAL_UARTEx_RxEventCallback(huart, uart->rxPosition);
+    }
+}
+
+/**
+ * @brief Serve the simulated I2C bus: complete the transfer (or report NACK of the busy EEPROM)
+ * @param i2c is the simulated I2C bus
+ */
+static void serveI2C(SimI2CDef *i2c) {
+    if (!i2c->isPending)
+        return;
+
+    i2c->isPending = false;
+    i2c->hi2c->State = HAL_I2C_STATE_READY;
+    if (i2c->isNack)
+        HAL_I2C_ErrorCallback(i2c->hi2c);
+    else if (i2c->isRead)
+        HAL_I2C_MasterRxCpltCallback(i2c->hi2c);
+    else
+        HAL_I2C_MasterTxCpltCallback(i2c->hi2c);
+}
+
+/**
+ * @brief Serve the simulated ADC: the conversion sequences are accumulated at the trigger rate, each filled half of
+ * the DMA buffer is reported by the half transfer or the transfer complete callback. The analog inputs are fed with
+ * generated waveforms (sine and ramp), the temperature sensor - with a constant value
+ */
+static void serveADC(void) {
+    TickType_t time = xTaskGetTickCount();
+    if (adc.hadc == NULL || adc.time == time)
+        return;
+
+    adc.scans += (time - adc.time) * SIM_ADC_SCANS_PER_MS;
+    adc.time = time;
+
+    uint32_t halfScans = adc.length / (2 * adc.channels);
+    if (adc.scans < halfScans)
+        return;
+    adc.scans = (adc.scans - halfScans) % halfScans; // the older halves are overwritten (DMA overrun)
+
+    // the inverse of __LL_ADC_CALC_TEMPERATURE
+    int32_t cal1 = SimPeripherals.tempSensorCal1;
+    int32_t cal2 = SimPeripherals.tempSensorCal2;
+    int32_t raw = cal1 + (SIM_ADC_TEMPERATURE - TEMPSENSOR_CAL1_TEMP) * (cal2 - cal1) /
+                         (TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP);
+    uint32_t temperature = (uint32_t) (raw * TEMPSENSOR_CAL_VREFANALOG / (int32_t) VDD_VALUE);
+
+    uint16_t *data = &adc.data[adc.half * halfScans * adc.channels];
+    for (uint32_t scan = 0; scan < halfScans; ++scan, ++adc.sample) {
+        float ms = (float) adc.sample / SIM_ADC_SCANS_PER_MS;
+        for (uint32_t i = 0; i + 1 < adc.channels; ++i) {
+            float value = 0.5f;
+            if (i == 0) {
+                float phase = fmodf(ms, SIM_ADC_SINE_PERIOD_MS) / SIM_ADC_SINE_PERIOD_MS;
+                value = 0.5f + 0.5f * sinf(2.0f * (float) M_PI * phase);
+            } else if (i == 1) {
+                value = fmodf(ms, SIM_ADC_RAMP_PERIOD_MS) / SIM_ADC_RAMP_PERIOD_MS;
+            }
+            data[i] = (uint16_t) (((uint32_t) (value * SIM_ADC_FULL_SCALE) * adc.ratio) >> adc.shift);
+        }
+        data[adc.channels - 1] = (uint16_t) ((temperature * adc.ratio) >> adc.shift);
+        data += adc.channels;
+    }
+
+    if (adc.half == 0)
+        HAL_ADC_ConvHalfCpltCallback(adc.hadc);
+    else
+        HAL_ADC_ConvCpltCallback(adc.hadc);
+    adc.half ^= 1;
+}
+
+/**
+ * @brief Simulation task, it has the highest priority and plays the role of the interrupt handlers
+ * (DMA, UART, I2C and ADC callbacks are called from here)
+ * @param arg is the function argument to which the scheduler will send the specified parameter
+ */
+static void SimJob(void *arg) {
+    (void) arg;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, 1);
+
+        for (size_t i = 0; i < SIM_NUMBER_UARTS; ++i)
+            serveUart(&uarts[i]);
+        for (size_t i = 0; i < SIM_NUMBER_I2C; ++i)
+            serveI2C(&i2cBuses[i]);
+        serveADC();
+    }
+}
+
+HAL_StatusTypeDef HAL_Init(void) {
+    for (size_t i = 0; i < SIM_NUMBER_I2C; ++i) {
+        memset(i2cBuses[i].registers, SIM_I2C_DEFAULT_VALUE, sizeof(i2cBuses[i].registers));
+        memset(i2cBuses[i].eeprom, SIM_I2C_DEFAULT_VALUE, sizeof(i2cBuses[i].eeprom));
+    }
+
+    simTask = xTaskCreateStatic(SimJob, "simulation", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1,
+                                simTaskStack, &simTaskTCB);
+    return (simTask) ? HAL_OK : HAL_ERROR;
+}
+
+void HAL_IncTick(void) {
+    uwTick += uwTickFreq;
+}
+
+uint32_t HAL_GetTick(void) {
+    return uwTick;
+}
+
+void HAL_NVIC_SetPriorityGrouping(uint32_t PriorityGroup) {
+    (void) PriorityGroup;
+}
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling) {
+    (void) VoltageScaling;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(const RCC_OscInitTypeDef *RCC_OscInitStruct) {
+    (void) RCC_OscInitStruct;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(const RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency) {
+    (void) RCC_ClkInitStruct;
+    (void) FLatency;
+    return HAL_OK;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return SIM_PCLK_HZ;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+    return SIM_PCLK_HZ;
+}
+
+uint32_t HAL_RCCEx_GetPeriphCLKFreq(uint32_t PeriphClk) {
+    // the same clock sources as in stm32g4xx_hal_msp.c
+    if (PeriphClk == RCC_PERIPHCLK_USART1)
+        return SIM_SYSCLK_HZ;
+    if (PeriphClk == RCC_PERIPHCLK_I2C1 || PeriphClk == RCC_PERIPHCLK_I2C2 || PeriphClk == RCC_PERIPHCLK_I2C3)
+        return SIM_HSI_HZ;
+    return SIM_PCLK_HZ;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+    (void) GPIOx;
+    (void) GPIO_Init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    // nothing else drives the lines: the input follows the output (I2C bus recovery reads SDA back)
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+        GPIOx->IDR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t) GPIO_Pin;
+        GPIOx->IDR &= ~(uint32_t) GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim) {
+    htim->State = HAL_TIM_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim) {
+    htim->State = HAL_TIM_STATE_BUSY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim) {
+    htim->State = HAL_TIM_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, const TIM_OC_InitTypeDef *sConfig,
+                                            uint32_t Channel) {
+    __HAL_TIM_SET_COMPARE(htim, Channel, sConfig->Pulse);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    (void) htim;
+    (void) Channel;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_PWMN_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    (void) htim;
+    (void) Channel;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+                                                        const TIM_MasterConfigTypeDef *sMasterConfig) {
+    (void) htim;
+    (void) sMasterConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_ConfigDeadTime(TIM_HandleTypeDef *htim, uint32_t Deadtime) {
+    (void) htim;
+    (void) Deadtime;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc) {
+    hadc->State = HAL_ADC_STATE_READY;
+    hadc->ErrorCode = HAL_ADC_ERROR_NONE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, const ADC_ChannelConfTypeDef *pConfig) {
+    (void) hadc;
+    (void) pConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t SingleDiff) {
+    (void) hadc;
+    (void) SingleDiff;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length) {
+    uint32_t channels = hadc->Init.NbrOfConversion;
+    if (pData == NULL || channels == 0 || Length == 0 || Length % (2 * channels) != 0)
+        return HAL_ERROR;
+
+    // the half-word memory alignment (see HAL_ADC_MspInit)
+    adc.data = (uint16_t *) pData;
+    adc.length = Length;
+    adc.channels = channels;
+    adc.ratio = 1;
+    adc.shift = 0;
+    if (hadc->Init.OversamplingMode == ENABLE) {
+        adc.ratio = 2U << ((hadc->Init.Oversampling.Ratio & ADC_CFGR2_OVSR) >> ADC_CFGR2_OVSR_Pos);
+        adc.shift = (hadc->Init.Oversampling.RightBitShift & ADC_CFGR2_OVSS) >> ADC_CFGR2_OVSS_Pos;
+    }
+    adc.scans = adc.sample = 0;
+    adc.half = 0;
+    adc.time = xTaskGetTickCount();
+    adc.hadc = hadc;
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetError(const ADC_HandleTypeDef *hadc) {
+    return hadc->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart) {
+    SimUartDef *uart = getUart(huart);
+    if (uart == NULL)
+        return HAL_ERROR;
+
+    // the baud rate change initializes UART again, the pseudo terminal stays the same
+    if (uart->fd < 0 && !openTerminal(uart))
+        return HAL_ERROR;
+
+    uart->huart = huart;
+    uart->isTxPending = false;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_SetTxFifoThreshold(UART_HandleTypeDef *huart, uint32_t Threshold) {
+    (void) huart;
+    (void) Threshold;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_SetRxFifoThreshold(UART_HandleTypeDef *huart, uint32_t Threshold) {
+    (void) huart;
+    (void) Threshold;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_EnableFifoMode(UART_HandleTypeDef *huart) {
+    huart->FifoMode = UART_FIFOMODE_ENABLE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size) {
+    SimUartDef *uart = getUart(huart);
+    if (uart == NULL || uart->fd < 0 || pData == NULL || Size == 0)
+        return HAL_ERROR;
+    if (huart->gState != HAL_UART_STATE_READY)
+        return HAL_BUSY;
+
+    // the data are sent at once, the bytes that don't fit into the pseudo terminal are lost (no client)
+    size_t numBytes = 0;
+    while (numBytes < Size) {
+        ssize_t result = write(uart->fd, pData + numBytes, Size - numBytes);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            break;
+        numBytes += (size_t) result;
+    }
+    uart->lostBytes += (uint32_t) (Size - numBytes);
+
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    uart->isTxPending = true;
+    wakeSimulation();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    SimUartDef *uart = getUart(huart);
+    if (uart == NULL || pData == NULL || Size == 0)
+        return HAL_ERROR;
+    if (huart->RxState != HAL_UART_STATE_READY)
+        return HAL_BUSY;
+
+    uart->rxBuffer = pData;
+    uart->rxSize = Size;
+    uart->rxPosition = 0;
+    huart->ReceptionType = HAL_UART_RECEPTION_TOIDLE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart) {
+    SimUartDef *uart = getUart(huart);
+    if (uart == NULL)
+        return HAL_ERROR;
+
+    uart->isTxPending = false;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+uint32_t HAL_UART_GetError(const UART_HandleTypeDef *huart) {
+    return huart->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                uint32_t DataLength) {
+    (void) SrcAddress;
+    (void) DstAddress;
+    (void) DataLength;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->State = HAL_I2C_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+    SimI2CDef *i2c = getI2C(hi2c);
+    if (i2c && i2c->hi2c == hi2c)
+        i2c->isPending = false;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->State = HAL_I2C_STATE_RESET;
+    return HAL_OK;
+}
+
+void HAL_I2CEx_EnableFastModePlus(uint32_t ConfigFastModePlus) {
+    (void) ConfigFastModePlus;
+}
+
+void HAL_I2CEx_DisableFastModePlus(uint32_t ConfigFastModePlus) {
+    (void) ConfigFastModePlus;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigAnalogFilter(I2C_HandleTypeDef *hi2c, uint32_t AnalogFilter) {
+    (void) hi2c;
+    (void) AnalogFilter;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigDigitalFilter(I2C_HandleTypeDef *hi2c, uint32_t DigitalFilter) {
+    (void) hi2c;
+    (void) DigitalFilter;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                  uint16_t Size, uint32_t XferOptions) {
+    (void) XferOptions;
+    return startI2CTransfer(hi2c, DevAddress, pData, Size, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                 uint16_t Size, uint32_t XferOptions) {
+    (void) XferOptions;
+    return startI2CTransfer(hi2c, DevAddress, pData, Size, true);
+}
+
+/**
+ * @brief The reload engine (app/src/i2c_reload.c) isn't linked to the simulator: the whole transfer is done at once,
+ * only the NBYTES reloads are counted (the engine is checked on the simulated registers by sim/tests/test_i2c_reload.c)
+ */
+int32_t I2C_startReload(I2CDef *i2c, uint16_t addr, void *data, size_t size, bool isRead, bool isNeedStop) {
+    (void) isNeedStop;
+    if (i2c == NULL || data == NULL || size == 0)
+        return I2C_WRONG_DATA;
+
+    if (startI2CTransfer((I2C_HandleTypeDef *) i2c->handle, (uint16_t) (addr << 1), data, size, isRead) != HAL_OK)
+        return I2C_HW_ERROR;
+
+    i2c->reload.reloads += (uint32_t) ((size - 1) / I2C_MAX_NBYTES);
+    return I2C_SUCCESS;
+}
+
+uint32_t HAL_I2C_GetError(const I2C_HandleTypeDef *hi2c) {
+    return hi2c->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_FMAC_Init(FMAC_HandleTypeDef *hfmac) {
+    hfmac->State = HAL_FMAC_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief The FMAC (app/src/filter_fmac.c) isn't simulated at the register level: the block is filtered by the
+ * software engine (the same q1.15 results) and completed at once
+ */
+int32_t Filter_configHardware(FilterDef *filter) {
+    memset(filter->inputs, 0, sizeof(filter->inputs));
+    memset(filter->outputs, 0, sizeof(filter->outputs));
+    filter->isStarted = false;
+    return FILTER_SUCCESS;
+}
+
+int32_t Filter_startHardware(FilterDef *filter, size_t size) {
+    BaseType_t priorityTaskWoken = pdFALSE;
+
+    filter->isStarted = true;
+    FilterSoftware(filter, filter->input, filter->output, size);
+    FilterCompleteFromISR(filter, FILTER_SUCCESS, &priorityTaskWoken);
+    return FILTER_SUCCESS;
+}
+
+void Filter_stopHardware(FilterDef *filter) {
+    Filter_configHardware(filter);
+}
+
+HAL_StatusTypeDef HAL_CORDIC_Init(CORDIC_HandleTypeDef *hcordic) {
+    hcordic->State = HAL_CORDIC_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief The CORDIC (app/src/cordic_hw.c) isn't simulated at the register level: the batch is calculated by the
+ * software engine (libm, within the CORDIC precision)
+ */
+int32_t Cordic_configHardware(CordicDef *cordic) {
+    (void) cordic;
+    return CORDIC_SUCCESS;
+}
+
+int32_t Cordic_calculateHardware(CordicDef *cordic, const int32_t *src, int32_t *dst, size_t count) {
+    CordicSoftware(cordic->function, cordic->scale, src, dst, count);
+    return CORDIC_SUCCESS;
+}
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc) {
+    hcrc->State = HAL_CRC_STATE_READY;
+    return HAL_OK;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength) {
+    // the settings of settingCRC: bytes, 0x04C11DB7, init 0xFFFFFFFF, input/output inversion (no final XOR)
+    const uint8_t *data = (const uint8_t *) pBuffer;
+    uint32_t crc = 0xFFFFFFFFU;
+    for (uint32_t i = 0; i < BufferLength; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1U) ? (crc >> 1) ^ 0xEDB88320U : crc >> 1;
+    }
+
+    hcrc->State = HAL_CRC_STATE_READY;
+    return crc;
+}
+
+HAL_CRC_StateTypeDef HAL_CRC_GetState(const CRC_HandleTypeDef *hcrc) {
+    return hcrc->State;
+}
+
+HAL_StatusTypeDef HAL_IWDG_Init(IWDG_HandleTypeDef *hiwdg) {
+    (void) hiwdg;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_IWDG_Refresh(IWDG_HandleTypeDef *hiwdg) {
+    (void) hiwdg;
+    return HAL_OK;
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// the kernel hooks of the host tests: the kernel objects are created statically, the scheduler isn't started
+static StaticTask_t idleCB;
+static StackType_t idleStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t timerCB;
+static StackType_t timerStack[configTIMER_TASK_STACK_DEPTH];
+
+/**
+ * @brief The function is used to provide the memory for the RTOS Idle task
+ * @param ppxIdleTaskTCBBuffer
+ * @param ppxIdleTaskStackBuffer
+ * @param pulIdleTaskStackSize
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize) {
+    *ppxIdleTaskTCBBuffer = &idleCB;
+    *ppxIdleTaskStackBuffer = idleStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/**
+ * @brief The function is used to provide the memory for the RTOS Daemon/Timer Service task
+ * @param ppxTimerTaskTCBBuffer
+ * @param ppxTimerTaskStackBuffer
+ * @param pulTimerTaskStackSize
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize) {
+    *ppxTimerTaskTCBBuffer = &timerCB;
+    *ppxTimerTaskStackBuffer = timerStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+/**
+ * @brief The function is called every FreeRTOS tick (nothing to do, the tests don't run the scheduler)
+ */
+void vApplicationTickHook(void) {
+}
+
+/**
+ * @brief The function will be called if pvPortMalloc() ever returns NULL
+ */
+void vApplicationMallocFailedHook(void) {
+    fprintf(stderr, "[test] malloc failed\n");
+    abort();
+}
+
+/**
+ * @brief Stop the test (FreeRTOS configASSERT)
+ * @param file is the source file name
+ * @param line is the source line number
+ */
+void vAssertCalled(const char *file, unsigned long line) {
+    fprintf(stderr, "[test] assertion failed: %s:%lu\n", file, line);
+    abort();
+}
@@ -0,0 +1,32 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+/*
+ * The host tests (ctest): each test is a program, it calls the portable modules of the application directly
+ * (the scheduler isn't started), prints the failed checks and returns a non-zero exit code on any failure.
+ */
+static int testFailures = 0;
+
+#define TEST_CHECK(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            testFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+/**
+ * @brief Print the result of the test program
+ * @param name is the test name
+ * @return the exit code: 0 - all checks have passed, otherwise - 1
+ */
+static inline int testResult(const char *name) {
+    printf("%s: %s (%d failures)\n", name, (testFailures) ? "FAILED" : "passed", testFailures);
+    return (testFailures) ? 1 : 0;
+}
+
+#endif //HOST_TEST_H
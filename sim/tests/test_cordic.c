@@ -0,0 +1,179 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "Cordic.h"
+#include "host_test.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+enum CordicTest_Constants {
+    TEST_POINTS = 4096, // arguments per function and scale
+    TEST_TOLERANCE_LSB = 1 << (31 - 20), // the CORDIC precision: 20 bits of q1.31
+};
+
+// the argument ranges of the SQRT and LN scales (RM0440, see Cordic_Functions)
+static const double sqrtRanges[CORDIC_MAX_SQRT_SCALE + 1][2] = {{0.027, 0.75}, {0.75, 1.75}, {1.75, 2.341}};
+static const double lnRanges[CORDIC_MAX_LN_SCALE + 1][2] = {{0, 0}, {0.107, 1.0}, {1.0, 3.0}, {3.0, 7.0}, {7.0, 15.0}};
+
+// the CORDIC isn't given to the service: only the software engine is tested
+int32_t Cordic_configHardware(CordicDef *cordic) {
+    (void) cordic;
+    return CORDIC_HW_ERROR;
+}
+
+int32_t Cordic_calculateHardware(CordicDef *cordic, const int32_t *src, int32_t *dst, size_t count) {
+    (void) cordic;
+    (void) src;
+    (void) dst;
+    (void) count;
+    return CORDIC_HW_ERROR;
+}
+
+/**
+ * @brief Convert the value to q1.31 (the reference is rounded the same way, as the service does)
+ * @param value is the value in [-1, 1)
+ * @return q1.31 value
+ */
+static int32_t toQ31(double value) {
+    if (value >= 1.0)
+        return INT32_MAX;
+    if (value <= -1.0)
+        return INT32_MIN;
+    return (int32_t) lrint(value * 2147483648.0);
+}
+
+/**
+ * @brief Convert q1.31 to double
+ * @param value is q1.31 value
+ * @return the value
+ */
+static double fromQ31(int32_t value) {
+    return value / 2147483648.0;
+}
+
+/**
+ * @brief Compare the results against the double reference
+ * @param name is the function name
+ * @param scale is the scale of SQRT and LN
+ * @param results is the calculated results
+ * @param expected is the double reference (q1.31 units)
+ * @param count is the number of results
+ */
+static void checkResults(const char *name, uint8_t scale, const int32_t *results, const double *expected,
+                         size_t count) {
+    double maxDiff = 0;
+    size_t worst = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        double diff = fabs(results[i] - expected[i]);
+        if (diff > maxDiff) {
+            maxDiff = diff;
+            worst = i;
+        }
+    }
+    TEST_CHECK(maxDiff <= TEST_TOLERANCE_LSB, "%s, scale %u: %.0f LSB at %zu", name, scale, maxDiff, worst);
+}
+
+/**
+ * @brief SIN_COS over the whole circle, PHASE and MODULUS over the points inside the unit circle
+ */
+static void testTrigonometric(void) {
+    static int32_t src[2 * TEST_POINTS];
+    static int32_t dst[2 * TEST_POINTS];
+    static double expected[2 * TEST_POINTS];
+
+    for (size_t i = 0; i < TEST_POINTS; ++i) {
+        src[i] = (int32_t) (INT32_MIN + (int64_t) i * ((int64_t) UINT32_MAX / (TEST_POINTS - 1)));
+        double angle = fromQ31(src[i]) * M_PI;
+        expected[2 * i] = cos(angle) * 2147483648.0;
+        expected[2 * i + 1] = sin(angle) * 2147483648.0;
+    }
+    CordicSoftware(CORDIC_SIN_COS, 0, src, dst, TEST_POINTS);
+    // cos(0) and sin(pi / 2) saturate: 1 isn't q1.31
+    for (size_t i = 0; i < 2 * TEST_POINTS; ++i) {
+        if (expected[i] > INT32_MAX)
+            expected[i] = INT32_MAX;
+    }
+    checkResults("sin_cos", 0, dst, expected, 2 * TEST_POINTS);
+
+    srand(1);
+    for (size_t i = 0; i < TEST_POINTS; ++i) {
+        double radius = 0.999 * rand() / RAND_MAX;
+        double angle = 2.0 * M_PI * rand() / RAND_MAX - M_PI;
+        src[2 * i] = toQ31(radius * cos(angle));
+        src[2 * i + 1] = toQ31(radius * sin(angle));
+        expected[i] = atan2(fromQ31(src[2 * i + 1]), fromQ31(src[2 * i])) / M_PI * 2147483648.0;
+        if (expected[i] > INT32_MAX)
+            expected[i] = INT32_MAX;
+    }
+    CordicSoftware(CORDIC_PHASE, 0, src, dst, TEST_POINTS);
+    checkResults("phase", 0, dst, expected, TEST_POINTS);
+
+    for (size_t i = 0; i < TEST_POINTS; ++i)
+        expected[i] = hypot(fromQ31(src[2 * i]), fromQ31(src[2 * i + 1])) * 2147483648.0;
+    CordicSoftware(CORDIC_MODULUS, 0, src, dst, TEST_POINTS);
+    checkResults("modulus", 0, dst, expected, TEST_POINTS);
+}
+
+/**
+ * @brief SQRT and LN over the argument range of every scale
+ */
+static void testScaled(void) {
+    static int32_t src[TEST_POINTS];
+    static int32_t dst[TEST_POINTS];
+    static double expected[TEST_POINTS];
+
+    for (uint8_t scale = 0; scale <= CORDIC_MAX_SQRT_SCALE; ++scale) {
+        double low = sqrtRanges[scale][0];
+        double high = sqrtRanges[scale][1];
+        for (size_t i = 0; i < TEST_POINTS; ++i) {
+            src[i] = toQ31(ldexp(low + (high - low) * (double) i / TEST_POINTS, -scale));
+            expected[i] = ldexp(sqrt(ldexp(fromQ31(src[i]), scale)), -scale) * 2147483648.0;
+        }
+        CordicSoftware(CORDIC_SQRT, scale, src, dst, TEST_POINTS);
+        checkResults("sqrt", scale, dst, expected, TEST_POINTS);
+    }
+
+    for (uint8_t scale = CORDIC_MIN_LN_SCALE; scale <= CORDIC_MAX_LN_SCALE; ++scale) {
+        double low = lnRanges[scale][0];
+        double high = lnRanges[scale][1];
+        for (size_t i = 0; i < TEST_POINTS; ++i) {
+            src[i] = toQ31(ldexp(low + (high - low) * (double) i / TEST_POINTS, -scale));
+            expected[i] = ldexp(log(ldexp(fromQ31(src[i]), scale)), -(scale + 1)) * 2147483648.0;
+        }
+        CordicSoftware(CORDIC_LN, scale, src, dst, TEST_POINTS);
+        checkResults("ln", scale, dst, expected, TEST_POINTS);
+    }
+}
+
+/**
+ * @brief The service without the CORDIC: the software engine, the statistics, the wrong arguments
+ */
+static void testService(void) {
+    static CordicDef cordic;
+    const int32_t values[] = {toQ31(0.25), toQ31(0.5)};
+    int32_t results[4];
+
+    TEST_CHECK(CordicInit(&cordic, NULL) == CORDIC_SUCCESS, "init");
+    TEST_CHECK(CordicSqrt(&cordic, values, results, 2, 0) == CORDIC_SUCCESS &&
+               abs(results[0] - toQ31(0.5)) <= TEST_TOLERANCE_LSB, "sqrt(0.25): %d", (int) results[0]);
+    TEST_CHECK(CordicSinCos(&cordic, values, results, 2) == CORDIC_SUCCESS &&
+               abs(results[3] - toQ31(sin(M_PI / 2))) <= TEST_TOLERANCE_LSB, "sin(pi / 2): %d", (int) results[3]);
+    TEST_CHECK(cordic.operations == 4 && cordic.errors == 0 && cordic.reconfigurations == 0,
+               "statistics: %u operations, %u errors", (unsigned) cordic.operations, (unsigned) cordic.errors);
+
+    TEST_CHECK(CordicSqrt(&cordic, values, results, 2, CORDIC_MAX_SQRT_SCALE + 1) == CORDIC_WRONG_DATA, "sqrt scale");
+    TEST_CHECK(CordicLn(&cordic, values, results, 2, CORDIC_MIN_LN_SCALE - 1) == CORDIC_WRONG_DATA, "ln scale");
+    TEST_CHECK(CordicCalculate(&cordic, CORDIC_NUMBER_FUNCTIONS, 0, values, results, 1) == CORDIC_WRONG_DATA,
+               "function");
+    TEST_CHECK(CordicPhase(&cordic, values, results, 0) == CORDIC_WRONG_DATA, "count 0");
+}
+
+int main(void) {
+    testTrigonometric();
+    testScaled();
+    testService();
+    return testResult("test_cordic");
+}
@@ -0,0 +1,258 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "Decimator.h"
+#include "host_test.h"
+
+enum DecimatorTest_Constants {
+    TEST_INPUTS = 1 << 14, // per channel
+    TEST_MAX_CIC_TAPS = DECIMATOR_CIC_ORDER * ((1 << DECIMATOR_MAX_CIC_SHIFT) - 1) + 1,
+    TEST_INTERNAL_BITS = DECIMATOR_OUTPUT_BITS + DECIMATOR_GUARD_BITS,
+    TEST_LONG_INPUTS = 1 << 20, // the CIC integrators wrap around many times
+};
+
+static const int64_t halfBand[DECIMATOR_HALF_BAND_TAPS] = {-1, 0, 9, 16, 9, 0, -1};
+
+/*
+ * The reference model: the same chain, written as the direct convolutions over the whole input history (64-bit,
+ * no wrap-around), the CIC is the boxcar filter of length R convolved with itself 3 times
+ */
+typedef struct {
+    DecimatorStagesDef stages;
+    uint8_t inputBits;
+    int64_t cicTaps[TEST_MAX_CIC_TAPS];
+    size_t numCicTaps;
+
+    int64_t inputs[DECIMATOR_MAX_HALF_BANDS + 1][TEST_INPUTS]; // the input history of the CIC, half-bands
+    size_t counts[DECIMATOR_MAX_HALF_BANDS + 1];
+} ModelDef;
+
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint16_t last;
+} OutputRangeDef;
+
+static ModelDef model;
+static uint16_t samples[TEST_INPUTS];
+
+/**
+ * @brief Divide by 2^shift and round half up (a negative shift - multiply)
+ * @param value is the target value
+ * @param shift is the number of bits
+ * @return the rounded quotient
+ */
+static int64_t roundDivide(int64_t value, int shift) {
+    if (shift <= 0)
+        return value * ((int64_t) 1 << -shift);
+
+    int64_t divisor = (int64_t) 1 << shift;
+    int64_t numerator = value + divisor / 2;
+    int64_t quotient = numerator / divisor;
+    return (numerator % divisor < 0) ? quotient - 1 : quotient; // floor, the C division truncates toward zero
+}
+
+/**
+ * @brief Initialize the model: the CIC impulse response
+ * @param stages is the decimation stages
+ * @param inputBits is the sample width (bits)
+ */
+static void modelInit(const DecimatorStagesDef *stages, uint8_t inputBits) {
+    memset(&model, 0, sizeof(model));
+    model.stages = *stages;
+    model.inputBits = inputBits;
+
+    size_t ratio = (size_t) 1 << stages->cicShift;
+    model.cicTaps[0] = 1;
+    model.numCicTaps = 1;
+    for (size_t order = 0; order < DECIMATOR_CIC_ORDER; ++order) {
+        int64_t taps[TEST_MAX_CIC_TAPS] = {0};
+        for (size_t i = 0; i < model.numCicTaps; ++i) {
+            for (size_t j = 0; j < ratio; ++j)
+                taps[i + j] += model.cicTaps[i];
+        }
+        model.numCicTaps += ratio - 1;
+        memcpy(model.cicTaps, taps, sizeof(taps));
+    }
+}
+
+/**
+ * @brief Get the convolution of the taps and the newest samples of the history
+ * @param history is the samples
+ * @param count is the number of samples
+ * @param taps is the impulse response
+ * @param numTaps is the length of the impulse response
+ * @return the sum
+ */
+static int64_t convolve(const int64_t *history, size_t count, const int64_t *taps, size_t numTaps) {
+    int64_t sum = 0;
+    for (size_t k = 0; k < numTaps && k < count; ++k)
+        sum += taps[k] * history[count - 1 - k];
+    return sum;
+}
+
+/**
+ * @brief Pass the sample through the model
+ * @param sample is the input sample
+ * @param output is the output sample
+ * @return True - the output is produced, otherwise - False
+ */
+static bool modelPush(uint16_t sample, uint16_t *output) {
+    model.inputs[0][model.counts[0]++] = sample;
+    if (model.counts[0] % ((size_t) 1 << model.stages.cicShift) != 0)
+        return false;
+
+    int64_t cic = convolve(model.inputs[0], model.counts[0], model.cicTaps, model.numCicTaps);
+    int gainBits = model.inputBits + DECIMATOR_CIC_ORDER * model.stages.cicShift;
+    int64_t value = roundDivide(cic, gainBits - TEST_INTERNAL_BITS);
+
+    for (size_t i = 0; i < model.stages.halfBands; ++i) {
+        model.inputs[i + 1][model.counts[i + 1]++] = value;
+        if (model.counts[i + 1] % 2 != 0)
+            return false;
+        value = roundDivide(convolve(model.inputs[i + 1], model.counts[i + 1], halfBand, DECIMATOR_HALF_BAND_TAPS),
+                            DECIMATOR_HALF_BAND_SHIFT);
+    }
+
+    value = roundDivide(value, DECIMATOR_GUARD_BITS);
+    *output = (uint16_t) ((value < 0) ? 0 : (value > UINT16_MAX) ? UINT16_MAX : value);
+    return true;
+}
+
+/**
+ * @brief Run the decimator and the model on the same samples, compare every output
+ * @param stages is the decimation stages
+ * @param inputBits is the sample width (bits)
+ * @param size is the number of samples
+ * @param range is the minimum, the maximum and the last of the outputs
+ */
+static void compareWithModel(const DecimatorStagesDef *stages, uint8_t inputBits, size_t size,
+                             OutputRangeDef *range) {
+    static DecimatorDef dec;
+    TEST_CHECK(DecimatorInit(&dec, stages, 1, inputBits) == DECIMATOR_SUCCESS, "init: R = %d, half-bands %d",
+               1 << stages->cicShift, stages->halfBands);
+    modelInit(stages, inputBits);
+
+    range->min = UINT16_MAX;
+    range->max = range->last = 0;
+    size_t outputs = 0;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < size; ++i) {
+        uint16_t expected = 0;
+        bool isExpected = modelPush(samples[i], &expected);
+        bool isOutput = DecimatorPush(&dec, 0, samples[i]);
+
+        if (isOutput != isExpected || (isOutput && DecimatorGetOutput(&dec, 0) != expected)) {
+            if (mismatches++ == 0) {
+                TEST_CHECK(false, "R = %d, half-bands %d, input %zu: output %d (%d), model %d (%d)",
+                           1 << stages->cicShift, stages->halfBands, i, DecimatorGetOutput(&dec, 0), isOutput,
+                           expected, isExpected);
+            }
+        }
+        if (isOutput) {
+            outputs++;
+            if (expected < range->min)
+                range->min = expected;
+            if (expected > range->max)
+                range->max = expected;
+            range->last = expected;
+        }
+    }
+
+    size_t ratio = (size_t) 1 << (stages->cicShift + stages->halfBands);
+    TEST_CHECK(outputs == size / ratio && DecimatorGetOutputs(&dec, 0) == size / ratio,
+               "R = %d, half-bands %d: %zu outputs, expected %zu", 1 << stages->cicShift, stages->halfBands, outputs,
+               size / ratio);
+}
+
+/**
+ * @brief The pseudo-random samples and all stage combinations against the model
+ */
+static void testRandom(void) {
+    static const uint8_t widths[] = {12, 14};
+
+    srand(1);
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+        for (size_t i = 0; i < TEST_INPUTS; ++i)
+            samples[i] = (uint16_t) (rand() % (1 << widths[w]));
+
+        for (uint8_t cic = 0; cic <= DECIMATOR_MAX_CIC_SHIFT; ++cic) {
+            for (uint8_t bands = 0; bands <= DECIMATOR_MAX_HALF_BANDS; ++bands) {
+                DecimatorStagesDef stages = {cic, bands};
+                OutputRangeDef range;
+                compareWithModel(&stages, widths[w], TEST_INPUTS, &range);
+            }
+        }
+    }
+}
+
+/**
+ * @brief The DC full scale (4095 of 12 bits) settles at 4095 / 4096 of the output full scale, the steps overshoot
+ * into the saturation of the half-band stages (65535 and 0)
+ */
+static void testFullScale(void) {
+    const DecimatorStagesDef stages = {4, 2};
+    OutputRangeDef range;
+
+    for (size_t i = 0; i < TEST_INPUTS; ++i)
+        samples[i] = 4095;
+    compareWithModel(&stages, 12, TEST_INPUTS, &range);
+    TEST_CHECK(range.last == 65520, "DC full scale: %d", range.last);
+
+    // the square wave: the half-band overshoot is clipped at both ends
+    for (size_t i = 0; i < TEST_INPUTS; ++i)
+        samples[i] = ((i / 1024) % 2) ? 4095 : 0;
+    compareWithModel(&stages, 12, TEST_INPUTS, &range);
+    TEST_CHECK(range.min == 0 && range.max == UINT16_MAX, "saturation: %d ... %d", range.min, range.max);
+}
+
+/**
+ * @brief The long full scale run: the CIC integrators wrap around (modulo 2^32), the output stays correct
+ */
+static void testWrapAround(void) {
+    static DecimatorDef dec;
+    const DecimatorStagesDef stages = {DECIMATOR_MAX_CIC_SHIFT, 3};
+
+    DecimatorInit(&dec, &stages, 1, 14);
+    for (size_t i = 0; i < TEST_LONG_INPUTS; ++i)
+        DecimatorPush(&dec, 0, 16383);
+
+    TEST_CHECK(DecimatorGetOutput(&dec, 0) == 65532, "wrap-around: output %d", DecimatorGetOutput(&dec, 0));
+    TEST_CHECK(DecimatorGetOutputs(&dec, 0) == TEST_LONG_INPUTS >> (DECIMATOR_MAX_CIC_SHIFT + 3),
+               "wrap-around: %u outputs", (unsigned) DecimatorGetOutputs(&dec, 0));
+}
+
+/**
+ * @brief The interleaved scans: each channel has its own stages and output counter
+ */
+static void testChannels(void) {
+    static DecimatorDef dec;
+    static uint16_t scans[3 * 1024];
+    const DecimatorStagesDef stages[3] = {{0, 0}, {2, 1}, {5, 4}};
+
+    TEST_CHECK(DecimatorInit(&dec, stages, 3, 12) == DECIMATOR_SUCCESS, "channels init");
+    for (size_t i = 0; i < 1024; ++i) {
+        scans[3 * i] = 100;
+        scans[3 * i + 1] = 2048;
+        scans[3 * i + 2] = 4095;
+    }
+    DecimatorProcess(&dec, scans, 1024);
+
+    TEST_CHECK(DecimatorGetOutputs(&dec, 0) == 1024 && DecimatorGetOutputs(&dec, 1) == 128 &&
+               DecimatorGetOutputs(&dec, 2) == 2, "channels: %u, %u, %u outputs",
+               (unsigned) DecimatorGetOutputs(&dec, 0), (unsigned) DecimatorGetOutputs(&dec, 1),
+               (unsigned) DecimatorGetOutputs(&dec, 2));
+    TEST_CHECK(DecimatorGetOutput(&dec, 0) == 100 * 16 && DecimatorGetOutput(&dec, 1) == 2048 * 16,
+               "channels: outputs %d, %d", DecimatorGetOutput(&dec, 0), DecimatorGetOutput(&dec, 1));
+
+    const DecimatorStagesDef wrong = {DECIMATOR_MAX_CIC_SHIFT, DECIMATOR_MAX_HALF_BANDS + 1};
+    TEST_CHECK(DecimatorInit(&dec, &wrong, 1, 12) == DECIMATOR_WRONG_DATA, "init: too many half-band stages");
+}
+
+int main(void) {
+    testRandom();
+    testFullScale();
+    testWrapAround();
+    testChannels();
+    return testResult("test_decimator");
+}
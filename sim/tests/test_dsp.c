@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "Dsp.h"
+#include "host_test.h"
+
+enum DspTest_Constants {
+    TEST_MAX_SIZE = 257, // odd, one more for the unaligned blocks
+    TEST_TRIALS = 500,
+};
+
+static int16_t a[TEST_MAX_SIZE + 1];
+static int16_t b[TEST_MAX_SIZE + 1];
+static int32_t wide[TEST_MAX_SIZE + 1];
+
+/**
+ * @brief Fill the inputs: pseudo-random samples, a part of them is the full scale (the saturation paths)
+ */
+static void fillInputs(void) {
+    for (size_t i = 0; i <= TEST_MAX_SIZE; ++i) {
+        int kind = rand() % 8;
+        a[i] = (kind == 0) ? INT16_MIN : (kind == 1) ? INT16_MAX : (int16_t) (rand() % 65536 - 32768);
+        b[i] = (kind == 2) ? INT16_MIN : (kind == 3) ? INT16_MAX : (int16_t) (rand() % 65536 - 32768);
+        wide[i] = (kind == 4) ? INT32_MAX : (kind == 5) ? INT32_MIN : (int32_t) (((uint32_t) rand() << 16) ^ rand());
+    }
+}
+
+/**
+ * @brief Run every packed kernel and its portable version on the same block, compare the results
+ * @param size is the number of samples
+ * @param offset is 0 - the aligned blocks, 1 - the unaligned ones (the packed loads)
+ * @param trial is the trial number (the report)
+ */
+static void compareKernels(size_t size, size_t offset, int trial) {
+    static int16_t samples[2][TEST_MAX_SIZE];
+    static int32_t words[2][TEST_MAX_SIZE];
+    const int16_t *src = a + offset;
+
+    int64_t dots[2];
+    TEST_CHECK(DspDotQ15(src, b, size, &dots[0]) == DSP_SUCCESS, "dot: size %zu", size);
+    DspDotQ15Reference(src, b, size, &dots[1]);
+    TEST_CHECK(dots[0] == dots[1], "dot: trial %d, size %zu", trial, size);
+
+    int16_t scale = (int16_t) (rand() % 65536 - 32768);
+    uint8_t shift = (uint8_t) (rand() % (DSP_MAX_SHIFT + 1));
+    int16_t offsetValue = (int16_t) (rand() % 65536 - 32768);
+    DspScaleOffsetQ15(src, samples[0], size, scale, shift, offsetValue);
+    DspScaleOffsetQ15Reference(src, samples[1], size, scale, shift, offsetValue);
+    TEST_CHECK(memcmp(samples[0], samples[1], size * sizeof(int16_t)) == 0,
+               "scale_offset: trial %d, size %zu, scale %d, shift %d, offset %d", trial, size, scale, shift,
+               offsetValue);
+
+    DspStatsDef stats[2];
+    DspStatsQ15(src, size, &stats[0]);
+    DspStatsQ15Reference(src, size, &stats[1]);
+    TEST_CHECK(stats[0].min == stats[1].min && stats[0].max == stats[1].max && stats[0].mean == stats[1].mean,
+               "stats: trial %d, size %zu", trial, size);
+
+    int16_t rms[2];
+    DspRmsQ15(src, size, &rms[0]);
+    DspRmsQ15Reference(src, size, &rms[1]);
+    TEST_CHECK(rms[0] == rms[1], "rms: trial %d, size %zu: %d, %d", trial, size, rms[0], rms[1]);
+
+    DspQ15ToQ31(src, words[0], size);
+    DspQ15ToQ31Reference(src, words[1], size);
+    TEST_CHECK(memcmp(words[0], words[1], size * sizeof(int32_t)) == 0, "q15_to_q31: trial %d, size %zu", trial,
+               size);
+
+    DspQ31ToQ15(wide + offset, samples[0], size);
+    DspQ31ToQ15Reference(wide + offset, samples[1], size);
+    TEST_CHECK(memcmp(samples[0], samples[1], size * sizeof(int16_t)) == 0, "q31_to_q15: trial %d, size %zu", trial,
+               size);
+}
+
+/**
+ * @brief The packed kernels equal the portable ones: all sizes 1 ... TEST_MAX_SIZE, then random sizes, aligned and
+ * unaligned blocks
+ */
+static void testEquivalence(void) {
+    srand(1);
+    fillInputs();
+    for (size_t size = 1; size <= TEST_MAX_SIZE; ++size)
+        compareKernels(size, size % 2, 0);
+
+    for (int trial = 1; trial <= TEST_TRIALS; ++trial) {
+        fillInputs();
+        compareKernels(1 + (size_t) rand() % TEST_MAX_SIZE, (size_t) rand() % 2, trial);
+    }
+}
+
+/**
+ * @brief The full scale inputs (INT16_MIN, INT16_MAX): the known results of both kernel versions
+ */
+static void testExtremes(void) {
+    static int16_t minimums[TEST_MAX_SIZE];
+    static int16_t maximums[TEST_MAX_SIZE];
+    static int16_t output[TEST_MAX_SIZE];
+    static int32_t words[TEST_MAX_SIZE];
+    const size_t size = TEST_MAX_SIZE;
+
+    for (size_t i = 0; i < size; ++i) {
+        minimums[i] = INT16_MIN;
+        maximums[i] = INT16_MAX;
+    }
+
+    for (int isReference = 0; isReference < 2; ++isReference) {
+        int64_t dot;
+        (isReference) ? DspDotQ15Reference(minimums, minimums, size, &dot) : DspDotQ15(minimums, minimums, size, &dot);
+        TEST_CHECK(dot == (int64_t) size << 30, "dot: (-1.0)^2 x %zu = %lld (reference %d)", size, (long long) dot,
+                   isReference);
+
+        // -1.0 x -1.0 = 1.0 is saturated, the offset is saturated too
+        (isReference) ? DspScaleOffsetQ15Reference(minimums, output, size, INT16_MIN, 0, INT16_MAX)
+                      : DspScaleOffsetQ15(minimums, output, size, INT16_MIN, 0, INT16_MAX);
+        TEST_CHECK(output[0] == INT16_MAX && output[size - 1] == INT16_MAX, "scale_offset: %d (reference %d)",
+                   output[size - 1], isReference);
+        (isReference) ? DspScaleOffsetQ15Reference(maximums, output, size, INT16_MAX, DSP_MAX_SHIFT, INT16_MIN)
+                      : DspScaleOffsetQ15(maximums, output, size, INT16_MAX, DSP_MAX_SHIFT, INT16_MIN);
+        TEST_CHECK(output[0] == -1 && output[size - 1] == -1, "scale_offset: %d (reference %d)", output[size - 1],
+                   isReference);
+
+        // the mean is truncated toward zero: (-32768 + 32767) / 2 = 0
+        DspStatsDef stats;
+        output[0] = INT16_MIN;
+        output[1] = INT16_MAX;
+        output[2] = 0;
+        (isReference) ? DspStatsQ15Reference(output, 2, &stats) : DspStatsQ15(output, 2, &stats);
+        TEST_CHECK(stats.min == INT16_MIN && stats.max == INT16_MAX && stats.mean == 0,
+                   "stats: %d, %d, %d (reference %d)", stats.min, stats.max, stats.mean, isReference);
+        (isReference) ? DspStatsQ15Reference(minimums, size, &stats) : DspStatsQ15(minimums, size, &stats);
+        TEST_CHECK(stats.min == INT16_MIN && stats.max == INT16_MIN && stats.mean == INT16_MIN,
+                   "stats: the full scale mean %d (reference %d)", stats.mean, isReference);
+
+        // RMS of -1.0 is 1.0, it is clipped
+        int16_t rms;
+        (isReference) ? DspRmsQ15Reference(minimums, size, &rms) : DspRmsQ15(minimums, size, &rms);
+        TEST_CHECK(rms == INT16_MAX, "rms: %d (reference %d)", rms, isReference);
+        (isReference) ? DspRmsQ15Reference(maximums, size, &rms) : DspRmsQ15(maximums, size, &rms);
+        TEST_CHECK(rms == INT16_MAX, "rms: %d (reference %d)", rms, isReference);
+
+        (isReference) ? DspQ15ToQ31Reference(minimums, words, size) : DspQ15ToQ31(minimums, words, size);
+        TEST_CHECK(words[0] == INT32_MIN && words[size - 1] == INT32_MIN, "q15_to_q31: %d (reference %d)",
+                   words[size - 1], isReference);
+
+        // the rounding saturates near 1.0, the half LSB is rounded up
+        const int32_t q31[] = {INT32_MAX, INT32_MIN, 0x8000, -0x8000, 0x7FFF, 0x18000};
+        const int16_t q15[] = {INT16_MAX, INT16_MIN, 1, 0, 0, 2};
+        size_t count = sizeof(q31) / sizeof(q31[0]);
+        (isReference) ? DspQ31ToQ15Reference(q31, output, count) : DspQ31ToQ15(q31, output, count);
+        TEST_CHECK(memcmp(output, q15, sizeof(q15)) == 0, "q31_to_q15: %d, %d, %d, %d, %d, %d (reference %d)",
+                   output[0], output[1], output[2], output[3], output[4], output[5], isReference);
+    }
+}
+
+/**
+ * @brief The wrong arguments are refused by all kernels
+ */
+static void testWrongData(void) {
+    int64_t dot;
+    int16_t rms;
+    DspStatsDef stats;
+
+    TEST_CHECK(DspDotQ15(a, b, 0, &dot) == DSP_WRONG_DATA, "dot: size 0");
+    TEST_CHECK(DspDotQ15(a, NULL, 1, &dot) == DSP_WRONG_DATA, "dot: NULL");
+    TEST_CHECK(DspDotQ15Reference(a, b, DSP_MAX_SIZE + 1, &dot) == DSP_WRONG_DATA, "dot: too large");
+    TEST_CHECK(DspScaleOffsetQ15(a, a, 1, 1, DSP_MAX_SHIFT + 1, 0) == DSP_WRONG_DATA, "scale_offset: shift");
+    TEST_CHECK(DspStatsQ15(NULL, 1, &stats) == DSP_WRONG_DATA, "stats: NULL");
+    TEST_CHECK(DspRmsQ15Reference(a, 0, &rms) == DSP_WRONG_DATA, "rms: size 0");
+    TEST_CHECK(DspQ15ToQ31(a, NULL, 1) == DSP_WRONG_DATA, "q15_to_q31: NULL");
+    TEST_CHECK(DspQ31ToQ15Reference(wide, NULL, 1) == DSP_WRONG_DATA, "q31_to_q15: NULL");
+}
+
+int main(void) {
+    testEquivalence();
+    testExtremes();
+    testWrongData();
+    return testResult("test_dsp");
+}
@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "Filter.h"
+#include "host_test.h"
+
+enum FilterTest_Constants {
+    TEST_BLOCK = 64,
+    TEST_STEPS = 200,
+    TEST_BIQUAD_TOLERANCE = 4, // LSB, the truncation errors are accumulated by the feedback (gain 1 / (1 - 0.5))
+};
+
+/*
+ * The FMAC isn't used by the test (the filters are initialized without the handle)
+ */
+int32_t Filter_configHardware(FilterDef *filter) {
+    (void) filter;
+    return FILTER_HW_ERROR;
+}
+
+int32_t Filter_startHardware(FilterDef *filter, size_t size) {
+    (void) filter;
+    (void) size;
+    return FILTER_HW_ERROR;
+}
+
+void Filter_stopHardware(FilterDef *filter) {
+    (void) filter;
+}
+
+/**
+ * @brief Fill the block with the same value
+ * @param block is the target block
+ * @param size is the number of samples
+ * @param value is the sample value
+ */
+static void fillBlock(int16_t *block, size_t size, int16_t value) {
+    for (size_t i = 0; i < size; ++i)
+        block[i] = value;
+}
+
+/**
+ * @brief FIR, the DC gain 1 (4 x 0.25): the step response rises by a quarter per sample, then it equals the input
+ */
+static void testFirDc(void) {
+    static const int16_t b[] = {0x2000, 0x2000, 0x2000, 0x2000};
+    const FilterConfigDef config = {FILTER_FIR, 4, 0, b, NULL};
+    static const int16_t levels[] = {0x4000, -0x4000, 0x0100};
+    static FilterDef filter;
+    int16_t input[TEST_BLOCK];
+    int16_t output[TEST_BLOCK];
+
+    for (size_t j = 0; j < sizeof(levels) / sizeof(levels[0]); ++j) {
+        TEST_CHECK(FilterInit(&filter, &config, NULL) == FILTER_SUCCESS, "FIR init");
+        fillBlock(input, TEST_BLOCK, levels[j]);
+        FilterSoftware(&filter, input, output, TEST_BLOCK);
+
+        // the products are exact (the coefficient is a power of 2), so are the partial sums
+        for (size_t i = 0; i < 4; ++i) {
+            int16_t expected = (int16_t) (levels[j] / 4 * (int16_t) (i + 1));
+            TEST_CHECK(output[i] == expected, "FIR DC %d: output[%zu] = %d, expected %d", levels[j], i, output[i],
+                       expected);
+        }
+        for (size_t i = 4; i < TEST_BLOCK; ++i) {
+            TEST_CHECK(output[i] == levels[j], "FIR DC %d: output[%zu] = %d", levels[j], i, output[i]);
+        }
+    }
+}
+
+/**
+ * @brief FIR, the state is kept between the blocks: two halves give the same output as one block
+ */
+static void testFirBlocks(void) {
+    static const int16_t b[] = {0x1000, -0x0800, 0x2000, 0x0400, -0x1800};
+    const FilterConfigDef config = {FILTER_FIR, 5, 1, b, NULL};
+    static FilterDef whole;
+    static FilterDef split;
+    int16_t input[TEST_BLOCK];
+    int16_t expected[TEST_BLOCK];
+    int16_t output[TEST_BLOCK];
+
+    srand(1);
+    for (size_t i = 0; i < TEST_BLOCK; ++i)
+        input[i] = (int16_t) (rand() % 65536 - 32768);
+
+    FilterInit(&whole, &config, NULL);
+    FilterInit(&split, &config, NULL);
+    FilterSoftware(&whole, input, expected, TEST_BLOCK);
+    FilterSoftware(&split, input, output, TEST_BLOCK / 2 + 1);
+    FilterSoftware(&split, input + TEST_BLOCK / 2 + 1, output + TEST_BLOCK / 2 + 1, TEST_BLOCK / 2 - 1);
+
+    TEST_CHECK(memcmp(expected, output, sizeof(output)) == 0, "FIR: the split blocks differ from the whole one");
+}
+
+/**
+ * @brief Biquad y[n] = 0.5 * x[n] + 0.5 * y[n - 1] (the DC gain 1) against the double precision model
+ */
+static void testBiquad(void) {
+    static const int16_t b[] = {0x4000, 0, 0};
+    static const int16_t a[] = {0x4000, 0};
+    const FilterConfigDef config = {FILTER_BIQUAD, FILTER_BIQUAD_TAPS, 0, b, a};
+    static FilterDef filter;
+    int16_t input[TEST_STEPS];
+    int16_t output[TEST_STEPS];
+
+    TEST_CHECK(FilterInit(&filter, &config, NULL) == FILTER_SUCCESS, "biquad init");
+    for (size_t i = 0; i < TEST_STEPS; ++i)
+        input[i] = (i < TEST_STEPS / 2) ? 0x4000 : -0x2000;
+    FilterSoftware(&filter, input, output, TEST_STEPS);
+
+    double y = 0;
+    for (size_t i = 0; i < TEST_STEPS; ++i) {
+        y = 0.5 * input[i] + 0.5 * y;
+        double error = output[i] - y;
+        TEST_CHECK(error <= 0 && error > -TEST_BIQUAD_TOLERANCE, "biquad: output[%zu] = %d, model %.2f", i, output[i],
+                   y);
+    }
+
+    // the truncation keeps the steady state 1 LSB below the input
+    TEST_CHECK(output[TEST_STEPS / 2 - 1] == 0x4000 - 1, "biquad: the steady state %d", output[TEST_STEPS / 2 - 1]);
+}
+
+/**
+ * @brief The output is clipped to q1.15, the 26-bit accumulator wraps around (the FMAC behaviour)
+ */
+static void testSaturation(void) {
+    static const int16_t gain2[] = {0x4000, 0x4000};
+    static const int16_t full[9] = {INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX,
+                                    INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX};
+    static FilterDef filter;
+    int16_t input[TEST_BLOCK];
+    int16_t output[TEST_BLOCK];
+
+    // the DC gain 2 (shift 1): 0.75 -> 1.5 is clipped
+    FilterConfigDef config = {FILTER_FIR, 2, 1, gain2, NULL};
+    FilterInit(&filter, &config, NULL);
+    fillBlock(input, TEST_BLOCK, 0x6000);
+    FilterSoftware(&filter, input, output, TEST_BLOCK);
+    TEST_CHECK(output[0] == 0x6000, "saturation: the first output %d", output[0]);
+    TEST_CHECK(output[TEST_BLOCK - 1] == INT16_MAX, "saturation: positive %d", output[TEST_BLOCK - 1]);
+
+    FilterInit(&filter, &config, NULL);
+    fillBlock(input, TEST_BLOCK, -0x6000);
+    FilterSoftware(&filter, input, output, TEST_BLOCK);
+    TEST_CHECK(output[TEST_BLOCK - 1] == INT16_MIN, "saturation: negative %d", output[TEST_BLOCK - 1]);
+
+    // 8 full scale products (~8.0) fit the accumulator, the 9th one wraps it around to the negative range
+    config.taps = 8;
+    config.b = full;
+    config.shift = 0;
+    FilterInit(&filter, &config, NULL);
+    fillBlock(input, TEST_BLOCK, INT16_MAX);
+    FilterSoftware(&filter, input, output, TEST_BLOCK);
+    TEST_CHECK(output[TEST_BLOCK - 1] == INT16_MAX, "saturation: 8 taps %d", output[TEST_BLOCK - 1]);
+
+    config.taps = 9;
+    FilterInit(&filter, &config, NULL);
+    FilterSoftware(&filter, input, output, TEST_BLOCK);
+    TEST_CHECK(output[TEST_BLOCK - 1] == INT16_MIN, "saturation: 9 taps (wrap-around) %d", output[TEST_BLOCK - 1]);
+}
+
+int main(void) {
+    testFirDc();
+    testFirBlocks();
+    testBiquad();
+    testSaturation();
+    return testResult("test_filter");
+}
@@ -0,0 +1,275 @@
+#include <string.h>
+
+#include "stm32g4xx_hal.h"
+
+#include "i2c.h"
+#include "host_test.h"
+
+enum I2CReloadTest_Constants {
+    TEST_ADDRESS = 0x50,
+    TEST_LONG_SIZE = 70000, // two DMA segments (65535 + 4465 bytes), 275 NBYTES chunks
+    TEST_MAX_CHUNKS = TEST_LONG_SIZE / I2C_MAX_NBYTES + 2,
+};
+
+/*
+ * The simulated controller: it takes NBYTES/RELOAD/AUTOEND from CR2, moves the chunk between the bus and the DMA
+ * segment, then raises TCR (RELOAD), STOPF (AUTOEND) or TC and calls the event interrupt (XferISR). The DMA end
+ * calls the completion callback. CR2 of every chunk is recorded.
+ */
+static I2C_TypeDef regs;
+static DMA_HandleTypeDef dmaTx;
+static DMA_HandleTypeDef dmaRx;
+static I2C_HandleTypeDef handle = {.Instance = &regs, .hdmatx = &dmaTx, .hdmarx = &dmaRx};
+static I2CDef i2c = {.handle = &handle, .isInit = true};
+
+static uint8_t source[TEST_LONG_SIZE];
+static uint8_t bus[TEST_LONG_SIZE];
+static size_t busSize;
+
+static uint8_t *dmaMemory; // the host pointer doesn't fit uint32_t, the segment start is taken from the transfer
+static uint32_t dmaLength;
+static uint32_t dmaStarts;
+static uint32_t dmaAborts;
+static uint32_t dmaFailAt; // the DMA start, which fails (0 - none)
+
+static uint32_t chunks[TEST_MAX_CHUNKS];
+static size_t numberChunks;
+static uint32_t txCompleted;
+static uint32_t rxCompleted;
+static uint32_t errorsReported;
+
+I2CDef *I2C_getInterface(const void *handleToFind) {
+    return (handleToFind == &handle) ? &i2c : NULL;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                   uint32_t DataLength) {
+    (void) hdma;
+    (void) SrcAddress;
+    (void) DstAddress;
+    if (++dmaStarts == dmaFailAt)
+        return HAL_ERROR;
+
+    dmaMemory = i2c.reload.data;
+    dmaLength = DataLength;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    (void) hdma;
+    dmaAborts++;
+    dmaLength = 0;
+    return HAL_OK;
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    (void) hi2c;
+    txCompleted++;
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    (void) hi2c;
+    rxCompleted++;
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    (void) hi2c;
+    errorsReported++;
+}
+
+/**
+ * @brief Raise the event interrupt
+ * @param flags is the ISR value
+ */
+static void event(uint32_t flags) {
+    regs.ISR = flags;
+    if (handle.XferISR)
+        handle.XferISR(&handle, flags, regs.CR1);
+}
+
+/**
+ * @brief Move one byte between the bus and the DMA segment, the segment end calls the DMA completion
+ * @param isRead is True - the target sends the byte, False - the controller sends it
+ */
+static void moveByte(bool isRead) {
+    DMA_HandleTypeDef *hdma = (isRead) ? &dmaRx : &dmaTx;
+
+    if (dmaLength == 0)
+        return;
+
+    if (isRead)
+        *dmaMemory++ = (uint8_t) (busSize * 7 + 3);
+    else
+        bus[busSize] = *dmaMemory++;
+    busSize++;
+
+    if (--dmaLength == 0 && hdma->XferCpltCallback)
+        hdma->XferCpltCallback(hdma);
+}
+
+/**
+ * @brief Run the started transfer to its end: chunk by chunk, as the controller does
+ */
+static void runController(void) {
+    bool isRead = (regs.CR2 & I2C_CR2_RD_WRN) != 0;
+
+    while (handle.XferISR && numberChunks < TEST_MAX_CHUNKS) {
+        uint32_t cr2 = regs.CR2;
+        chunks[numberChunks++] = cr2;
+        regs.CR2 &= ~I2C_CR2_START;
+
+        size_t nbytes = (cr2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+        for (size_t i = 0; i < nbytes && (regs.CR2 & I2C_CR2_STOP) == 0; ++i)
+            moveByte(isRead);
+
+        if ((cr2 & I2C_CR2_AUTOEND) || (regs.CR2 & I2C_CR2_STOP))
+            event(I2C_ISR_STOPF);
+        else if (cr2 & I2C_CR2_RELOAD)
+            event(I2C_ISR_TCR);
+        else
+            event(I2C_ISR_TC);
+    }
+}
+
+/**
+ * @brief Reset the controller and the callbacks
+ */
+static void reset(void) {
+    memset(&regs, 0, sizeof(regs));
+    handle.State = HAL_I2C_STATE_READY;
+    handle.XferISR = NULL;
+    dmaTx.Parent = dmaRx.Parent = &handle;
+    busSize = 0;
+    dmaLength = dmaStarts = dmaAborts = dmaFailAt = 0;
+    numberChunks = 0;
+    txCompleted = rxCompleted = errorsReported = 0;
+    i2c.reload.reloads = 0;
+}
+
+/**
+ * @brief Check CR2 of every chunk: the address and Start in the first one, 255 bytes with RELOAD in all but the last
+ * one, the rest with AUTOEND (if Stop is needed) in the last one
+ * @param size is the transfer size (bytes)
+ * @param isRead is True - read, False - write
+ * @param isNeedStop is True - Stop after the data, False - the bus is held
+ */
+static void checkChunks(size_t size, bool isRead, bool isNeedStop) {
+    size_t expected = (size + I2C_MAX_NBYTES - 1) / I2C_MAX_NBYTES;
+
+    TEST_CHECK(numberChunks == expected && i2c.reload.reloads == expected - 1, "size %zu: %zu chunks, %u reloads",
+               size, numberChunks, (unsigned) i2c.reload.reloads);
+    TEST_CHECK(((chunks[0] & I2C_CR2_SADD) >> 1) == TEST_ADDRESS && (chunks[0] & I2C_CR2_START) &&
+               ((chunks[0] & I2C_CR2_RD_WRN) != 0) == isRead, "size %zu: first CR2 %08x", size, (unsigned) chunks[0]);
+
+    for (size_t i = 0; i < numberChunks; ++i) {
+        bool isLast = (i + 1 == numberChunks);
+        uint32_t nbytes = (chunks[i] & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+        uint32_t expectedBytes = (isLast) ? (uint32_t) (size - i * I2C_MAX_NBYTES) : I2C_MAX_NBYTES;
+        bool isReload = (chunks[i] & I2C_CR2_RELOAD) != 0;
+        bool isAutoEnd = (chunks[i] & I2C_CR2_AUTOEND) != 0;
+
+        TEST_CHECK(nbytes == expectedBytes && isReload == !isLast && isAutoEnd == (isLast && isNeedStop),
+                   "size %zu, chunk %zu: CR2 %08x", size, i, (unsigned) chunks[i]);
+        if (nbytes != expectedBytes || isReload == isLast)
+            break;
+    }
+
+    TEST_CHECK(busSize == size && handle.State == HAL_I2C_STATE_READY && handle.XferISR == NULL,
+               "size %zu: %zu bytes on the bus, state %u", size, busSize, (unsigned) handle.State);
+    TEST_CHECK((regs.CR1 & (I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_TXDMAEN | I2C_CR1_RXDMAEN)) == 0,
+               "size %zu: CR1 %08x after the end", size, (unsigned) regs.CR1);
+}
+
+/**
+ * @brief The writes longer than NBYTES: one Start, the data is the same on the bus
+ */
+static void testWrite(void) {
+    static const size_t sizes[] = {256, 2 * I2C_MAX_NBYTES, 600, TEST_LONG_SIZE};
+
+    for (size_t i = 0; i < sizeof(source); ++i)
+        source[i] = (uint8_t) (i ^ (i >> 8));
+
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k) {
+        reset();
+        TEST_CHECK(I2C_startReload(&i2c, TEST_ADDRESS, source, sizes[k], false, true) == I2C_SUCCESS,
+                   "write %zu: start", sizes[k]);
+        runController();
+        checkChunks(sizes[k], false, true);
+        TEST_CHECK(memcmp(bus, source, sizes[k]) == 0, "write %zu: the bus data differs", sizes[k]);
+        TEST_CHECK(txCompleted == 1 && errorsReported == 0 && dmaStarts == (sizes[k] + I2C_MAX_DMA_SIZE - 1) /
+                   I2C_MAX_DMA_SIZE, "write %zu: %u completions, %u DMA segments", sizes[k], (unsigned) txCompleted,
+                   (unsigned) dmaStarts);
+    }
+}
+
+/**
+ * @brief The write phase of the write-then-read transaction: no Stop, TC ends it, the bus is held
+ */
+static void testWriteWithoutStop(void) {
+    reset();
+    TEST_CHECK(I2C_startReload(&i2c, TEST_ADDRESS, source, 300, false, false) == I2C_SUCCESS, "write phase: start");
+    runController();
+    checkChunks(300, false, false);
+    TEST_CHECK(txCompleted == 1 && handle.PreviousState != HAL_I2C_MODE_NONE,
+               "write phase: %u completions, previous state %u", (unsigned) txCompleted,
+               (unsigned) handle.PreviousState);
+}
+
+/**
+ * @brief The read longer than the DMA segment (CNDTR): the second segment continues the same transfer
+ */
+static void testLongRead(void) {
+    static uint8_t data[TEST_LONG_SIZE];
+
+    reset();
+    memset(data, 0, sizeof(data));
+    TEST_CHECK(I2C_startReload(&i2c, TEST_ADDRESS, data, sizeof(data), true, false) == I2C_SUCCESS, "read: start");
+    runController();
+    checkChunks(sizeof(data), true, true);
+    TEST_CHECK(rxCompleted == 1 && dmaStarts == 2, "read: %u completions, %u DMA segments", (unsigned) rxCompleted,
+               (unsigned) dmaStarts);
+
+    size_t wrong = 0;
+    while (wrong < sizeof(data) && data[wrong] == (uint8_t) (wrong * 7 + 3))
+        wrong++;
+    TEST_CHECK(wrong == sizeof(data), "read: byte %zu differs", wrong);
+}
+
+/**
+ * @brief NACK ends the transfer by Stop, the failed DMA start of the next segment - by the Stop request
+ */
+static void testErrors(void) {
+    reset();
+    I2C_startReload(&i2c, TEST_ADDRESS, source, 600, false, true);
+    event(I2C_ISR_NACKF | I2C_ISR_STOPF);
+    TEST_CHECK(errorsReported == 1 && txCompleted == 0 && dmaAborts == 1 && (handle.ErrorCode & HAL_I2C_ERROR_AF) &&
+               handle.State == HAL_I2C_STATE_READY, "NACK: %u errors, %u aborts, error code %08x",
+               (unsigned) errorsReported, (unsigned) dmaAborts, (unsigned) handle.ErrorCode);
+
+    reset();
+    dmaFailAt = 2;
+    I2C_startReload(&i2c, TEST_ADDRESS, source, TEST_LONG_SIZE, false, true);
+    runController();
+    TEST_CHECK(errorsReported == 1 && txCompleted == 0 && (handle.ErrorCode & HAL_I2C_ERROR_DMA) &&
+               busSize == I2C_MAX_DMA_SIZE && handle.XferISR == NULL, "DMA error: %u errors, %zu bytes",
+               (unsigned) errorsReported, busSize);
+
+    reset();
+    dmaFailAt = 1;
+    TEST_CHECK(I2C_startReload(&i2c, TEST_ADDRESS, source, 600, false, true) == I2C_HW_ERROR &&
+               handle.State == HAL_I2C_STATE_READY && handle.XferISR == NULL, "DMA start error");
+
+    reset();
+    handle.State = HAL_I2C_STATE_BUSY_TX;
+    TEST_CHECK(I2C_startReload(&i2c, TEST_ADDRESS, source, 600, false, true) == I2C_HW_ERROR, "busy");
+    TEST_CHECK(I2C_startReload(&i2c, TEST_ADDRESS, NULL, 600, false, true) == I2C_WRONG_DATA, "NULL");
+    TEST_CHECK(I2C_startReload(&i2c, TEST_ADDRESS, source, 0, false, true) == I2C_WRONG_DATA, "size 0");
+}
+
+int main(void) {
+    testWrite();
+    testWriteWithoutStop();
+    testLongRead();
+    testErrors();
+    return testResult("test_i2c_reload");
+}
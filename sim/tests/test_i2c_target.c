@@ -0,0 +1,306 @@
+#include <string.h>
+
+#include "stm32g4xx_hal.h"
+
+#include "I2CTarget.h"
+#include "host_test.h"
+
+enum I2CTargetTest_Constants {
+    TEST_FIRST_WRITABLE = 4,
+    TEST_LAST_WRITABLE = 7,
+};
+
+/*
+ * The simulated peripheral: the test writes ISR/RXDR (the bus events), the target writes ICR/CR1/CR2,
+ * the TX DMA is recorded, the controller reads the DMA source
+ */
+static I2C_TypeDef regs;
+static DMA_HandleTypeDef dmaTx;
+static I2C_HandleTypeDef handle = {.Instance = &regs, .hdmatx = &dmaTx};
+static I2CDef i2c = {.handle = &handle, .isInit = true};
+static I2CTargetDef target;
+static uint8_t writable[I2C_TARGET_MAP_SIZE];
+
+static const uint8_t *dmaSource;
+static uint32_t dmaLength;
+static HAL_StatusTypeDef dmaStatus = HAL_OK;
+static uint32_t dmaAborts;
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                uint32_t DataLength) {
+    (void) hdma;
+    (void) DstAddress;
+    if (dmaStatus != HAL_OK)
+        return dmaStatus;
+
+    // the host pointer doesn't fit uint32_t, the snapshot is the only DMA source of the target
+    (void) SrcAddress;
+    dmaSource = target.snapshot;
+    dmaLength = DataLength;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    (void) hdma;
+    dmaAborts++;
+    dmaSource = NULL;
+    return HAL_OK;
+}
+
+/**
+ * @brief Raise the event interrupt
+ * @param flags is the ISR value
+ */
+static void event(uint32_t flags) {
+    regs.ISR = flags;
+    I2CTargetEventFromISR(&target);
+}
+
+/**
+ * @brief The controller addresses the target
+ * @param isRead is True - read, False - write
+ */
+static void addressMatch(bool isRead) {
+    event(I2C_ISR_ADDR | ((isRead) ? I2C_ISR_DIR : 0));
+}
+
+/**
+ * @brief The controller writes the bytes
+ * @param data is the bytes
+ * @param size is the number of bytes
+ */
+static void writeBytes(const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        regs.RXDR = data[i];
+        event(I2C_ISR_RXNE);
+    }
+}
+
+/**
+ * @brief The controller reads the bytes (the circular DMA), then NACKs the last one
+ * @param data is the read bytes
+ * @param size is the number of bytes
+ */
+static void readBytes(uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; ++i)
+        data[i] = (dmaSource && dmaLength) ? dmaSource[i % dmaLength] : 0xFF;
+    event(I2C_ISR_NACKF);
+}
+
+/**
+ * @brief Initialize the target: the registers 0 ... 31 hold their numbers, 4 ... 7 are writable
+ * @param isWritable is True - the writable registers, False - read only map
+ */
+static void initTarget(bool isWritable) {
+    uint8_t values[I2C_TARGET_MAP_SIZE];
+
+    memset(&regs, 0, sizeof(regs));
+    regs.CR2 = I2C_CR2_NACK;
+    memset(writable, 0, sizeof(writable));
+    memset(&writable[TEST_FIRST_WRITABLE], 1, TEST_LAST_WRITABLE - TEST_FIRST_WRITABLE + 1);
+    dmaSource = NULL;
+    dmaStatus = HAL_OK;
+    dmaAborts = 0;
+
+    for (size_t i = 0; i < I2C_TARGET_MAP_SIZE; ++i)
+        values[i] = (uint8_t) i;
+    TEST_CHECK(I2CTargetInit(&target, &i2c, (isWritable) ? writable : NULL) == I2C_SUCCESS, "init");
+    TEST_CHECK(I2CTargetUpdate(&target, 0, values, sizeof(values)) == I2C_SUCCESS, "update");
+}
+
+/**
+ * @brief Write the registers, then set the pointer and read them back with the repeated Start
+ */
+static void testWriteRead(void) {
+    const uint8_t write[] = {TEST_FIRST_WRITABLE, 0xA0, 0xA1};
+    const uint8_t expected[] = {2, 3, 0xA0, 0xA1, 6, 7};
+    uint8_t data[sizeof(expected)];
+
+    initTarget(true);
+    TEST_CHECK((regs.CR2 & I2C_CR2_NACK) == 0, "init: NACK isn't cleared");
+    TEST_CHECK((regs.CR1 & (I2C_CR1_ADDRIE | I2C_CR1_RXIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | I2C_CR1_ERRIE)) ==
+               (I2C_CR1_ADDRIE | I2C_CR1_RXIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | I2C_CR1_ERRIE),
+               "init: interrupts %08x", (unsigned) regs.CR1);
+
+    addressMatch(false);
+    TEST_CHECK(target.state == I2C_TARGET_RX && regs.ICR == I2C_ICR_ADDRCF, "write: state %d", target.state);
+    writeBytes(write, sizeof(write));
+    event(I2C_ISR_STOPF);
+    TEST_CHECK(target.state == I2C_TARGET_IDLE && target.writes == 1, "write: state %d, writes %u", target.state,
+               (unsigned) target.writes);
+
+    uint8_t regs4[2];
+    I2CTargetGetRegisters(&target, TEST_FIRST_WRITABLE, regs4, sizeof(regs4));
+    TEST_CHECK(regs4[0] == 0xA0 && regs4[1] == 0xA1, "write: registers %02x %02x", regs4[0], regs4[1]);
+
+    // the register pointer, the repeated Start, the read
+    const uint8_t pointer = 2;
+    addressMatch(false);
+    writeBytes(&pointer, 1);
+    addressMatch(true);
+    TEST_CHECK(target.state == I2C_TARGET_TX && target.pointer == pointer && (regs.CR1 & I2C_CR1_TXDMAEN),
+               "read: state %d, pointer %d", target.state, target.pointer);
+    TEST_CHECK(dmaLength == I2C_TARGET_MAP_SIZE, "read: DMA length %u", (unsigned) dmaLength);
+
+    // the task changes the map during the read: the snapshot is sent
+    const uint8_t changed = 0x55;
+    I2CTargetUpdate(&target, 3, &changed, 1);
+    readBytes(data, sizeof(data));
+    event(I2C_ISR_STOPF);
+    TEST_CHECK(memcmp(data, expected, sizeof(expected)) == 0, "read: %02x %02x %02x %02x %02x %02x", data[0], data[1],
+               data[2], data[3], data[4], data[5]);
+    TEST_CHECK(target.state == I2C_TARGET_IDLE && (regs.CR1 & I2C_CR1_TXDMAEN) == 0 && dmaAborts == 1,
+               "read end: state %d, DMA aborts %u", target.state, (unsigned) dmaAborts);
+    TEST_CHECK(target.reads == 1 && target.writes == 1 && target.errors == 0,
+               "counters: %u reads, %u writes, %u errors", (unsigned) target.reads, (unsigned) target.writes,
+               (unsigned) target.errors);
+
+    // the next read starts at the same pointer and sees the change, it wraps around the map
+    const uint8_t last = I2C_TARGET_MAP_SIZE - 2;
+    addressMatch(true);
+    readBytes(data, 2);
+    event(I2C_ISR_STOPF);
+    TEST_CHECK(data[0] == pointer && data[1] == changed, "read again: %02x %02x", data[0], data[1]);
+
+    addressMatch(false);
+    writeBytes(&last, 1);
+    event(I2C_ISR_STOPF);
+    addressMatch(true);
+    readBytes(data, 4);
+    event(I2C_ISR_STOPF);
+    TEST_CHECK(data[0] == last && data[1] == last + 1 && data[2] == 0 && data[3] == 1,
+               "wrap-around: %02x %02x %02x %02x", data[0], data[1], data[2], data[3]);
+}
+
+/**
+ * @brief The register pointer beyond the map: the write is dropped, the pointer isn't changed
+ */
+static void testPointerOutOfRange(void) {
+    const uint8_t pointer = 5;
+    const uint8_t write[] = {I2C_TARGET_MAP_SIZE, 0xEE, 0xEE};
+    uint8_t data[2];
+
+    initTarget(true);
+    addressMatch(false);
+    writeBytes(&pointer, 1);
+    event(I2C_ISR_STOPF);
+
+    addressMatch(false);
+    writeBytes(write, sizeof(write));
+    event(I2C_ISR_STOPF);
+    TEST_CHECK(target.errors == 1 && target.writes == 0 && target.pointer == pointer,
+               "out of range: %u errors, %u writes, pointer %d", (unsigned) target.errors, (unsigned) target.writes,
+               target.pointer);
+
+    addressMatch(true);
+    readBytes(data, sizeof(data));
+    event(I2C_ISR_STOPF);
+    TEST_CHECK(data[0] == 5 && data[1] == 6, "out of range: the map is changed %02x %02x", data[0], data[1]);
+}
+
+/**
+ * @brief The read only registers are skipped, the writable ones around them are written
+ */
+static void testReadOnly(void) {
+    const uint8_t write[] = {TEST_FIRST_WRITABLE - 1, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8};
+    const uint8_t expected[] = {3, 0xB4, 0xB5, 0xB6, 0xB7, 8};
+    uint8_t data[sizeof(expected)];
+
+    initTarget(true);
+    addressMatch(false);
+    writeBytes(write, sizeof(write));
+    event(I2C_ISR_STOPF);
+    I2CTargetGetRegisters(&target, TEST_FIRST_WRITABLE - 1, data, sizeof(data));
+    TEST_CHECK(memcmp(data, expected, sizeof(expected)) == 0, "read only: %02x %02x %02x %02x %02x %02x", data[0],
+               data[1], data[2], data[3], data[4], data[5]);
+
+    // the read only map: only the pointer is changed
+    initTarget(false);
+    addressMatch(false);
+    writeBytes(write, sizeof(write));
+    event(I2C_ISR_STOPF);
+    I2CTargetGetRegisters(&target, TEST_FIRST_WRITABLE - 1, data, sizeof(data));
+    TEST_CHECK(data[1] == TEST_FIRST_WRITABLE && target.pointer == TEST_FIRST_WRITABLE - 1,
+               "read only map: register %02x, pointer %d", data[1], target.pointer);
+}
+
+/**
+ * @brief The write longer than the map is NACKed, the data past the map isn't stored
+ */
+static void testOverflow(void) {
+    uint8_t write[I2C_TARGET_RX_SIZE + 2];
+    uint8_t data[TEST_LAST_WRITABLE - TEST_FIRST_WRITABLE + 1];
+
+    initTarget(true);
+    write[0] = 0;
+    for (size_t i = 1; i < sizeof(write); ++i)
+        write[i] = (uint8_t) (0xC0 + i);
+
+    addressMatch(false);
+    writeBytes(write, I2C_TARGET_RX_SIZE - 1);
+    TEST_CHECK((regs.CR2 & I2C_CR2_NACK) == 0, "overflow: NACK before the last register");
+    writeBytes(&write[I2C_TARGET_RX_SIZE - 1], sizeof(write) - I2C_TARGET_RX_SIZE + 1);
+    TEST_CHECK(regs.CR2 & I2C_CR2_NACK, "overflow: no NACK");
+    TEST_CHECK(target.rxSize == I2C_TARGET_RX_SIZE, "overflow: %d bytes", target.rxSize);
+    event(I2C_ISR_STOPF);
+
+    I2CTargetGetRegisters(&target, TEST_FIRST_WRITABLE, data, sizeof(data));
+    TEST_CHECK(data[0] == 0xC5 && data[3] == 0xC8, "overflow: registers %02x ... %02x", data[0], data[3]);
+}
+
+/**
+ * @brief The bus error drops the write, the DMA failure drops the read
+ */
+static void testErrors(void) {
+    const uint8_t write[] = {TEST_FIRST_WRITABLE, 0xD0};
+    uint8_t value;
+
+    initTarget(true);
+    addressMatch(false);
+    writeBytes(write, sizeof(write));
+    regs.ISR = I2C_ISR_BERR;
+    I2CTargetErrorFromISR(&target);
+    TEST_CHECK(target.errors == 1 && target.state == I2C_TARGET_IDLE && (regs.ICR & I2C_ICR_BERRCF),
+               "bus error: %u errors, state %d", (unsigned) target.errors, target.state);
+    event(I2C_ISR_STOPF);
+    I2CTargetGetRegisters(&target, TEST_FIRST_WRITABLE, &value, 1);
+    TEST_CHECK(value == TEST_FIRST_WRITABLE && target.writes == 0, "bus error: the register is written %02x", value);
+
+    // no error flags: nothing is changed
+    regs.ISR = I2C_ISR_TXE;
+    I2CTargetErrorFromISR(&target);
+    TEST_CHECK(target.errors == 1, "no error: %u errors", (unsigned) target.errors);
+
+    dmaStatus = HAL_ERROR;
+    addressMatch(true);
+    TEST_CHECK(target.errors == 2 && target.reads == 0 && target.state == I2C_TARGET_IDLE &&
+               (regs.CR1 & I2C_CR1_TXDMAEN) == 0, "DMA error: %u errors, state %d", (unsigned) target.errors,
+               target.state);
+}
+
+/**
+ * @brief The wrong arguments are refused
+ */
+static void testWrongData(void) {
+    static I2C_HandleTypeDef noDma = {.Instance = &regs};
+    static I2CDef notInit = {.handle = &handle};
+    static I2CDef withoutDma = {.handle = &noDma, .isInit = true};
+    static I2CTargetDef other;
+    uint8_t data[2] = {0};
+
+    TEST_CHECK(I2CTargetInit(NULL, &i2c, NULL) == I2C_WRONG_DATA, "init: NULL");
+    TEST_CHECK(I2CTargetInit(&other, &notInit, NULL) == I2C_NOT_INIT, "init: not initialized");
+    TEST_CHECK(I2CTargetInit(&other, &withoutDma, NULL) == I2C_NOT_INIT, "init: no DMA");
+    TEST_CHECK(I2CTargetUpdate(&target, I2C_TARGET_MAP_SIZE - 1, data, 2) == I2C_WRONG_DATA, "update: beyond map");
+    TEST_CHECK(I2CTargetGetRegisters(&target, 0, NULL, 1) == I2C_WRONG_DATA, "get: NULL");
+}
+
+int main(void) {
+    testWriteRead();
+    testPointerOutOfRange();
+    testReadOnly();
+    testOverflow();
+    testErrors();
+    testWrongData();
+    return testResult("test_i2c_target");
+}
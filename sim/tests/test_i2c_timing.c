@@ -0,0 +1,223 @@
+#include "stm32g4xx_hal.h"
+
+#include "i2c.h"
+#include "host_test.h"
+
+enum I2CTimingTest_Constants {
+    TEST_HSI_HZ = 16000000,
+    TEST_SYSCLK_HZ = 144000000,
+    TEST_ANALOG_FILTER_MIN_NS = 50, // tAF, the datasheet
+    TEST_ANALOG_FILTER_MAX_NS = 260,
+    TEST_MIN_RATE_PERCENT = 80,
+};
+
+// UM10204 (rev. 7), table 10: the characteristics of the SDA and SCL bus lines (ns)
+typedef struct {
+    const char *name;
+    uint32_t speedHz;
+    int32_t lowMin; // tLOW
+    int32_t highMin; // tHIGH
+    int32_t setupMin; // tSU;DAT
+    int32_t holdMin; // tHD;DAT
+    int32_t validMax; // tVD;DAT
+    int32_t riseMax; // tr
+    int32_t fallMax; // tf
+} BusModeDef;
+
+static const BusModeDef modes[] = {
+    {"Sm", 100000, 4700, 4000, 250, 0, 3450, 1000, 300},
+    {"Fm", 400000, 1300, 600, 100, 0, 900, 300, 300},
+    {"Fm+", 1000000, 500, 260, 50, 0, 450, 120, 120},
+};
+
+/*
+ * The HAL isn't used by the test (I2C_computeTiming doesn't touch the interface), the other functions of i2c.c are
+ * linked with these stubs
+ */
+SimPeripheralsDef SimPeripherals;
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    (void) hdma;
+    return HAL_ERROR;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+    (void) GPIOx;
+    (void) GPIO_Init;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    (void) GPIOx;
+    (void) GPIO_Pin;
+    return GPIO_PIN_SET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    (void) GPIOx;
+    (void) GPIO_Pin;
+    (void) PinState;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+    (void) hi2c;
+    return HAL_ERROR;
+}
+
+uint32_t HAL_I2C_GetError(const I2C_HandleTypeDef *hi2c) {
+    (void) hi2c;
+    return HAL_I2C_ERROR_NONE;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                  uint16_t Size, uint32_t XferOptions) {
+    (void) hi2c;
+    (void) DevAddress;
+    (void) pData;
+    (void) Size;
+    (void) XferOptions;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                 uint16_t Size, uint32_t XferOptions) {
+    (void) hi2c;
+    (void) DevAddress;
+    (void) pData;
+    (void) Size;
+    (void) XferOptions;
+    return HAL_ERROR;
+}
+
+int32_t I2C_startReload(I2CDef *i2c, uint16_t addr, void *data, size_t size, bool isRead, bool isNeedStop) {
+    (void) i2c;
+    (void) addr;
+    (void) data;
+    (void) size;
+    (void) isRead;
+    (void) isNeedStop;
+    return I2C_HW_ERROR;
+}
+
+/**
+ * @brief Get the data hold window (RM0440, "I2C timings"):
+ * tf - tHD;DAT(min) - tAF(min) - (DNF + 3) * tI2CCLK <= tSDADEL <= tVD;DAT(max) - tr - tAF(max) - (DNF + 4) * tI2CCLK
+ * @param mode is the bus mode
+ * @param clockHz is the I2C kernel clock
+ * @param config is the bus parameters
+ * @param holdMin is the lower limit (ns)
+ * @param holdMax is the upper limit (ns)
+ */
+static void getHoldWindow(const BusModeDef *mode, uint32_t clockHz, const I2CTimingDef *config, double *holdMin,
+                          double *holdMax) {
+    const double clock = 1e9 / clockHz;
+    const double filterMin = (config->isAnalogFilter) ? TEST_ANALOG_FILTER_MIN_NS : 0;
+    const double filterMax = (config->isAnalogFilter) ? TEST_ANALOG_FILTER_MAX_NS : 0;
+    const double dnf = config->digitalFilter;
+
+    *holdMin = config->fallTimeNs - mode->holdMin - filterMin - (dnf + 3) * clock;
+    *holdMax = mode->validMax - config->riseTimeNs - filterMax - (dnf + 4) * clock;
+}
+
+/**
+ * @brief Check the TIMINGR value against the bus mode limits (RM0440, "I2C timings")
+ * @param mode is the bus mode
+ * @param clockHz is the I2C kernel clock
+ * @param config is the bus parameters
+ * @param timing is the TIMINGR value
+ */
+static void checkTiming(const BusModeDef *mode, uint32_t clockHz, const I2CTimingDef *config, uint32_t timing) {
+    const double clock = 1e9 / clockHz;
+    const double presc = (double) ((timing >> 28) + 1) * clock;
+    const uint32_t scldel = (timing >> 20) & 0xF;
+    const uint32_t sdadel = (timing >> 16) & 0xF;
+    const uint32_t sclh = (timing >> 8) & 0xFF;
+    const uint32_t scll = timing & 0xFF;
+    const double filterMin = (config->isAnalogFilter) ? TEST_ANALOG_FILTER_MIN_NS : 0;
+    const double dnf = config->digitalFilter;
+    const double rise = config->riseTimeNs;
+    const double fall = config->fallTimeNs;
+
+    // the data setup time: tSCLDEL >= tr + tSU;DAT(min)
+    double setup = (scldel + 1) * presc;
+    TEST_CHECK(setup >= rise + mode->setupMin, "%s at %u Hz: tSCLDEL %.1f ns", mode->name, (unsigned) clockHz, setup);
+
+    // the data hold time, tSDADEL includes one I2CCLK period
+    double hold = sdadel * presc + clock;
+    double holdMin, holdMax;
+    getHoldWindow(mode, clockHz, config, &holdMin, &holdMax);
+    TEST_CHECK(hold >= holdMin && hold <= holdMax, "%s at %u Hz: tSDADEL %.1f ns (%.1f ... %.1f)", mode->name,
+               (unsigned) clockHz, hold, holdMin, holdMax);
+
+    // the SCL low and high periods include the synchronization delay: tAF(min) + (DNF + 2) * tI2CCLK at least
+    double sync = filterMin + (dnf + 2) * clock;
+    double low = (scll + 1) * presc + sync;
+    double high = (sclh + 1) * presc + sync;
+    TEST_CHECK(low >= mode->lowMin, "%s at %u Hz: tLOW %.1f ns", mode->name, (unsigned) clockHz, low);
+    TEST_CHECK(high >= mode->highMin, "%s at %u Hz: tHIGH %.1f ns", mode->name, (unsigned) clockHz, high);
+
+    // the SCL frequency: not above the mode, not much below it
+    double frequency = 1e9 / (low + high + rise + fall);
+    TEST_CHECK(frequency <= mode->speedHz * 1.0001 && frequency >= mode->speedHz * TEST_MIN_RATE_PERCENT / 100.0,
+               "%s at %u Hz: SCL %.0f Hz", mode->name, (unsigned) clockHz, frequency);
+}
+
+/**
+ * @brief All bus modes at HSI and SYSCLK: the typical board (the settings.c values), the worst-case rise/fall and the
+ * digital filter. Without the data hold window (Fm+ at HSI: tVD;DAT is shorter than the filter and the
+ * synchronization delays) the settings must be refused.
+ */
+static void testModes(void) {
+    static const uint32_t clocks[] = {TEST_HSI_HZ, TEST_SYSCLK_HZ};
+    int checked = 0;
+
+    for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); ++c) {
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+            const BusModeDef *mode = &modes[m];
+            const I2CTimingDef configs[] = {
+                {mode->speedHz, 100, 10, true, 0},
+                {mode->speedHz, (uint16_t) mode->riseMax, (uint16_t) mode->fallMax, true, 0},
+                {mode->speedHz, 100, 10, false, 2},
+            };
+
+            for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); ++i) {
+                double holdMin, holdMax;
+                getHoldWindow(mode, clocks[c], &configs[i], &holdMin, &holdMax);
+                bool isFeasible = holdMax >= holdMin && holdMax >= 1e9 / clocks[c];
+
+                uint32_t timing = 0;
+                int32_t status = I2C_computeTiming(clocks[c], &configs[i], &timing);
+                TEST_CHECK(status == ((isFeasible) ? I2C_SUCCESS : I2C_WRONG_DATA), "%s at %u Hz, config %zu: %d",
+                           mode->name, (unsigned) clocks[c], i, (int) status);
+                if (status == I2C_SUCCESS) {
+                    checkTiming(mode, clocks[c], &configs[i], timing);
+                    checked++;
+                }
+            }
+        }
+    }
+
+    // Sm and Fm at both clocks, Fm+ at SYSCLK (the typical board and the digital filter)
+    TEST_CHECK(checked == 14, "%d settings checked", checked);
+}
+
+/**
+ * @brief The impossible settings are refused
+ */
+static void testWrongData(void) {
+    uint32_t timing = 0;
+    const I2CTimingDef tooFast = {I2C_FAST_MODE_PLUS_HZ + 1, 100, 10, true, 0};
+    const I2CTimingDef slowEdges = {I2C_FAST_MODE_HZ, 1000, 10, true, 0}; // tr > 300 ns
+    const I2CTimingDef filter = {I2C_FAST_MODE_HZ, 100, 10, true, 16};
+    const I2CTimingDef standard = {I2C_STANDARD_MODE_HZ, 100, 10, true, 0};
+
+    TEST_CHECK(I2C_computeTiming(TEST_HSI_HZ, &tooFast, &timing) == I2C_WRONG_DATA, "above Fm+");
+    TEST_CHECK(I2C_computeTiming(TEST_HSI_HZ, &slowEdges, &timing) == I2C_WRONG_DATA, "Fm rise time");
+    TEST_CHECK(I2C_computeTiming(TEST_HSI_HZ, &filter, &timing) == I2C_WRONG_DATA, "digital filter");
+    TEST_CHECK(I2C_computeTiming(0, &standard, &timing) == I2C_WRONG_DATA, "no clock");
+}
+
+int main(void) {
+    testModes();
+    testWrongData();
+    return testResult("test_i2c_timing");
+}
@@ -0,0 +1,187 @@
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "LoggerJob.h"
+#include "host_test.h"
+
+enum LoggerTest_Constants {
+    TEST_WRITERS = 4,
+    TEST_RECORDS = 10000, // per writer
+    TEST_WRAPS = 3 * LOGGER_BUFFER_SIZE,
+};
+
+/*
+ * The Logger task is replaced by drain(): it takes the published bytes as the task does (up to head, the contiguous
+ * regions) and parses the records. The writers run as host threads, the buffer is shared without any lock.
+ */
+static LoggerDef logger;
+static uint32_t nextValue[TEST_WRITERS];
+static uint32_t received;
+static uint32_t broken;
+static uint32_t finished; // the writers, which have saved all records
+
+int32_t SerialWriteData(SerialPortDef *serialPort, const void *src, size_t size) {
+    (void) serialPort;
+    (void) src;
+    return (int32_t) size;
+}
+
+/**
+ * @brief Reset the Logger buffer and the parser state
+ */
+static void resetLogger(void) {
+    memset(&logger, 0, sizeof(logger));
+    memset(nextValue, 0, sizeof(nextValue));
+    received = broken = 0;
+}
+
+/**
+ * @brief Take the published records: the writer ID is the format string ID, its sequence number - the argument
+ * (the records of every writer must come complete and in order)
+ */
+static void drain(void) {
+    uint8_t record[LOGGER_RECORD_SIZE];
+
+    while (__atomic_load_n(&logger.head, __ATOMIC_ACQUIRE) != logger.tail) {
+        uint32_t tail = logger.tail;
+        for (size_t i = 0; i < LOGGER_HEADER_SIZE; ++i)
+            record[i] = logger.buffer[(tail + i) % LOGGER_BUFFER_SIZE];
+        uint16_t id = (uint16_t) (record[1] | (record[2] << 8));
+        uint32_t size = LOGGER_HEADER_SIZE + record[3] * 4U;
+        if (record[0] != LOGGER_SYNC_BYTE || record[3] != 1 || id >= TEST_WRITERS) {
+            if (broken++ == 0)
+                TEST_CHECK(false, "record %u: sync %02x, ID %u, %u arguments", (unsigned) received, record[0],
+                           (unsigned) id, record[3]);
+            __atomic_store_n(&logger.tail, __atomic_load_n(&logger.head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+            return;
+        }
+
+        for (size_t i = LOGGER_HEADER_SIZE; i < size; ++i)
+            record[i] = logger.buffer[(tail + i) % LOGGER_BUFFER_SIZE];
+        uint32_t value = 0;
+        memcpy(&value, record + LOGGER_HEADER_SIZE, sizeof(value));
+        if (value != nextValue[id] && broken++ == 0)
+            TEST_CHECK(false, "writer %u: value %u instead of %u", (unsigned) id, (unsigned) value,
+                       (unsigned) nextValue[id]);
+        nextValue[id] = value + 1;
+        received++;
+        __atomic_store_n(&logger.tail, tail + size, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief The single writer: the records of all sizes across the end of the buffer
+ */
+static void testWrap(void) {
+    uint32_t args[LOGGER_MAX_ARGS] = {0x11223344U, 0x55667788U, 0x99AABBCCU, 0xDDEEFF00U};
+    size_t wrong = 0;
+
+    resetLogger();
+    for (uint32_t i = 0; i < TEST_WRAPS; ++i) {
+        uint8_t numArgs = (uint8_t) (i % (LOGGER_MAX_ARGS + 1));
+        uint32_t tail = logger.tail;
+        TEST_CHECK(LoggerWrite(&logger, (uint16_t) i, args, numArgs), "wrap: record %u isn't saved", (unsigned) i);
+
+        uint8_t record[LOGGER_RECORD_SIZE];
+        uint32_t size = logger.head - tail;
+        for (size_t k = 0; k < size && k < sizeof(record); ++k)
+            record[k] = logger.buffer[(tail + k) % LOGGER_BUFFER_SIZE];
+        if ((size != LOGGER_HEADER_SIZE + numArgs * 4U || record[0] != LOGGER_SYNC_BYTE ||
+             record[1] != (uint8_t) i || record[2] != (uint8_t) (i >> 8) || record[3] != numArgs ||
+             memcmp(record + LOGGER_HEADER_SIZE, args, numArgs * 4U) != 0) && wrong++ == 0)
+            TEST_CHECK(false, "wrap: record %u, %u bytes at %u", (unsigned) i, (unsigned) size, (unsigned) tail);
+        logger.tail = logger.head;
+    }
+    TEST_CHECK(logger.writers == 0 && logger.reserved == logger.head, "wrap: %u writers, %u reserved, head %u",
+               (unsigned) logger.writers, (unsigned) logger.reserved, (unsigned) logger.head);
+}
+
+/**
+ * @brief The buffer is full: the record is lost and counted, the space is used again after the drain
+ */
+static void testFull(void) {
+    uint32_t args[LOGGER_MAX_ARGS] = {0};
+    uint32_t saved = 0;
+
+    resetLogger();
+    while (LoggerWrite(&logger, 0, args, LOGGER_MAX_ARGS))
+        saved++;
+    TEST_CHECK(saved == LOGGER_BUFFER_SIZE / LOGGER_RECORD_SIZE && logger.lost == 1, "full: %u saved, %u lost",
+               (unsigned) saved, (unsigned) logger.lost);
+    TEST_CHECK(logger.head == logger.reserved && logger.writers == 0, "full: the lost record is published");
+
+    logger.tail = logger.head;
+    TEST_CHECK(LoggerWrite(&logger, 0, args, LOGGER_MAX_ARGS) && logger.lost == 1, "full: the space isn't released");
+}
+
+/**
+ * @brief The writer is preempted during its copy: the records of the preempting writers aren't published before it
+ */
+static void testPreempted(void) {
+    uint32_t value = 0;
+
+    resetLogger();
+    // the preempted writer: counted, its space is reserved, the copy isn't finished
+    logger.writers = 1;
+    logger.reserved = LOGGER_HEADER_SIZE + 4;
+    TEST_CHECK(LoggerWrite(&logger, 1, &value, 1) && LoggerWrite(&logger, 2, &value, 1),
+               "preempted: the records aren't saved");
+    TEST_CHECK(logger.head == 0 && logger.reserved == 3 * (LOGGER_HEADER_SIZE + 4) && logger.writers == 1,
+               "preempted: head %u, reserved %u, %u writers", (unsigned) logger.head, (unsigned) logger.reserved,
+               (unsigned) logger.writers);
+
+    // it finishes, the next record publishes all of them
+    logger.writers = 0;
+    TEST_CHECK(LoggerWrite(&logger, 3, &value, 1) && logger.head == 4 * (LOGGER_HEADER_SIZE + 4),
+               "preempted: head %u after the copy", (unsigned) logger.head);
+}
+
+/**
+ * @brief The writer thread, it retries the lost records (after the reader has run)
+ * @param arg is the writer ID
+ * @return NULL
+ */
+static void *writer(void *arg) {
+    uint16_t id = (uint16_t) (uintptr_t) arg;
+    for (uint32_t value = 0; value < TEST_RECORDS; ) {
+        if (LoggerWrite(&logger, id, &value, 1))
+            value++;
+        else
+            sched_yield();
+    }
+    __atomic_add_fetch(&finished, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief The concurrent writers and the reader: every record comes complete, each writer's records in order
+ */
+static void testConcurrent(void) {
+    pthread_t threads[TEST_WRITERS];
+
+    resetLogger();
+    finished = 0;
+    for (uintptr_t i = 0; i < TEST_WRITERS; ++i)
+        pthread_create(&threads[i], NULL, writer, (void *) i);
+
+    uint32_t total = TEST_WRITERS * TEST_RECORDS;
+    while (__atomic_load_n(&finished, __ATOMIC_ACQUIRE) < TEST_WRITERS)
+        drain();
+    for (size_t i = 0; i < TEST_WRITERS; ++i)
+        pthread_join(threads[i], NULL);
+    drain();
+
+    TEST_CHECK(received == total && broken == 0, "concurrent: %u of %u records, %u broken, %u lost (retried)",
+               (unsigned) received, (unsigned) total, (unsigned) broken, (unsigned) logger.lost);
+    TEST_CHECK(logger.writers == 0 && logger.head == logger.reserved, "concurrent: %u writers, %u unpublished bytes",
+               (unsigned) logger.writers, (unsigned) (logger.reserved - logger.head));
+}
+
+int main(void) {
+    testWrap();
+    testFull();
+    testPreempted();
+    testConcurrent();
+    return testResult("test_logger");
+}
@@ -0,0 +1,330 @@
+#include <string.h>
+
+#include "SensorPoll.h"
+#include "host_test.h"
+
+enum SensorPollTest_Constants {
+    TEST_NUMBER_BUSES = 2,
+    TEST_NUMBER_DEVICES = 4,
+    TEST_RUN_MS = 1000,
+    TEST_MAX_PENDING = SENSOR_POLL_MAX_GROUPS,
+};
+
+/*
+ * The simulated devices: the register map of each one is filled with a pattern, the bus API (I2C_writeReadData
+ * and the request state) is replaced by the pending list, the test completes the reads at the end of the tick
+ * and passes the notification bits to SensorPollComplete, as the sensors task does.
+ */
+typedef struct {
+    uint8_t bus;
+    uint16_t address;
+    uint8_t registers[256];
+    bool isNack; // the read fails
+    bool isHeld; // the read isn't completed
+} TestDeviceDef;
+
+typedef struct {
+    I2CRequestDef *request;
+    TestDeviceDef *device;
+    uint8_t reg;
+} TestReadDef;
+
+static I2CBusDef buses[TEST_NUMBER_BUSES];
+static TestDeviceDef devices[TEST_NUMBER_DEVICES] = {
+    {.bus = 0, .address = 0x53},
+    {.bus = 0, .address = 0x60},
+    {.bus = 1, .address = 0x48},
+    {.bus = 1, .address = 0x49},
+};
+static TestReadDef pending[TEST_MAX_PENDING];
+static size_t numPending;
+static SensorPollDef poll;
+static TaskHandle_t task;
+
+/**
+ * @brief Decode the big-endian 16-bit register pair
+ * @param data is the first register
+ * @return the signed value
+ */
+static int32_t decodeWord(const uint8_t *data) {
+    return (int16_t) ((data[0] << 8) | data[1]);
+}
+
+/**
+ * @brief Decode the byte register
+ * @param data is the register
+ * @return the value
+ */
+static int32_t decodeByte(const uint8_t *data) {
+    return data[0];
+}
+
+/**
+ * @brief Decode the 10-register block as the sum of the registers
+ * @param data is the first register
+ * @return the sum
+ */
+static int32_t decodeSum(const uint8_t *data) {
+    int32_t sum = 0;
+    for (size_t i = 0; i < 10; ++i)
+        sum += data[i];
+    return sum;
+}
+
+/*
+ * Unsorted on purpose: the 0x53 entries of 20 ms are merged (0x38 ... 0x39 is the gap of 2 registers),
+ * 0x40 is too far, 0x00 has another rate, the 0x60 block exceeds the burst, the devices of the bus 1 aren't merged
+ */
+static const SensorPollEntryDef table[] = {
+    {1, 0x49, 0x00, 2, 100, decodeWord},
+    {0, 0x53, 0x36, 2, 20, decodeWord},
+    {0, 0x53, 0x32, 2, 20, decodeWord},
+    {0, 0x60, 0x0A, 10, 50, decodeSum},
+    {0, 0x53, 0x40, 1, 20, decodeByte},
+    {0, 0x53, 0x3A, 1, 20, decodeByte},
+    {0, 0x53, 0x00, 1, 100, decodeByte},
+    {1, 0x48, 0x00, 2, 100, decodeWord},
+    {0, 0x60, 0x00, 10, 50, decodeSum},
+    {0, 0x53, 0x34, 2, 20, decodeWord},
+};
+
+// the expected groups: the bus, the device, the first register, the burst size, the number of entries
+static const struct {
+    uint8_t bus;
+    uint16_t address;
+    uint8_t reg;
+    uint8_t size;
+    uint8_t count;
+} expectedGroups[] = {
+    {0, 0x53, 0x32, 9, 4},
+    {0, 0x53, 0x40, 1, 1},
+    {0, 0x53, 0x00, 1, 1},
+    {0, 0x60, 0x00, 10, 1},
+    {0, 0x60, 0x0A, 10, 1},
+    {1, 0x48, 0x00, 2, 1},
+    {1, 0x49, 0x00, 2, 1},
+};
+
+void I2C_setNotification(I2CRequestDef *request, TaskHandle_t taskToNotify, uint32_t notification) {
+    request->completion = I2C_COMPLETION_NOTIFY;
+    request->task = taskToNotify;
+    request->notification = notification;
+}
+
+bool I2C_isReading(const I2CRequestDef *request) {
+    return request->isReading;
+}
+
+int32_t I2C_getStatus(const I2CRequestDef *request) {
+    return request->status;
+}
+
+int32_t I2C_writeReadData(I2CBusDef *bus, I2CRequestDef *request, uint16_t addr, const void *src, size_t txSize,
+                          void *dst, size_t rxSize) {
+    TestDeviceDef *device = NULL;
+    for (size_t i = 0; i < TEST_NUMBER_DEVICES; ++i) {
+        if (&buses[devices[i].bus] == bus && devices[i].address == addr)
+            device = &devices[i];
+    }
+    if (device == NULL || txSize != 1 || rxSize == 0 || request->isReading || numPending == TEST_MAX_PENDING)
+        return I2C_WRONG_DATA;
+
+    request->trans.rxData = (uint8_t *) dst;
+    request->trans.rxSize = rxSize;
+    request->isReading = true;
+    pending[numPending++] = (TestReadDef) {request, device, *(const uint8_t *) src};
+    return I2C_SUCCESS;
+}
+
+/**
+ * @brief The task function of the notified task (the scheduler isn't started, it never runs)
+ * @param arg is the task argument
+ */
+static void sensorsTask(void *arg) {
+    (void) arg;
+    for (;;) {
+    }
+}
+
+/**
+ * @brief Fill the register maps: each register of each device holds its own value
+ * @param seed is changed to get the new values
+ */
+static void fillDevices(uint8_t seed) {
+    for (size_t i = 0; i < TEST_NUMBER_DEVICES; ++i) {
+        for (size_t reg = 0; reg < sizeof(devices[i].registers); ++reg)
+            devices[i].registers[reg] = (uint8_t) (devices[i].address + reg * 37 + seed);
+    }
+}
+
+/**
+ * @brief Complete the pending reads (the held ones stay pending) and pass the completion bits to the engine
+ */
+static void completeReads(void) {
+    uint32_t completed = 0;
+    size_t held = 0;
+
+    for (size_t i = 0; i < numPending; ++i) {
+        TestReadDef *read = &pending[i];
+        if (read->device->isHeld) {
+            pending[held++] = *read;
+            continue;
+        }
+
+        if (read->device->isNack) {
+            read->request->status = I2C_NACK;
+        } else {
+            memcpy(read->request->trans.rxData, &read->device->registers[read->reg], read->request->trans.rxSize);
+            read->request->status = I2C_SUCCESS;
+        }
+        read->request->isReading = false;
+        completed |= read->request->notification;
+    }
+    numPending = held;
+
+    if (completed)
+        SensorPollComplete(&poll, completed);
+}
+
+/**
+ * @brief Run the sensors task loop for the given time: start the due reads, complete them, next tick
+ * @param ms is the run time (ms)
+ */
+static void run(uint32_t ms) {
+    for (uint32_t tick = 0; tick < pdMS_TO_TICKS(ms); ++tick) {
+        SensorPollStart(&poll);
+        completeReads();
+        xTaskIncrementTick();
+    }
+}
+
+/**
+ * @brief Check the decoded values of all entries against the register maps
+ * @param name is the check name
+ */
+static void checkValues(const char *name) {
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+        const TestDeviceDef *device = NULL;
+        for (size_t k = 0; k < TEST_NUMBER_DEVICES; ++k) {
+            if (devices[k].bus == table[i].bus && devices[k].address == table[i].address)
+                device = &devices[k];
+        }
+
+        SensorValueDef value;
+        int32_t expected = table[i].decode(&device->registers[table[i].reg]);
+        TEST_CHECK(SensorPollGetValue(&poll, i, &value) && value.value == expected, "%s: entry %zu, %d instead of %d",
+                   name, i, (int) value.value, (int) expected);
+    }
+}
+
+/**
+ * @brief The table is sorted and merged into the burst reads
+ */
+static void testGroups(void) {
+    const size_t numGroups = sizeof(expectedGroups) / sizeof(expectedGroups[0]);
+
+    TEST_CHECK(SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, table, sizeof(table) / sizeof(table[0]), task) ==
+               SENSOR_POLL_SUCCESS, "init");
+    TEST_CHECK(poll.numGroups == numGroups, "%u groups instead of %zu", poll.numGroups, numGroups);
+
+    for (size_t i = 0; i < numGroups && i < poll.numGroups; ++i) {
+        const SensorPollGroupDef *group = &poll.groups[i];
+        TEST_CHECK(group->bus == &buses[expectedGroups[i].bus] && group->address == expectedGroups[i].address &&
+                   group->reg == expectedGroups[i].reg && group->size == expectedGroups[i].size &&
+                   group->count == expectedGroups[i].count, "group %zu: 0x%02x, register 0x%02x, %u bytes, %u entries",
+                   i, group->address, group->reg, group->size, group->count);
+    }
+}
+
+/**
+ * @brief One transaction per group and period, the decoded values follow the devices
+ */
+static void testPolling(void) {
+    uint32_t expectedReads = 0;
+    TickType_t start = xTaskGetTickCount();
+
+    fillDevices(0);
+    TEST_CHECK(SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, table, sizeof(table) / sizeof(table[0]), task) ==
+               SENSOR_POLL_SUCCESS, "polling: init");
+    for (uint8_t i = 0; i < poll.numGroups; ++i) {
+        TickType_t offset = poll.groups[i].nextTime - start;
+        TickType_t runTicks = pdMS_TO_TICKS(TEST_RUN_MS);
+        expectedReads += (uint32_t) ((runTicks - offset + poll.groups[i].period - 1) / poll.groups[i].period);
+    }
+
+    run(TEST_RUN_MS);
+    TEST_CHECK(poll.reads == expectedReads, "polling: %u reads instead of %u", (unsigned) poll.reads,
+               (unsigned) expectedReads);
+    checkValues("polling");
+
+    fillDevices(0x5A);
+    run(TEST_RUN_MS / 10);
+    checkValues("new values");
+}
+
+/**
+ * @brief The held read skips the periods of its group, the failed read keeps the previous value
+ */
+static void testPendingAndErrors(void) {
+    SensorValueDef before;
+    SensorValueDef after;
+
+    fillDevices(1);
+    SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, table, sizeof(table) / sizeof(table[0]), task);
+    run(TEST_RUN_MS / 10);
+
+    // 0x60 (50 ms): one read is started and held for 200 ms, the other groups go on
+    uint32_t reads = poll.reads;
+    devices[1].isHeld = true;
+    run(TEST_RUN_MS / 5);
+    devices[1].isHeld = false;
+    TEST_CHECK(poll.reads - reads == 2 + 10 * 2 + 2 + 2 + 2, "held: %u reads", (unsigned) (poll.reads - reads));
+
+    // 0x48 doesn't acknowledge: its group counts the errors, the value stays
+    SensorPollGetValue(&poll, 7, &before);
+    devices[2].isNack = true;
+    fillDevices(2);
+    run(TEST_RUN_MS / 5);
+    devices[2].isNack = false;
+    SensorPollGetValue(&poll, 7, &after);
+    TEST_CHECK(poll.groups[5].errors == 2 && after.value == before.value && after.timestamp == before.timestamp,
+               "NACK: %u errors, %d -> %d", (unsigned) poll.groups[5].errors, (int) before.value, (int) after.value);
+}
+
+/**
+ * @brief The wrong tables are refused
+ */
+static void testWrongData(void) {
+    static SensorPollEntryDef wrong[SENSOR_POLL_MAX_GROUPS + 1];
+
+    for (size_t i = 0; i < SENSOR_POLL_MAX_GROUPS + 1; ++i)
+        wrong[i] = (SensorPollEntryDef) {0, (uint16_t) (0x10 + i), 0x00, 1, 10, decodeByte};
+    TEST_CHECK(SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, wrong, SENSOR_POLL_MAX_GROUPS + 1, task) ==
+               SENSOR_POLL_WRONG_DATA, "too many groups");
+    TEST_CHECK(SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, wrong, SENSOR_POLL_MAX_GROUPS, task) ==
+               SENSOR_POLL_SUCCESS, "the maximum groups");
+
+    wrong[0].bus = TEST_NUMBER_BUSES;
+    TEST_CHECK(SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, wrong, 1, task) == SENSOR_POLL_WRONG_DATA, "bus");
+    wrong[0].bus = 0;
+    wrong[0].size = SENSOR_POLL_BURST_SIZE + 1;
+    TEST_CHECK(SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, wrong, 1, task) == SENSOR_POLL_WRONG_DATA, "size");
+    wrong[0].size = 1;
+    wrong[0].decode = NULL;
+    TEST_CHECK(SensorPollInit(&poll, buses, TEST_NUMBER_BUSES, wrong, 1, task) == SENSOR_POLL_WRONG_DATA, "decode");
+}
+
+int main(void) {
+    static StaticTask_t taskBuffer;
+    static StackType_t taskStack[configMINIMAL_STACK_SIZE];
+
+    // the task lists of the kernel are created with the first task, then the tick can be incremented
+    task = xTaskCreateStatic(sensorsTask, "Sensors", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, taskStack,
+                             &taskBuffer);
+
+    testGroups();
+    testPolling();
+    testPendingAndErrors();
+    testWrongData();
+    return testResult("test_sensor_poll");
+}
@@ -0,0 +1,216 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "SerialPacket.h"
+#include "utilities.h"
+#include "host_test.h"
+
+enum SerialPacketTest_Constants {
+    TEST_FRAMES_SIZE = 4 * (SERIAL_FRAME_SIZE + sizeof(size_t)),
+    TEST_COBS_SIZE = 700, // several maximum length groups (254 bytes without zero)
+    TEST_TRIALS = 200,
+};
+
+/*
+ * The serial port is replaced by the captured frame and the message buffer of the complete frames (the receive
+ * interrupt puts the frames there without the delimiters). The CRC module is replaced by the bitwise CRC-32/ISO-HDLC,
+ * the same as the host codec (tools/serialpacket.hpp) calculates.
+ */
+static SerialPortDef port;
+static int crcHandle;
+static uint8_t frames[TEST_FRAMES_SIZE];
+static StaticMessageBuffer_t framesBuffer;
+static uint8_t written[SERIAL_FRAME_SIZE + 2];
+static size_t writtenSize;
+
+uint32_t getCRC(void *handle, const void *data, uint16_t size) {
+    const uint8_t *bytes = (const uint8_t *) data;
+    uint32_t crc = 0xFFFFFFFFU;
+
+    if (handle == NULL || data == NULL || size == 0)
+        return 0;
+
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+void SerialEnableFraming(SerialPortDef *serialPort, void *crc) {
+    serialPort->crc = crc;
+    serialPort->rxFrames = xMessageBufferCreateStatic(sizeof(frames), frames, &framesBuffer);
+}
+
+int32_t SerialWriteData(SerialPortDef *serialPort, const void *src, size_t size) {
+    (void) serialPort;
+    if (size > sizeof(written))
+        return 0;
+
+    memcpy(written, src, size);
+    writtenSize = size;
+    return (int32_t) size;
+}
+
+/**
+ * @brief Deliver the frame to the receiver (without the delimiters, as the receive interrupt does)
+ * @param frame is the frame
+ * @param size is the frame size (bytes)
+ */
+static void receiveFrame(const uint8_t *frame, size_t size) {
+    TEST_CHECK(xMessageBufferSend(port.rxFrames, frame, size, 0) == size, "the frame isn't buffered");
+}
+
+/**
+ * @brief Send the payload, check the frame, receive it back
+ * @param payload is the packet payload
+ * @param size is the payload size (bytes)
+ */
+static void roundTrip(const uint8_t *payload, size_t size) {
+    uint8_t received[SERIAL_PACKET_SIZE];
+
+    writtenSize = 0;
+    TEST_CHECK(SerialWritePacket(&port, payload, size) == (int32_t) size, "write: size %zu", size);
+    TEST_CHECK(writtenSize >= size + SERIAL_PACKET_CRC_SIZE + 3 && written[0] == SERIAL_FRAME_DELIMITER &&
+               written[writtenSize - 1] == SERIAL_FRAME_DELIMITER, "write: size %zu, frame %zu bytes", size,
+               writtenSize);
+    TEST_CHECK(memchr(written + 1, SERIAL_FRAME_DELIMITER, writtenSize - 2) == NULL,
+               "write: size %zu, the delimiter inside the frame", size);
+
+    receiveFrame(written + 1, writtenSize - 2);
+    int32_t result = SerialReadPacket(&port, received, sizeof(received));
+    TEST_CHECK(result == (int32_t) size && memcmp(received, payload, size) == 0, "read: size %zu, result %d", size,
+               (int) result);
+}
+
+/**
+ * @brief The frame is the same as the host codec builds: COBS of the payload and CRC-32 (little-endian)
+ */
+static void testHostFrame(void) {
+    static const uint8_t payload[] = {0x11, 0x00, 0x00, 0x22, 0x33};
+    static const uint8_t frame[] = {0x00, 0x02, 0x11, 0x01, 0x07, 0x22, 0x33, 0x19, 0x6E, 0xC0, 0x83, 0x00};
+    uint8_t received[SERIAL_PACKET_SIZE];
+
+    static const char check[] = "123456789";
+    TEST_CHECK(getCRC(&crcHandle, check, 9) == 0xCBF43926U, "CRC-32/ISO-HDLC check value");
+
+    TEST_CHECK(SerialWritePacket(&port, payload, sizeof(payload)) == sizeof(payload), "host frame: write");
+    TEST_CHECK(writtenSize == sizeof(frame) && memcmp(written, frame, sizeof(frame)) == 0,
+               "host frame: %zu bytes differ", writtenSize);
+
+    receiveFrame(frame + 1, sizeof(frame) - 2);
+    TEST_CHECK(SerialReadPacket(&port, received, sizeof(received)) == sizeof(payload) &&
+               memcmp(received, payload, sizeof(payload)) == 0, "host frame: read");
+}
+
+/**
+ * @brief All payload sizes: zeros, no zeros, pseudo-random bytes
+ */
+static void testRoundTrip(void) {
+    uint8_t payload[SERIAL_PACKET_SIZE];
+
+    for (size_t size = 1; size <= SERIAL_PACKET_SIZE; ++size) {
+        memset(payload, 0, size);
+        roundTrip(payload, size);
+        memset(payload, 0xFF, size);
+        roundTrip(payload, size);
+    }
+
+    srand(1);
+    for (int trial = 0; trial < TEST_TRIALS; ++trial) {
+        size_t size = 1 + (size_t) rand() % SERIAL_PACKET_SIZE;
+        for (size_t i = 0; i < size; ++i)
+            payload[i] = (rand() % 4 == 0) ? 0 : (uint8_t) rand();
+        roundTrip(payload, size);
+    }
+}
+
+/**
+ * @brief COBS alone: the maximum length groups (254 bytes without zero) and the zeros around them
+ */
+static void testCobs(void) {
+    static uint8_t data[TEST_COBS_SIZE];
+    static uint8_t encoded[TEST_COBS_SIZE + TEST_COBS_SIZE / 254 + 1];
+    static uint8_t decoded[TEST_COBS_SIZE];
+    static const size_t sizes[] = {1, 253, 254, 255, 508, 509, TEST_COBS_SIZE};
+
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k) {
+        for (int zeros = 0; zeros < 2; ++zeros) {
+            for (size_t i = 0; i < sizes[k]; ++i)
+                data[i] = (zeros && (i == 0 || i % 300 == 299)) ? 0 : (uint8_t) (1 + i % 255);
+
+            size_t length = cobsEncode(data, sizes[k], encoded);
+            TEST_CHECK(length <= sizes[k] + sizes[k] / 254 + 1 && memchr(encoded, 0, length) == NULL,
+                       "COBS: size %zu, encoded %zu bytes", sizes[k], length);
+            int32_t result = cobsDecode(encoded, length, decoded, sizeof(decoded));
+            TEST_CHECK(result == (int32_t) sizes[k] && memcmp(decoded, data, sizes[k]) == 0,
+                       "COBS: size %zu, decoded %d bytes", sizes[k], (int) result);
+        }
+    }
+
+    // the decoded data doesn't fit the buffer
+    size_t length = cobsEncode(data, 100, encoded);
+    TEST_CHECK(cobsDecode(encoded, length, decoded, 99) == SERIAL_PACKET_BROKEN, "COBS: short buffer");
+}
+
+/**
+ * @brief Every single bit error of the frame is rejected and counted
+ */
+static void testBrokenFrames(void) {
+    static const uint8_t payload[] = {0x01, 0x00, 0x7F, 0x80, 0xFF, 0x00, 0x00, 0x42};
+    uint8_t frame[SERIAL_FRAME_SIZE + 2];
+    uint8_t received[SERIAL_PACKET_SIZE];
+
+    SerialWritePacket(&port, payload, sizeof(payload));
+    size_t size = writtenSize - 2;
+    memcpy(frame, written + 1, size);
+
+    for (size_t i = 0; i < size; ++i) {
+        for (int bit = 0; bit < 8; ++bit) {
+            uint32_t errors = port.errors;
+            frame[i] ^= (uint8_t) (1U << bit);
+            receiveFrame(frame, size);
+            int32_t result = SerialReadPacket(&port, received, sizeof(received));
+            TEST_CHECK(result == SERIAL_PACKET_BROKEN && port.errors == errors + 1, "byte %zu, bit %d: result %d", i,
+                       bit, (int) result);
+            frame[i] ^= (uint8_t) (1U << bit);
+        }
+    }
+
+    // the payload doesn't fit the destination buffer, the CRC alone isn't a packet
+    receiveFrame(frame, size);
+    TEST_CHECK(SerialReadPacket(&port, received, sizeof(payload) - 1) == SERIAL_PACKET_BROKEN, "short buffer");
+    static const uint8_t crcOnly[] = {0x05, 0x01, 0x02, 0x03, 0x04};
+    receiveFrame(crcOnly, sizeof(crcOnly));
+    TEST_CHECK(SerialReadPacket(&port, received, sizeof(received)) == SERIAL_PACKET_BROKEN, "no payload");
+}
+
+/**
+ * @brief The wrong arguments are refused, nothing is sent
+ */
+static void testWrongData(void) {
+    uint8_t payload[SERIAL_PACKET_SIZE + 1] = {0};
+    SerialPortDef stream = {0};
+
+    writtenSize = 0;
+    TEST_CHECK(SerialWritePacket(&port, payload, 0) == SERIAL_PACKET_WRONG_DATA, "write: size 0");
+    TEST_CHECK(SerialWritePacket(&port, payload, sizeof(payload)) == SERIAL_PACKET_WRONG_DATA, "write: too large");
+    TEST_CHECK(SerialWritePacket(&port, NULL, 1) == SERIAL_PACKET_WRONG_DATA, "write: NULL");
+    TEST_CHECK(SerialWritePacket(&stream, payload, 1) == SERIAL_PACKET_WRONG_DATA, "write: byte stream mode");
+    TEST_CHECK(SerialReadPacket(&port, NULL, 1) == SERIAL_PACKET_WRONG_DATA, "read: NULL");
+    TEST_CHECK(writtenSize == 0, "wrong data: %zu bytes are sent", writtenSize);
+}
+
+int main(void) {
+    static StaticSemaphore_t rxMutexBuffer;
+    port.rxMutex = xSemaphoreCreateMutexStatic(&rxMutexBuffer);
+    SerialPacketInit(&port, &crcHandle);
+
+    testHostFrame();
+    testRoundTrip();
+    testCobs();
+    testBrokenFrames();
+    testWrongData();
+    return testResult("test_serial_packet");
+}
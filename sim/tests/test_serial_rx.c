@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "SerialJob.h"
+#include "host_test.h"
+
+enum SerialRxTest_Constants {
+    TEST_STREAM_SIZE = 1024,
+    TEST_FRAMES_SIZE = 512,
+    TEST_HALF = SERIAL_PORT_BUFFER_SIZE / 2,
+    TEST_MAX_BURST = 3 * SERIAL_PORT_BUFFER_SIZE / 2, // a burst crosses HT and TC (and the wrap point) at once
+    TEST_TOTAL_SIZE = 50000,
+    TEST_TRIALS = 500,
+};
+
+/*
+ * The circular DMA of the receiver: the bytes are written at dmaPosition, HT and TC events are raised at the half
+ * and at the end of the buffer (then DMA wraps around), the IDLE event - after the burst. The HAL reports the IDLE
+ * event only inside the buffer (not at the position 0, there NDTR equals the buffer size).
+ */
+SERIAL_PORT_BUFFERS(buffers, TEST_STREAM_SIZE, 16, TEST_FRAMES_SIZE);
+static SerialPortDef port;
+static int crcHandle;
+static size_t dmaPosition;
+static uint32_t events[3]; // HT, TC, IDLE
+
+/**
+ * @brief Raise the reception event (HAL_UARTEx_RxEventCallback)
+ * @param position is the DMA position (HAL: the Size argument)
+ */
+static void event(uint16_t position) {
+    BaseType_t priorityTaskWoken = pdFALSE;
+    SerialReceiveFromISR(&port, position, &priorityTaskWoken);
+}
+
+/**
+ * @brief The line receives the burst: DMA writes it, HT/TC events on the way, IDLE at the end
+ * @param data is the burst
+ * @param size is the burst size (bytes)
+ */
+static void receiveBurst(const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        port.rxBuffer[dmaPosition++] = data[i];
+        if (dmaPosition == TEST_HALF) {
+            events[0]++;
+            event(TEST_HALF);
+        } else if (dmaPosition == SERIAL_PORT_BUFFER_SIZE) {
+            events[1]++;
+            event(SERIAL_PORT_BUFFER_SIZE);
+            dmaPosition = 0;
+        }
+    }
+    if (dmaPosition) {
+        events[2]++;
+        event((uint16_t) dmaPosition);
+    }
+}
+
+/**
+ * @brief Initialize the port: the byte stream or the packet mode, DMA at the start of the buffer
+ * @param isFraming is True - the packet mode, False - the byte stream
+ */
+static void initPort(bool isFraming) {
+    memset(&port, 0, sizeof(port));
+    port.buffers = &buffers;
+    port.rxStream = xStreamBufferCreateStatic(buffers.rxStreamSize, 1, buffers.rxStream, &port.rxStreamBuffer);
+    if (isFraming)
+        SerialEnableFraming(&port, &crcHandle);
+
+    dmaPosition = 0;
+    memset(events, 0, sizeof(events));
+}
+
+/**
+ * @brief The byte stream: random bursts across the wrap point, each byte arrives once and in order
+ */
+static void testStream(void) {
+    static uint8_t burst[TEST_MAX_BURST];
+    uint8_t received[TEST_STREAM_SIZE];
+    uint32_t sent = 0;
+    uint32_t checked = 0;
+    size_t wrong = 0;
+
+    initPort(false);
+    srand(1);
+    while (sent < TEST_TOTAL_SIZE) {
+        size_t size = 1 + (size_t) rand() % TEST_MAX_BURST;
+        for (size_t i = 0; i < size; ++i)
+            burst[i] = (uint8_t) ((sent + i) % 251);
+        receiveBurst(burst, size);
+        sent += (uint32_t) size;
+
+        size_t length = xStreamBufferReceive(port.rxStream, received, sizeof(received), 0);
+        for (size_t i = 0; i < length; ++i, ++checked) {
+            if (received[i] != (uint8_t) (checked % 251) && wrong++ == 0)
+                TEST_CHECK(false, "stream: byte %u is %02x", (unsigned) checked, received[i]);
+        }
+    }
+
+    TEST_CHECK(checked == sent && wrong == 0 && port.errors == 0, "stream: %u of %u bytes, %zu wrong, %u errors",
+               (unsigned) checked, (unsigned) sent, wrong, (unsigned) port.errors);
+    TEST_CHECK(events[0] && events[1] && events[2], "stream: HT %u, TC %u, IDLE %u events", (unsigned) events[0],
+               (unsigned) events[1], (unsigned) events[2]);
+}
+
+/**
+ * @brief The bursts end exactly at HT (IDLE repeats the position) and at TC (no IDLE), then the next burst wraps
+ */
+static void testEventBoundaries(void) {
+    static const size_t sizes[] = {TEST_HALF, TEST_HALF, 1, TEST_HALF - 1, TEST_HALF, SERIAL_PORT_BUFFER_SIZE, 5};
+    uint8_t burst[SERIAL_PORT_BUFFER_SIZE];
+    uint8_t received[TEST_STREAM_SIZE];
+    uint8_t value = 0;
+    size_t total = 0;
+
+    initPort(false);
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k) {
+        for (size_t i = 0; i < sizes[k]; ++i)
+            burst[i] = value++;
+        receiveBurst(burst, sizes[k]);
+        total += sizes[k];
+    }
+
+    size_t length = xStreamBufferReceive(port.rxStream, received, sizeof(received), 0);
+    size_t wrong = 0;
+    while (wrong < length && received[wrong] == (uint8_t) wrong)
+        wrong++;
+    TEST_CHECK(length == total && wrong == length, "boundaries: %zu of %zu bytes, the first wrong - %zu", length,
+               total, wrong);
+}
+
+/**
+ * @brief The packet mode: the frames across the wrap point are complete and in order
+ */
+static void testFrames(void) {
+    uint8_t burst[SERIAL_FRAME_SIZE + 1];
+    uint8_t frame[SERIAL_FRAME_SIZE];
+    size_t frames = 0;
+    size_t wrong = 0;
+
+    initPort(true);
+    for (int trial = 0; trial < TEST_TRIALS; ++trial) {
+        size_t size = 1 + (size_t) trial % SERIAL_FRAME_SIZE;
+        for (size_t i = 0; i < size; ++i)
+            burst[i] = (uint8_t) (1 + (trial + i) % 255);
+        burst[size] = SERIAL_FRAME_DELIMITER;
+        receiveBurst(burst, size + 1);
+
+        size_t length = xMessageBufferReceive(port.rxFrames, frame, sizeof(frame), 0);
+        if (length != size || memcmp(frame, burst, size) != 0) {
+            if (wrong++ == 0)
+                TEST_CHECK(false, "frames: trial %d, %zu of %zu bytes", trial, length, size);
+        }
+        frames++;
+    }
+    TEST_CHECK(wrong == 0 && port.errors == 0, "frames: %zu of %zu wrong, %u errors", wrong, frames,
+               (unsigned) port.errors);
+}
+
+/**
+ * @brief The input stream is full: the rest of the event is lost and counted, the next data continue
+ */
+static void testOverflow(void) {
+    uint8_t burst[TEST_HALF];
+    uint8_t received[TEST_STREAM_SIZE];
+
+    initPort(false);
+    memset(burst, 0x5A, sizeof(burst));
+    while (xStreamBufferSpacesAvailable(port.rxStream) >= sizeof(burst))
+        receiveBurst(burst, sizeof(burst));
+    TEST_CHECK(port.errors == 0, "overflow: %u errors before the stream is full", (unsigned) port.errors);
+
+    receiveBurst(burst, sizeof(burst));
+    TEST_CHECK(port.errors == 1, "overflow: %u errors", (unsigned) port.errors);
+
+    xStreamBufferReceive(port.rxStream, received, sizeof(received), 0);
+    burst[0] = 0xA5;
+    receiveBurst(burst, 1);
+    TEST_CHECK(xStreamBufferReceive(port.rxStream, received, sizeof(received), 0) == 1 && received[0] == 0xA5,
+               "overflow: the next byte isn't received");
+}
+
+int main(void) {
+    testStream();
+    testEventBoundaries();
+    testFrames();
+    testOverflow();
+    return testResult("test_serial_rx");
+}
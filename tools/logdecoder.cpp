@@ -0,0 +1,178 @@
+// Host decoder of the binary logger records (LoggerJob), it restores the text lines using the firmware ELF file.
+// Build: g++ -std=c++17 -O2 -o logdecoder tools/logdecoder.cpp
+// Usage: logdecoder <firmware.elf> [<serial device or dump file>] (default input - stdin),
+// the host simulation executable (build-sim) is decoded the same way
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint8_t SYNC_BYTE = 0xA5; // LOGGER_SYNC_BYTE
+constexpr size_t HEADER_SIZE = 4; // LOGGER_HEADER_SIZE
+constexpr size_t MAX_ARGS = 4; // LOGGER_MAX_ARGS
+
+template<typename T>
+T readValue(const std::vector<uint8_t> &data, size_t offset) {
+    T value{};
+    if (offset + sizeof(T) <= data.size())
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Extract the ".logstr" section from the ELF file (little-endian): ELF32 - the firmware, ELF64 - the host
+ * simulation (the LOG ID is the offset inside the section in both)
+ * @param path is the firmware ELF file
+ * @param section is the section content
+ * @return True - the section has been found, otherwise - False
+ */
+bool readLogSection(const std::string &path, std::vector<uint8_t> &section) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> elf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (elf.size() < 64 || std::memcmp(elf.data(), "\x7F" "ELF", 4) != 0 || (elf[4] != 1 && elf[4] != 2))
+        return false;
+
+    // the file header and the section header fields, which differ between ELF32 and ELF64
+    const bool is64 = (elf[4] == 2);
+    const auto readAddress = [&elf, is64](size_t offset) -> size_t {
+        return is64 ? readValue<uint64_t>(elf, offset) : readValue<uint32_t>(elf, offset);
+    };
+    const size_t shOffset = readAddress(is64 ? 40 : 32);
+    const size_t fields = is64 ? 58 : 46; // e_shentsize, e_shnum, e_shstrndx
+    const size_t sectionOffset = is64 ? 24 : 16; // sh_offset, then sh_size
+    const size_t sectionSize = is64 ? 32 : 20;
+
+    const auto shSize = readValue<uint16_t>(elf, fields);
+    const auto shNumber = readValue<uint16_t>(elf, fields + 2);
+    const auto shNames = readValue<uint16_t>(elf, fields + 4);
+    const size_t namesOffset = readAddress(shOffset + shNames * shSize + sectionOffset);
+
+    for (uint16_t i = 0; i < shNumber; ++i) {
+        const size_t header = shOffset + i * shSize;
+        const size_t nameOffset = namesOffset + readValue<uint32_t>(elf, header);
+        if (nameOffset >= elf.size() || std::strcmp(reinterpret_cast<const char *>(&elf[nameOffset]), ".logstr") != 0)
+            continue;
+
+        const size_t offset = readAddress(header + sectionOffset);
+        const size_t size = readAddress(header + sectionSize);
+        if (offset > elf.size() || size > elf.size() - offset)
+            return false;
+
+        section.assign(elf.begin() + static_cast<std::ptrdiff_t>(offset),
+                       elf.begin() + static_cast<std::ptrdiff_t>(offset + size));
+        section.push_back('\0');
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Format the record: each conversion takes the next 32-bit argument, %d and %i - as int32_t, the others as
+ * uint32_t (the length modifiers are dropped, the firmware sends 32-bit values only)
+ * @param format is the format string
+ * @param args is the record arguments
+ * @param numArgs is the number of arguments
+ * @return the text line
+ */
+std::string formatRecord(const char *format, const uint32_t *args, size_t numArgs) {
+    std::string line;
+    size_t index = 0;
+    char text[64];
+
+    while (*format) {
+        if (*format != '%') {
+            line += *format++;
+            continue;
+        }
+
+        std::string spec(1, *format++);
+        while (*format && std::strchr("-+ #0123456789.", *format))
+            spec += *format++;
+        while (*format && std::strchr("hljztL", *format))
+            ++format;
+        const char conversion = *format;
+        if (conversion == '\0')
+            break;
+        ++format;
+        if (conversion == '%') {
+            line += '%';
+            continue;
+        }
+
+        spec += conversion;
+        const uint32_t value = (index < numArgs) ? args[index] : 0;
+        ++index;
+        if (conversion == 'd' || conversion == 'i')
+            std::snprintf(text, sizeof(text), spec.c_str(), static_cast<int32_t>(value));
+        else if (std::strchr("uxXoc", conversion))
+            std::snprintf(text, sizeof(text), spec.c_str(), value);
+        else
+            std::snprintf(text, sizeof(text), "[%%%c isn't supported]", conversion);
+        line += text;
+    }
+    return line;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <firmware.elf> [<input>]\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> formats;
+    if (!readLogSection(argv[1], formats)) {
+        std::cerr << "The \".logstr\" section isn't found in " << argv[1] << '\n';
+        return 1;
+    }
+
+    std::ifstream file;
+    if (argc > 2)
+        file.open(argv[2], std::ios::binary);
+    std::istream &input = (argc > 2) ? file : std::cin;
+
+    std::vector<uint8_t> record;
+    int value = 0;
+    while ((value = input.get()) != EOF) {
+        const auto byte = static_cast<uint8_t>(value);
+        if (record.empty() && byte != SYNC_BYTE) {
+            // not a log record (plain text from the other jobs)
+            std::cout.put(static_cast<char>(byte));
+            continue;
+        }
+
+        record.push_back(byte);
+        if (record.size() < HEADER_SIZE)
+            continue;
+
+        const size_t numArgs = record[3];
+        if (numArgs > MAX_ARGS) {
+            // lost synchronization, print the data as is
+            std::cout.write(reinterpret_cast<const char *>(record.data()), static_cast<std::streamsize>(record.size()));
+            record.clear();
+            continue;
+        }
+        if (record.size() < HEADER_SIZE + numArgs * 4)
+            continue;
+
+        const size_t id = record[1] | (record[2] << 8);
+        uint32_t args[MAX_ARGS] = {0};
+        std::memcpy(args, record.data() + HEADER_SIZE, numArgs * 4);
+        if (id < formats.size()) {
+            std::cout << formatRecord(reinterpret_cast<const char *>(&formats[id]), args, numArgs);
+        } else {
+            std::cout << "[unknown log ID " << id << "]\n";
+        }
+        std::cout.flush();
+        record.clear();
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Host codec of the Serial Port packets (SerialPacket): COBS frames separated by zero bytes,
+// the payload is followed by CRC-32/ISO-HDLC (little-endian), as calculated by the MCU CRC module.
+
+#ifndef SERIALPACKET_HPP
+#define SERIALPACKET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace serialpacket {
+
+constexpr uint8_t FRAME_DELIMITER = 0x00;
+constexpr size_t MAX_PAYLOAD_SIZE = 64; // SERIAL_PACKET_SIZE
+constexpr size_t CRC_SIZE = 4;
+
+inline uint32_t crc32(const uint8_t *data, size_t size) {
+    uint32_t crc = 0xFFFFFFFFU;
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+inline std::vector<uint8_t> cobsEncode(const std::vector<uint8_t> &src) {
+    std::vector<uint8_t> dst(1);
+    size_t code = 0;
+    uint8_t distance = 1;
+
+    for (uint8_t byte: src) {
+        if (byte == FRAME_DELIMITER) {
+            dst[code] = distance;
+            code = dst.size();
+            dst.push_back(0);
+            distance = 1;
+        } else {
+            dst.push_back(byte);
+            if (++distance == 0xFF) {
+                dst[code] = distance;
+                code = dst.size();
+                dst.push_back(0);
+                distance = 1;
+            }
+        }
+    }
+
+    dst[code] = distance;
+    return dst;
+}
+
+inline std::optional<std::vector<uint8_t>> cobsDecode(const std::vector<uint8_t> &src) {
+    std::vector<uint8_t> dst;
+    size_t i = 0;
+
+    while (i < src.size()) {
+        const uint8_t distance = src[i++];
+        if (distance == FRAME_DELIMITER || i + distance - 1 > src.size())
+            return std::nullopt;
+
+        dst.insert(dst.end(), src.begin() + static_cast<std::ptrdiff_t>(i),
+                   src.begin() + static_cast<std::ptrdiff_t>(i + distance - 1));
+        i += distance - 1U;
+        if (distance != 0xFF && i < src.size())
+            dst.push_back(0);
+    }
+    return dst;
+}
+
+/**
+ * @brief Build the complete frame (with leading and trailing delimiters) of the payload
+ */
+inline std::vector<uint8_t> encodePacket(const std::vector<uint8_t> &payload) {
+    std::vector<uint8_t> packet(payload);
+    const uint32_t crc = crc32(payload.data(), payload.size());
+    for (size_t i = 0; i < CRC_SIZE; ++i)
+        packet.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+
+    std::vector<uint8_t> frame{FRAME_DELIMITER};
+    const auto encoded = cobsEncode(packet);
+    frame.insert(frame.end(), encoded.begin(), encoded.end());
+    frame.push_back(FRAME_DELIMITER);
+    return frame;
+}
+
+/**
+ * @brief Restore the payload of the frame (without delimiters), std::nullopt - the frame is broken
+ */
+inline std::optional<std::vector<uint8_t>> decodePacket(const std::vector<uint8_t> &frame) {
+    auto packet = cobsDecode(frame);
+    if (!packet || packet->size() <= CRC_SIZE)
+        return std::nullopt;
+
+    const size_t size = packet->size() - CRC_SIZE;
+    uint32_t crc = 0;
+    for (size_t i = 0; i < CRC_SIZE; ++i)
+        crc |= static_cast<uint32_t>((*packet)[size + i]) << (8 * i);
+    if (crc != crc32(packet->data(), size))
+        return std::nullopt;
+
+    packet->resize(size);
+    return packet;
+}
+
+/**
+ * @brief Byte stream splitter, it returns the payloads of the complete and valid frames
+ */
+class Decoder {
+public:
+    std::vector<std::vector<uint8_t>> push(const uint8_t *data, size_t size) {
+        std::vector<std::vector<uint8_t>> packets;
+        for (size_t i = 0; i < size; ++i) {
+            if (data[i] != FRAME_DELIMITER) {
+                frame.push_back(data[i]);
+                continue;
+            }
+            if (!frame.empty()) {
+                if (auto packet = decodePacket(frame))
+                    packets.push_back(std::move(*packet));
+                else
+                    ++broken;
+                frame.clear();
+            }
+        }
+        return packets;
+    }
+
+    size_t brokenFrames() const { return broken; }
+
+private:
+    std::vector<uint8_t> frame;
+    size_t broken = 0;
+};
+
+} // namespace serialpacket
+
+#endif //SERIALPACKET_HPP